@@ -8,12 +8,15 @@
 
 #include "LogRancInventorySystem.h"
 #include "Algo/AnyOf.h"
+#include "Algo/StableSort.h"
 #include "Data/RecipeData.h"
 #include "Core/RISFunctions.h"
 #include "Core/RISSubsystem.h"
 #include "Data/UsableItemDefinition.h"
 #include "Net/UnrealNetwork.h"
 #include "Net/Core/PushModel/PushModel.h"
+#include "TimerManager.h"
+#include "Engine/World.h"
 
 
 UInventoryComponent::UInventoryComponent(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer),
@@ -482,6 +485,7 @@ int32 UInventoryComponent::AddItemToTaggedSlot_IfServer(TScriptInterface<IItemSo
 	UpdateWeightAndSlots();
 
 	OnItemAddedToTaggedSlot.Broadcast(SlotTag, ItemData, ActualAddedToContainer, AddedInstances, PreviousItem, EItemChangeReason::Added);
+	MARK_PROPERTY_DIRTY_FROM_NAME(UItemContainerComponent, ItemsVer, this);
 	MARK_PROPERTY_DIRTY_FROM_NAME(UInventoryComponent, TaggedSlotItems, this);
 
 	return ActualAddedToContainer;
@@ -629,7 +633,10 @@ int32 UInventoryComponent::AddItemToAnySlot(TScriptInterface<IItemSource> ItemSo
 	}
 
 	if (!SuppressUpdate)
+	{
 		UpdateWeightAndSlots();
+		MARK_PROPERTY_DIRTY_FROM_NAME(UItemContainerComponent, ItemsVer, this);
+	}
 
 	// Return the total quantity successfully added to the component initially
 	return ActualAddedToContainer;
@@ -814,7 +821,7 @@ void UInventoryComponent::MoveItem_Server_Implementation(const FGameplayTag& Ite
 }
 
 int32 UInventoryComponent::MoveItem_ServerImpl(const FGameplayTag& ItemId, int32 RequestedQuantity,
-                                               TArray<UItemInstanceData*> InstancesToMove,
+                                               const TArray<UItemInstanceData*>& InstancesToMove,
                                                const FGameplayTag& SourceTaggedSlot,
                                                const FGameplayTag& TargetTaggedSlot, bool AllowAutomaticSwapping,
                                                const FGameplayTag& SwapItemId, int32 SwapQuantity,
@@ -823,6 +830,19 @@ int32 UInventoryComponent::MoveItem_ServerImpl(const FGameplayTag& ItemId, int32
                                                bool SimulateMoveOnly)
 {
 	if (IsClient("MoveItemsToTaggedSlot_ServerImpl called on non-authority!")) return 0;
+
+	// The move rewrites the instance arrays of the bundles, a caller passing one of them gets it copied first
+	if (!InstancesToMove.IsEmpty())
+	{
+		bool InstancesAreAliased = TaggedSlotItems.ContainsByPredicate([&InstancesToMove](const FTaggedItemBundle& Item) { return &Item.InstanceData == &InstancesToMove; });
+		InstancesAreAliased |= ItemsVer.Items.ContainsByPredicate([&InstancesToMove](const FItemBundle& Item) { return &Item.InstanceData == &InstancesToMove; });
+		if (InstancesAreAliased)
+		{
+			const TArray<UItemInstanceData*> InstancesCopy = InstancesToMove;
+			return MoveItem_ServerImpl(ItemId, RequestedQuantity, InstancesCopy, SourceTaggedSlot, TargetTaggedSlot, AllowAutomaticSwapping,
+			                           SwapItemId, SwapQuantity, SuppressEvents, SuppressUpdate, SimulateMoveOnly);
+		}
+	}
 		
 	const bool SourceIsTaggedSlot = SourceTaggedSlot.IsValid(); // Keep for logic flow
 	const bool TargetIsTaggedSlot = TargetTaggedSlot.IsValid(); // Keep for logic flow
@@ -949,7 +969,6 @@ int32 UInventoryComponent::MoveItem_ServerImpl(const FGameplayTag& ItemId, int32
 	int32 SourceQuantity = SourceItem.GetQuantity();     // Capture pre-move state for events
 	const FGameplayTag& SourceItemId = SourceItem.GetItemId(); // Capture pre-move state for events
 	const FGameplayTag& TargetItemId = TargetItem.GetItemId(); // Capture pre-move state for events
-    TArray<UItemInstanceData*> TargetInstancesBeforeMove = *TargetItem.GetInstances(); // Capture pre-move state
 
     // SimulateMoveOnly already handled by the validation block replacement
 
@@ -958,12 +977,17 @@ int32 UInventoryComponent::MoveItem_ServerImpl(const FGameplayTag& ItemId, int32
 
 	if (SourceIsTaggedSlot && TargetIsTaggedSlot)
 	{
-		const FRISMoveResult MoveResult = URISFunctions::MoveBetweenSlots(
-			SourceItem, TargetItem, false, RequestedQuantity, InstancesToMove, true);
-
-		MovedQuantity = MoveResult.QuantityMoved;
+		bool WereItemsSwapped = false;
+		TArrayView<UItemInstanceData* const> MovedInstancesView;
+		MovedQuantity = URISFunctions::MoveBetweenSlots(
+			SourceItem, TargetItem, false, RequestedQuantity, InstancesToMove, true, true, WereItemsSwapped, MovedInstancesView);
 		if (MovedQuantity <= 0)
 			return 0;
+
+		// Only copied for listeners so moves without events stay allocation free
+		TArray<UItemInstanceData*> MovedInstances;
+		if (!SuppressEvents)
+			MovedInstances.Append(MovedInstancesView.GetData(), MovedInstancesView.Num());
 		
 		// Note SourceItem and TargetItem are now swapped in content for this code block
 
@@ -974,9 +998,9 @@ int32 UInventoryComponent::MoveItem_ServerImpl(const FGameplayTag& ItemId, int32
 		UpdateBlockingState(TargetTaggedSlot, SourceItemData, true);
 		if (!SuppressEvents)
 		{
-			OnItemRemovedFromTaggedSlot.Broadcast(SourceTaggedSlot, SourceItemData, MovedQuantity, MoveResult.InstancesMoved,
+			OnItemRemovedFromTaggedSlot.Broadcast(SourceTaggedSlot, SourceItemData, MovedQuantity, MovedInstances,
 			                                      EItemChangeReason::Moved);
-			if (MoveResult.WereItemsSwapped && IsValid(TargetItemData)) // might be null if swapping to empty slot
+			if (WereItemsSwapped && IsValid(TargetItemData)) // might be null if swapping to empty slot
 			{
 				OnItemRemovedFromTaggedSlot.Broadcast(TargetTaggedSlot, TargetItemData, SourceItem.GetQuantity(), *SourceItem.GetInstances(),
 				                                      EItemChangeReason::Moved);
@@ -985,7 +1009,7 @@ int32 UInventoryComponent::MoveItem_ServerImpl(const FGameplayTag& ItemId, int32
 				                                  SourceQuantity),
 				                                  EItemChangeReason::Moved);
 			}
-			OnItemAddedToTaggedSlot.Broadcast(TargetTaggedSlot, SourceItemData, MovedQuantity, MoveResult.InstancesMoved,
+			OnItemAddedToTaggedSlot.Broadcast(TargetTaggedSlot, SourceItemData, MovedQuantity, MovedInstances,
 			                                  FTaggedItemBundle(TargetTaggedSlot, TargetItemId,
 			                                  TargetQuantity), EItemChangeReason::Moved);
 		}
@@ -1138,6 +1162,23 @@ void UInventoryComponent::MoveBetweenContainers_ServerImpl(UItemContainerCompone
 												           const FGameplayTag& TargetTaggedSlot)
 {
     if (!TargetComponent || !IsValid(TargetComponent) || Quantity <= 0 || !ItemId.IsValid()) return;
+
+    // Generic to generic moves go straight from container to container
+    if (!SourceTaggedSlot.IsValid() && !TargetTaggedSlot.IsValid())
+    {
+        const FItemBundle* SourceBundle = SourceComponent->FindItemInstance(ItemId);
+        if (!SourceBundle) return;
+
+        if (SourceComponent->GetGridItemQuantity(*SourceBundle) == SourceBundle->Quantity)
+        {
+            const TArray<UItemInstanceData*> InstancesToMove = SourceBundle->FromInstanceIds(InstanceIdsToMove);
+            if (InstancesToMove.Num() != InstanceIdsToMove.Num()) return;
+            if (InstancesToMove.IsEmpty() && SourceBundle->Quantity < Quantity) return;
+
+            SourceComponent->TransferItemTo_ServerImpl(TargetComponent, ItemId, Quantity, InstancesToMove);
+            return;
+        }
+    }
 	
     FGenericItemBundle SourceBundleWrapper;
     FTaggedItemBundle* FoundTaggedBundlePtr = nullptr;
@@ -1583,6 +1624,17 @@ TArray<FTaggedItemBundle> UInventoryComponent::GetAllTaggedItems() const
 	return TaggedSlotItems;
 }
 
+uint64 UInventoryComponent::GetTaggedItemsChecksum() const
+{
+	uint64 Checksum = 0;
+	for (const FTaggedItemBundle& TaggedItem : TaggedSlotItems)
+	{
+		if (TaggedItem.IsValid())
+			Checksum += FRISItemChecksum::TaggedContribution(TaggedItem.Tag, TaggedItem.ItemId, TaggedItem.Quantity, TaggedItem.InstanceData.Num());
+	}
+	return Checksum;
+}
+
 void UInventoryComponent::DetectAndPublishContainerChanges()
 {
 	// First pass: Update existing items or add new ones, mark them by setting quantity to negative.
@@ -1928,9 +1980,7 @@ void UInventoryComponent::OnRep_Slots()
 
 bool UInventoryComponent::CanCraftRecipeId(const FPrimaryRISRecipeId& RecipeId) const
 {
-	const UObjectRecipeData* Recipe = Cast<UObjectRecipeData>(
-		UAssetManager::GetIfInitialized()->GetPrimaryAssetObject(RecipeId));
-	return CanCraftRecipe(Recipe);
+	return CanCraftRecipe(URISSubsystem::GetRecipeDataById(RecipeId));
 }
 
 bool UInventoryComponent::CanCraftRecipe(const UObjectRecipeData* Recipe) const
@@ -1949,66 +1999,536 @@ bool UInventoryComponent::CanCraftRecipe(const UObjectRecipeData* Recipe) const
 
 bool UInventoryComponent::CanCraftCraftingRecipe(const FPrimaryRISRecipeId& RecipeId) const
 {
-	UItemRecipeData* CraftingRecipe = Cast<UItemRecipeData>(
-		UAssetManager::GetIfInitialized()->GetPrimaryAssetObject(RecipeId));
+	const UItemRecipeData* CraftingRecipe = Cast<UItemRecipeData>(URISSubsystem::GetRecipeDataById(RecipeId));
 	return CanCraftRecipe(CraftingRecipe);
 }
 
 void UInventoryComponent::CraftRecipeId_Server_Implementation(const FPrimaryRISRecipeId& RecipeId)
 {
-	const UObjectRecipeData* Recipe = Cast<UObjectRecipeData>(
-		UAssetManager::GetIfInitialized()->GetPrimaryAssetObject(RecipeId));
-	CraftRecipe_IfServer(Recipe);
+	CraftRecipe_IfServer(URISSubsystem::GetRecipeDataById(RecipeId));
 }
 
 bool UInventoryComponent::CraftRecipe_IfServer(const UObjectRecipeData* Recipe)
 {
 	if (IsClient("CraftRecipe_IfServer")) return false;
 
-	bool bSuccess = false;
-	if (Recipe && CanCraftRecipe(Recipe))
+	return CraftRecipeQuantity_IfServer(Recipe, 1, false) == 1;
+}
+
+void UInventoryComponent::GatherRecipeRequirements(const UObjectRecipeData* Recipe, FRISRecipeRequirements& OutRequirements)
+{
+	// Sum components that share an ItemId so e.g. two rock components of 2 need 4 rocks per craft
+	OutRequirements.Reset();
+	for (const FItemBundle& Component : Recipe->Components)
+	{
+		auto* Existing = OutRequirements.FindByPredicate([&Component](const TPair<FGameplayTag, int32>& Entry)
+		{
+			return Entry.Key == Component.ItemId;
+		});
+		if (Existing) Existing->Value += Component.Quantity;
+		else OutRequirements.Emplace(Component.ItemId, Component.Quantity);
+	}
+}
+
+int32 UInventoryComponent::GetMaxCraftableCount(const UObjectRecipeData* Recipe) const
+{
+	if (!Recipe) return 0;
+
+	FRISRecipeRequirements Requirements;
+	GatherRecipeRequirements(Recipe, Requirements);
+
+	int32 MaxCount = MAX_int32;
+	for (const TPair<FGameplayTag, int32>& Required : Requirements)
+	{
+		const int32 QuantityContained = GetQuantityTotal_Implementation(Required.Key);
+		if (QuantityContained <= 0) return 0; // Like Contains(), a missing item is never satisfied
+		if (Required.Value <= 0) continue;
+		MaxCount = FMath::Min(MaxCount, QuantityContained / Required.Value);
+	}
+	return MaxCount;
+}
+
+int32 UInventoryComponent::GetMaxCraftableCountFromSources(const UObjectRecipeData* Recipe, const TArray<TScriptInterface<IItemSource>>& ExtraSources) const
+{
+	if (!Recipe) return 0;
+
+	FRISRecipeRequirements Requirements;
+	GatherRecipeRequirements(Recipe, Requirements);
+
+	TArray<UObject*, TInlineAllocator<16>> Sources;
+	TArray<int32> Available;
+	return GatherCraftingSources(Requirements, ExtraSources, ECraftingSourceOrder::OwnInventoryFirst, Sources, Available);
+}
+
+int32 UInventoryComponent::GatherCraftingSources(const FRISRecipeRequirements& Requirements, const TArray<TScriptInterface<IItemSource>>& ExtraSources,
+                                                 ECraftingSourceOrder SourceOrder, TArray<UObject*, TInlineAllocator<16>>& OutSources, TArray<int32>& OutAvailable) const
+{
+	UObject* Self = const_cast<UInventoryComponent*>(this);
+	OutSources.Reset();
+	if (SourceOrder != ECraftingSourceOrder::ExternalSourcesFirst)
+		OutSources.Add(Self);
+	for (const TScriptInterface<IItemSource>& Source : ExtraSources)
 	{
-		for (const auto& Component : Recipe->Components)
+		UObject* SourceObject = Source.GetObject();
+		if (SourceObject && SourceObject != Self)
+			OutSources.AddUnique(SourceObject);
+	}
+	if (SourceOrder == ECraftingSourceOrder::ExternalSourcesFirst)
+		OutSources.Add(Self);
+
+	const int32 NumRequirements = Requirements.Num();
+	OutAvailable.SetNumZeroed(OutSources.Num() * NumRequirements);
+	TArray<int64, TInlineAllocator<8>> Totals;
+	Totals.SetNumZeroed(NumRequirements);
+
+	for (int32 SourceIndex = 0; SourceIndex < OutSources.Num(); ++SourceIndex)
+	{
+		int32* SourceAvailable = OutAvailable.GetData() + SourceIndex * NumRequirements;
+		if (const UItemContainerComponent* Container = Cast<UItemContainerComponent>(OutSources[SourceIndex]))
 		{
-			const int32 Removed = DestroyItem_IfServer(Component.ItemId, Component.Quantity, NoInstances,
-			                                           EItemChangeReason::Transformed);
-			if (Removed < Component.Quantity)
+			// One pass over the container instead of a lookup per component, tagged slot items are part of Items too
+			for (const FItemBundle& Item : Container->ItemsVer.Items)
 			{
-				UE_LOG(LogRancInventorySystem, Error, TEXT("Failed to remove all items for crafting even though they were confirmed"));
-				return false;
+				for (int32 RequirementIndex = 0; RequirementIndex < NumRequirements; ++RequirementIndex)
+				{
+					if (Requirements[RequirementIndex].Key == Item.ItemId)
+					{
+						SourceAvailable[RequirementIndex] += Item.Quantity;
+						break;
+					}
+				}
+			}
+		}
+		else
+		{
+			for (int32 RequirementIndex = 0; RequirementIndex < NumRequirements; ++RequirementIndex)
+			{
+				SourceAvailable[RequirementIndex] = IItemSource::Execute_GetQuantityTotal(OutSources[SourceIndex], Requirements[RequirementIndex].Key);
 			}
 		}
-		bSuccess = true;
 
-		if (const UItemRecipeData* ItemRecipe = Cast<UItemRecipeData>(Recipe))
+		for (int32 RequirementIndex = 0; RequirementIndex < NumRequirements; ++RequirementIndex)
+		{
+			Totals[RequirementIndex] += FMath::Max(SourceAvailable[RequirementIndex], 0);
+		}
+	}
+
+	int64 MaxCount = MAX_int32;
+	for (int32 RequirementIndex = 0; RequirementIndex < NumRequirements; ++RequirementIndex)
+	{
+		if (Totals[RequirementIndex] <= 0) return 0; // Like Contains(), a missing item is never satisfied
+		if (Requirements[RequirementIndex].Value <= 0) continue;
+		MaxCount = FMath::Min(MaxCount, Totals[RequirementIndex] / Requirements[RequirementIndex].Value);
+	}
+	return static_cast<int32>(MaxCount);
+}
+
+int32 UInventoryComponent::CraftRecipeFromSources_IfServer(const UObjectRecipeData* Recipe, int32 Count, const TArray<TScriptInterface<IItemSource>>& ExtraSources,
+                                                          ECraftingSourceOrder SourceOrder, bool AllowPartial)
+{
+	if (IsClient("CraftRecipeFromSources_IfServer")) return 0;
+	if (!Recipe || Count <= 0) return 0;
+
+	FRISRecipeRequirements Requirements;
+	GatherRecipeRequirements(Recipe, Requirements);
+
+	TArray<UObject*, TInlineAllocator<16>> Sources;
+	TArray<int32> Available;
+	const int32 CraftCount = FMath::Min(Count, GatherCraftingSources(Requirements, ExtraSources, SourceOrder, Sources, Available));
+	if (CraftCount <= 0 || (!AllowPartial && CraftCount < Count))
+		return 0;
+
+	const int32 NumRequirements = Requirements.Num();
+	TArray<int32, TInlineAllocator<16>> SourceOrderForRequirement;
+	TArray<UItemContainerComponent*, TInlineAllocator<16>> TouchedContainers;
+	for (int32 RequirementIndex = 0; RequirementIndex < NumRequirements; ++RequirementIndex)
+	{
+		const FGameplayTag& ItemId = Requirements[RequirementIndex].Key;
+		int64 Remaining = static_cast<int64>(Requirements[RequirementIndex].Value) * CraftCount;
+
+		SourceOrderForRequirement.Reset();
+		for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); ++SourceIndex)
 		{
-			const FItemBundle CraftedItem = FItemBundle(ItemRecipe->ResultingItemId, ItemRecipe->QuantityCreated);
-			const int32 QuantityAdded = Super::AddItemWithInstances_IfServer(Subsystem, CraftedItem.ItemId, CraftedItem.Quantity, NoInstances, 
-			                                                      true);
-			if (QuantityAdded < ItemRecipe->QuantityCreated)
+			if (Available[SourceIndex * NumRequirements + RequirementIndex] > 0)
+				SourceOrderForRequirement.Add(SourceIndex);
+		}
+		if (SourceOrder == ECraftingSourceOrder::LargestSourceFirst)
+		{
+			Algo::StableSortBy(SourceOrderForRequirement, [&Available, NumRequirements, RequirementIndex](int32 SourceIndex)
 			{
-				UE_LOG(LogRancInventorySystem, Display, TEXT("Failed to add crafted item to inventory, dropping item instead"));
+				return -Available[SourceIndex * NumRequirements + RequirementIndex];
+			});
+		}
 
-				if (!Subsystem)
-				{
-					UE_LOG(LogRancInventorySystem, Error, TEXT("Subsystem is null, cannot drop item"));
-					return false;
-				}
+		for (const int32 SourceIndex : SourceOrderForRequirement)
+		{
+			if (Remaining <= 0) break;
 
-				TArray<UItemInstanceData*> DroppingItemState;
-				Subsystem->ExtractItem_IfServer_Implementation(CraftedItem.ItemId, CraftedItem.Quantity - QuantityAdded, NoInstances,
-				                             EItemChangeReason::Transformed, DroppingItemState, false);
+			const int32 ToTake = static_cast<int32>(FMath::Min<int64>(Remaining, Available[SourceIndex * NumRequirements + RequirementIndex]));
+			int32 Taken;
+			if (UItemContainerComponent* Container = Cast<UItemContainerComponent>(Sources[SourceIndex]))
+			{
+				Taken = Container->DestroyItemImpl(ItemId, ToTake, NoInstances, EItemChangeReason::Transformed, false, false, true);
+				TouchedContainers.AddUnique(Container);
+			}
+			else
+			{
+				TArray<UItemInstanceData*> DiscardedInstances;
+				Taken = IItemSource::Execute_ExtractItem_IfServer(Sources[SourceIndex], ItemId, ToTake, NoInstances,
+				                                                  EItemChangeReason::Transformed, DiscardedInstances, false);
+			}
+			Remaining -= Taken;
+		}
+
+		ensureMsgf(Remaining <= 0, TEXT("CraftRecipeFromSources_IfServer: Sources provided %lld less %s than they reported"),
+		           Remaining, *ItemId.ToString());
+	}
+
+	// Weight and slots are recomputed once per touched container rather than once per component
+	for (UItemContainerComponent* Container : TouchedContainers)
+	{
+		Container->UpdateWeightAndSlots();
+	}
+
+	ProduceRecipeOutput(Recipe, CraftCount);
+	return CraftCount;
+}
 
-				SpawnItemIntoWorldFromContainer_ServerImpl(
-					CraftedItem.ItemId, CraftedItem.Quantity - QuantityAdded, FVector(1e+300, 0, 0), DroppingItemState);
+bool UInventoryComponent::PlanCraft(const UObjectRecipeData* Recipe, int32 Count, TArray<FRISCraftStep>& OutSteps, int32 MaxDepth) const
+{
+	OutSteps.Reset();
+	if (!Recipe || Count <= 0) return false;
+
+	TMap<FGameplayTag, int32> VirtualStock;
+	if (PlanCraftRecursive(Recipe, Count, VirtualStock, OutSteps, MaxDepth))
+		return true;
+
+	OutSteps.Reset();
+	return false;
+}
+
+bool UInventoryComponent::PlanCraftRecursive(const UObjectRecipeData* Recipe, int32 Count, TMap<FGameplayTag, int32>& VirtualStock,
+                                             TArray<FRISCraftStep>& OutSteps, int32 DepthLeft) const
+{
+	auto GetStock = [this, &VirtualStock](const FGameplayTag& ItemId) -> int32&
+	{
+		if (int32* Stock = VirtualStock.Find(ItemId))
+			return *Stock;
+		return VirtualStock.Add(ItemId, GetQuantityTotal_Implementation(ItemId));
+	};
+
+	for (const FItemBundle& Component : Recipe->Components)
+	{
+		// Quantities are multiplied in 64 bits, plans that need more than fits in an int32 are rejected instead of wrapping
+		const int64 Required = static_cast<int64>(Component.Quantity) * Count;
+		if (Required < 0 || Required > MAX_int32)
+			return false;
+
+		const int64 Available = GetStock(Component.ItemId);
+		if (Available < Required)
+		{
+			const UItemRecipeData* SubRecipe = DepthLeft > 0 ? UnlockedItemRecipesByResult.FindRef(Component.ItemId) : nullptr;
+			if (!SubRecipe || SubRecipe == Recipe || SubRecipe->QuantityCreated <= 0)
+				return false;
+
+			const int64 SubCount = FMath::DivideAndRoundUp<int64>(Required - Available, SubRecipe->QuantityCreated);
+			if (SubCount > MAX_int32 || !PlanCraftRecursive(SubRecipe, static_cast<int32>(SubCount), VirtualStock, OutSteps, DepthLeft - 1))
+				return false;
+		}
+
+		// The recursion may have grown the map, so look the stock up again
+		int32& Stock = GetStock(Component.ItemId);
+		if (Stock - Required < MIN_int32)
+			return false;
+		Stock -= static_cast<int32>(Required);
+	}
+
+	if (const UItemRecipeData* ItemRecipe = Cast<UItemRecipeData>(Recipe))
+	{
+		int32& Stock = GetStock(ItemRecipe->ResultingItemId);
+		const int64 Produced = static_cast<int64>(ItemRecipe->QuantityCreated) * Count;
+		if (Produced < 0 || Stock + Produced > MAX_int32)
+			return false;
+		Stock += static_cast<int32>(Produced);
+	}
+
+	OutSteps.Emplace(Recipe, Count);
+	return true;
+}
+
+int32 UInventoryComponent::CraftRecipeQuantity_IfServer(const UObjectRecipeData* Recipe, int32 Count, bool AllowPartial)
+{
+	if (IsClient("CraftRecipeQuantity_IfServer")) return 0;
+	if (!Recipe || Count <= 0) return 0;
+
+	const int32 CraftCount = FMath::Min(Count, GetMaxCraftableCount(Recipe));
+	if (CraftCount <= 0 || (!AllowPartial && CraftCount < Count))
+		return 0;
+
+	if (!ApplyCraftSteps({FRISCraftStep(Recipe, CraftCount)}))
+		return 0;
+	return CraftCount;
+}
+
+bool UInventoryComponent::CraftRecipeWithIntermediates_IfServer(const UObjectRecipeData* Recipe, int32 Count)
+{
+	if (IsClient("CraftRecipeWithIntermediates_IfServer")) return false;
+
+	TArray<FRISCraftStep> Steps;
+	if (!PlanCraft(Recipe, Count, Steps))
+		return false;
+
+	return ApplyCraftSteps(Steps);
+}
+
+void UInventoryComponent::CraftRecipeIdQuantity_Server_Implementation(const FPrimaryRISRecipeId& RecipeId, int32 Count, bool CraftIntermediates)
+{
+	if (Count <= 0) return;
+
+	// Count comes from the client, it is capped before it reaches any quantity math
+	Count = FMath::Min(Count, MaxCraftCountPerRequest);
+	const UObjectRecipeData* Recipe = URISSubsystem::GetRecipeDataById(RecipeId);
+	if (CraftIntermediates)
+		CraftRecipeWithIntermediates_IfServer(Recipe, Count);
+	else
+		CraftRecipeQuantity_IfServer(Recipe, Count, true);
+}
+
+bool UInventoryComponent::ApplyCraftSteps(const TArray<FRISCraftStep>& Steps)
+{
+	// Intermediates produced and consumed within the plan never touch the container
+	TMap<FGameplayTag, int64> NetChange;
+	for (const FRISCraftStep& Step : Steps)
+	{
+		for (const FItemBundle& Component : Step.Recipe->Components)
+		{
+			NetChange.FindOrAdd(Component.ItemId) -= static_cast<int64>(Component.Quantity) * Step.Count;
+		}
+		if (const UItemRecipeData* ItemRecipe = Cast<UItemRecipeData>(Step.Recipe))
+		{
+			NetChange.FindOrAdd(ItemRecipe->ResultingItemId) += static_cast<int64>(ItemRecipe->QuantityCreated) * Step.Count;
+		}
+	}
+
+	// The callers validated the steps, anything out of range here would otherwise create or destroy items from nothing.
+	// Everything is checked before the first item is taken so a refused plan leaves the container untouched
+	for (const TPair<FGameplayTag, int64>& Change : NetChange)
+	{
+		if (!ensureMsgf(Change.Value >= MIN_int32 + 1 && Change.Value <= MAX_int32, TEXT("ApplyCraftSteps: Net change of %s is out of range"), *Change.Key.ToString()))
+			return false;
+		if (Change.Value < 0 && GetQuantityTotal_Implementation(Change.Key) < -Change.Value)
+		{
+			UE_LOG(LogRancInventorySystem, Warning, TEXT("ApplyCraftSteps: Not enough %s to craft, nothing was consumed."), *Change.Key.ToString());
+			return false;
+		}
+	}
+
+	TArray<TPair<FGameplayTag, int32>, TInlineAllocator<8>> Removals;
+	for (const TPair<FGameplayTag, int64>& Change : NetChange)
+	{
+		if (Change.Value >= 0) continue;
+
+		const int32 ToRemove = static_cast<int32>(-Change.Value);
+		const int32 Removed = DestroyItemImpl(Change.Key, ToRemove, NoInstances, EItemChangeReason::Transformed, false, false, true);
+		Removals.Emplace(Change.Key, Removed);
+		if (!ensureMsgf(Removed == ToRemove, TEXT("Failed to remove all items for crafting even though they were confirmed")))
+		{
+			// Put back what was already taken so a failed craft costs nothing
+			for (const TPair<FGameplayTag, int32>& Removal : Removals)
+			{
+				if (Removal.Value > 0)
+					AddOrDropItem_ServerImpl(Removal.Key, Removal.Value);
 			}
+			UpdateWeightAndSlots();
+			return false;
 		}
-		else
+	}
+	UpdateWeightAndSlots();
+
+	for (const TPair<FGameplayTag, int64>& Change : NetChange)
+	{
+		if (Change.Value > 0)
+			AddOrDropItem_ServerImpl(Change.Key, static_cast<int32>(Change.Value));
+	}
+
+	for (const FRISCraftStep& Step : Steps)
+	{
+		if (!Step.Recipe->IsA<UItemRecipeData>())
+			OnCraftConfirmed.Broadcast(Step.Recipe->ResultingObject, static_cast<int32>(FMath::Min<int64>(static_cast<int64>(Step.Recipe->QuantityCreated) * Step.Count, MAX_int32)));
+	}
+	return true;
+}
+
+void UInventoryComponent::ConsumeRecipeComponents(const UObjectRecipeData* Recipe, int32 Count, TArray<FItemBundle>& OutHeldComponents)
+{
+	for (const FItemBundle& Component : Recipe->Components)
+	{
+		FItemBundle* Held = OutHeldComponents.FindByPredicate([&Component](const FItemBundle& Bundle) { return Bundle.ItemId == Component.ItemId; });
+		if (!Held)
+			Held = &OutHeldComponents.Emplace_GetRef(Component.ItemId, 0);
+
+		// Count never exceeds GetMaxCraftableCount, so the product fits into what the container holds
+		const int32 ToRemove = static_cast<int32>(FMath::Clamp<int64>(static_cast<int64>(Component.Quantity) * Count, 0, MAX_int32));
+		const int32 Removed = ExtractItem_ServerImpl(Component.ItemId, ToRemove, NoInstances, EItemChangeReason::Transformed, Held->InstanceData, false, false, true);
+		ensureMsgf(Removed == ToRemove, TEXT("Failed to remove all items for crafting even though they were confirmed"));
+		Held->Quantity += Removed;
+	}
+	UpdateWeightAndSlots();
+}
+
+void UInventoryComponent::ProduceRecipeOutput(const UObjectRecipeData* Recipe, int32 Count)
+{
+	const int32 Quantity = static_cast<int32>(FMath::Clamp<int64>(static_cast<int64>(Recipe->QuantityCreated) * Count, 0, MAX_int32));
+	if (const UItemRecipeData* ItemRecipe = Cast<UItemRecipeData>(Recipe))
+	{
+		AddOrDropItem_ServerImpl(ItemRecipe->ResultingItemId, Quantity);
+	}
+	else
+	{
+		OnCraftConfirmed.Broadcast(Recipe->ResultingObject, Quantity);
+	}
+}
+
+void UInventoryComponent::AddOrDropItem_ServerImpl(const FGameplayTag& ItemId, int32 Quantity)
+{
+	const int32 QuantityAdded = Super::AddItemWithInstances_IfServer(Subsystem, ItemId, Quantity, NoInstances, true);
+	if (QuantityAdded >= Quantity) return;
+
+	UE_LOG(LogRancInventorySystem, Display, TEXT("Failed to add crafted item to inventory, dropping item instead"));
+
+	if (!Subsystem)
+	{
+		UE_LOG(LogRancInventorySystem, Error, TEXT("Subsystem is null, cannot drop item"));
+		return;
+	}
+
+	TArray<UItemInstanceData*> DroppingItemState;
+	Subsystem->ExtractItem_IfServer_Implementation(ItemId, Quantity - QuantityAdded, NoInstances,
+	                                               EItemChangeReason::Transformed, DroppingItemState, false);
+
+	SpawnItemIntoWorldFromContainer_ServerImpl(ItemId, Quantity - QuantityAdded, FVector(1e+300, 0, 0), DroppingItemState);
+}
+
+int32 UInventoryComponent::QueueCraft_IfServer(const UObjectRecipeData* Recipe, int32 Count, bool AllowPartial)
+{
+	if (IsClient("QueueCraft_IfServer")) return 0;
+	if (!Recipe || Count <= 0) return 0;
+
+	const int32 CraftCount = FMath::Min(Count, GetMaxCraftableCount(Recipe));
+	if (CraftCount <= 0 || (!AllowPartial && CraftCount < Count))
+		return 0;
+
+	// Reserve by consuming now, so the queue never has to re-validate the inventory while it runs
+	FRISCraftQueueEntry& Entry = CraftQueue.AddDefaulted_GetRef();
+	Entry.Recipe = const_cast<UObjectRecipeData*>(Recipe);
+	Entry.Remaining = CraftCount;
+	ConsumeRecipeComponents(Recipe, CraftCount, Entry.HeldComponents);
+
+	if (CraftQueue.Num() == 1)
+		ScheduleNextQueuedCraft();
+
+	OnCraftQueueUpdated.Broadcast();
+	return CraftCount;
+}
+
+void UInventoryComponent::QueueCraftRecipeId_Server_Implementation(const FPrimaryRISRecipeId& RecipeId, int32 Count)
+{
+	if (Count <= 0) return;
+
+	QueueCraft_IfServer(URISSubsystem::GetRecipeDataById(RecipeId), FMath::Min(Count, MaxCraftCountPerRequest), true);
+}
+
+void UInventoryComponent::CancelCraftQueue_IfServer()
+{
+	if (IsClient("CancelCraftQueue_IfServer")) return;
+	if (CraftQueue.IsEmpty()) return;
+
+	RefundCraftQueue_ServerImpl();
+	OnCraftQueueUpdated.Broadcast();
+}
+
+void UInventoryComponent::RefundCraftQueue_ServerImpl()
+{
+	if (const UWorld* World = GetWorld())
+		World->GetTimerManager().ClearTimer(CraftQueueTimer);
+
+	// The consumed components are handed back with their instance data, whatever no longer fits is dropped
+	TArray<FRISCraftQueueEntry> Cancelled = MoveTemp(CraftQueue);
+	CraftQueue.Reset();
+	for (FRISCraftQueueEntry& Entry : Cancelled)
+	{
+		for (FItemBundle& Held : Entry.HeldComponents)
+		{
+			if (Held.Quantity <= 0) continue;
+
+			const int32 Received = ReceiveExtractedItems_IfServer(Held.ItemId, Held.Quantity, Held.InstanceData);
+			if (Received >= Held.Quantity) continue;
+
+			// Received instances are taken from the front of the array
+			TArray<UItemInstanceData*> DroppedInstances;
+			if (Held.InstanceData.Num() > Received)
+				DroppedInstances.Append(Held.InstanceData.GetData() + Received, Held.InstanceData.Num() - Received);
+			SpawnItemIntoWorldFromContainer_ServerImpl(Held.ItemId, Held.Quantity - Received, FVector(1e+300, 0, 0), DroppedInstances);
+		}
+	}
+}
+
+void UInventoryComponent::CancelCraftQueue_Server_Implementation()
+{
+	CancelCraftQueue_IfServer();
+}
+
+void UInventoryComponent::ScheduleNextQueuedCraft()
+{
+	UWorld* World = GetWorld();
+	if (CraftQueue.IsEmpty() || !World) return;
+
+	// A zero rate would clear the timer, instant recipes complete on the next frame instead
+	const float Delay = CraftQueue[0].Recipe ? CraftQueue[0].Recipe->CraftingTime : 0.f;
+	World->GetTimerManager().SetTimer(CraftQueueTimer, this, &UInventoryComponent::OnCraftQueueTimer,
+	                                  FMath::Max(Delay, UE_KINDA_SMALL_NUMBER), false);
+}
+
+void UInventoryComponent::OnCraftQueueTimer()
+{
+	if (CraftQueue.IsEmpty()) return;
+
+	// The components of the completed craft are used up, the rest stay held for the remaining crafts or a refund
+	FRISCraftQueueEntry& Entry = CraftQueue[0];
+	const UObjectRecipeData* Recipe = Entry.Recipe;
+	if (Recipe)
+	{
+		for (const FItemBundle& Component : Recipe->Components)
 		{
-			OnCraftConfirmed.Broadcast(Recipe->ResultingObject, Recipe->QuantityCreated);
+			if (FItemBundle* Held = Entry.HeldComponents.FindByPredicate([&Component](const FItemBundle& Bundle) { return Bundle.ItemId == Component.ItemId; }))
+			{
+				TArray<UItemInstanceData*> UsedInstances;
+				Held->Extract(Component.Quantity, NoInstances, UsedInstances, nullptr);
+			}
 		}
 	}
-	return bSuccess;
+
+	if (--Entry.Remaining <= 0)
+		CraftQueue.RemoveAt(0);
+
+	if (Recipe)
+		ProduceRecipeOutput(Recipe, 1);
+
+	OnCraftQueueUpdated.Broadcast();
+	ScheduleNextQueuedCraft();
+}
+
+void UInventoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Components held by queued crafts would be lost with the destroyed component, they go back before the container shuts down.
+	// Other end reasons (level transition, PIE end, streaming) leave the queue alone like the container drops do
+	if (EndPlayReason == EEndPlayReason::Destroyed && !CraftQueue.IsEmpty() && !IsClient())
+		RefundCraftQueue_ServerImpl();
+
+	URISSubsystem::OnRecipeReregistered.Remove(RecipeReregisteredHandle);
+	RecipeReregisteredHandle.Reset();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UInventoryComponent::SetRecipeLock_Server_Implementation(const FPrimaryRISRecipeId& RecipeId, bool LockState)
@@ -2024,16 +2544,23 @@ void UInventoryComponent::SetRecipeLock_Server_Implementation(const FPrimaryRISR
 			AllUnlockedRecipes.Add(RecipeId);
 		}
 
-		if (GetNetMode() == NM_ListenServer)
-		{
-			CheckAndUpdateRecipeAvailability();
-		}
+		// Clients rebuild in OnRep_Recipes, the server always needs the unlock bits
+		CheckAndUpdateRecipeAvailability();
 	}
 }
 
 UObjectRecipeData* UInventoryComponent::GetRecipeById(const FPrimaryRISRecipeId& RecipeId)
 {
-	return Cast<UObjectRecipeData>(UAssetManager::GetIfInitialized()->GetPrimaryAssetObject(RecipeId));
+	return URISSubsystem::GetRecipeDataById(RecipeId);
+}
+
+bool UInventoryComponent::IsRecipeUnlocked(const FPrimaryRISRecipeId& RecipeId) const
+{
+	const FRISRecipeHandle Handle = URISSubsystem::ResolveRecipeHandle(RecipeId);
+	if (!Handle.IsValid())
+		return AllUnlockedRecipes.Contains(RecipeId); // Not resolvable yet, e.g. recipes still loading
+
+	return UnlockedRecipeBits.IsValidIndex(Handle.Index) && UnlockedRecipeBits[Handle.Index];
 }
 
 TArray<UObjectRecipeData*> UInventoryComponent::GetAvailableRecipes(FGameplayTag TagFilter)
@@ -2045,25 +2572,57 @@ TArray<UObjectRecipeData*> UInventoryComponent::GetAvailableRecipes(FGameplayTag
 
 void UInventoryComponent::CheckAndUpdateRecipeAvailability()
 {
-	// Clear current available recipes
+	// Clear current available recipes and the ingredient index
 	CurrentAvailableRecipes.Empty();
+	TrackedRecipes.Reset();
+	RecipesByIngredient.Reset();
+	RecipeComponentSatisfied.Reset();
+	UnlockedItemRecipesByResult.Reset();
+	UnlockedRecipeBits.Init(false, URISSubsystem::GetNumRegisteredRecipes());
 
-	// Iterate through all available recipes and check if they can be crafted
+	// The index below holds component counts and ingredient positions of each recipe, re-registered recipes invalidate it
+	if (!RecipeReregisteredHandle.IsValid())
+		RecipeReregisteredHandle = URISSubsystem::OnRecipeReregistered.AddUObject(this, &UInventoryComponent::HandleRecipeReregistered);
+
+	// Index every unlocked recipe by its components so item changes only touch the recipes that use that item
 	for (const FPrimaryRISRecipeId& RecipeId : AllUnlockedRecipes)
 	{
-		UObjectRecipeData* Recipe = GetRecipeById(RecipeId);
-		if (CanCraftRecipe(Recipe))
+		const FRISRecipeHandle Handle = URISSubsystem::ResolveRecipeHandle(RecipeId);
+		UObjectRecipeData* Recipe = URISSubsystem::GetRecipeByHandle(Handle);
+		if (!Recipe) continue;
+
+		// Resolving may have registered a new recipe
+		if (Handle.Index >= UnlockedRecipeBits.Num())
+			UnlockedRecipeBits.Add(false, Handle.Index + 1 - UnlockedRecipeBits.Num());
+		UnlockedRecipeBits[Handle.Index] = true;
+
+		const int32 RecipeIndex = TrackedRecipes.Num();
+		FRISRecipeAvailabilityState& State = TrackedRecipes.AddDefaulted_GetRef();
+		State.Recipe = Recipe;
+		State.Handle = Handle;
+		State.FirstComponentBit = RecipeComponentSatisfied.Num();
+
+		if (const UItemRecipeData* ItemRecipe = Cast<UItemRecipeData>(Recipe))
+			UnlockedItemRecipesByResult.FindOrAdd(ItemRecipe->ResultingItemId, ItemRecipe);
+
+		const TConstArrayView<FGameplayTag> IngredientIds = URISSubsystem::GetRecipeIngredientIds(Handle);
+		const TConstArrayView<int32> IngredientQuantities = URISSubsystem::GetRecipeIngredientQuantities(Handle);
+		for (int32 ComponentIndex = 0; ComponentIndex < IngredientIds.Num(); ++ComponentIndex)
+		{
+			const bool Satisfied = IsRecipeComponentSatisfied(IngredientIds[ComponentIndex], IngredientQuantities[ComponentIndex]);
+			RecipeComponentSatisfied.Add(Satisfied);
+			if (!Satisfied) ++State.MissingComponents;
+			RecipesByIngredient.FindOrAdd(IngredientIds[ComponentIndex]).Add({RecipeIndex, ComponentIndex});
+		}
+
+		if (State.MissingComponents == 0)
 		{
 			for (const FGameplayTag& Category : RecipeTagFilters)
 			{
 				// If recipe matches a category, add it to the corresponding list
 				if (Recipe->Tags.HasTag(Category))
 				{
-					if (!CurrentAvailableRecipes.Contains(Category))
-					{
-						CurrentAvailableRecipes.Add(Category, {}); // ensure the value is a valid array
-					}
-					CurrentAvailableRecipes[Category].Add(Recipe);
+					CurrentAvailableRecipes.FindOrAdd(Category).Add(Recipe);
 				}
 			}
 		}
@@ -2072,6 +2631,67 @@ void UInventoryComponent::CheckAndUpdateRecipeAvailability()
 	OnAvailableRecipesUpdated.Broadcast();
 }
 
+void UInventoryComponent::UpdateRecipeAvailabilityForItem(const FGameplayTag& ItemId)
+{
+	const TArray<FRISRecipeIngredientRef>* Dependents = RecipesByIngredient.Find(ItemId);
+	if (!Dependents) return;
+
+	bool AnyChanged = false;
+	for (const FRISRecipeIngredientRef& Ref : *Dependents)
+	{
+		FRISRecipeAvailabilityState& State = TrackedRecipes[Ref.RecipeIndex];
+		const int32 Bit = State.FirstComponentBit + Ref.ComponentIndex;
+		const int32 RequiredQuantity = URISSubsystem::GetRecipeIngredientQuantities(State.Handle)[Ref.ComponentIndex];
+		const bool Satisfied = IsRecipeComponentSatisfied(ItemId, RequiredQuantity);
+		if (RecipeComponentSatisfied[Bit] == Satisfied) continue;
+
+		RecipeComponentSatisfied[Bit] = Satisfied;
+		const bool WasAvailable = State.MissingComponents == 0;
+		State.MissingComponents += Satisfied ? -1 : 1;
+		const bool IsAvailable = State.MissingComponents == 0;
+		if (WasAvailable != IsAvailable)
+		{
+			SetRecipeAvailable(State.Recipe, IsAvailable);
+			AnyChanged = true;
+		}
+	}
+
+	if (AnyChanged)
+		OnAvailableRecipesUpdated.Broadcast();
+}
+
+void UInventoryComponent::HandleRecipeReregistered(FRISRecipeHandle Handle)
+{
+	if (UnlockedRecipeBits.IsValidIndex(Handle.Index) && UnlockedRecipeBits[Handle.Index])
+		CheckAndUpdateRecipeAvailability();
+}
+
+bool UInventoryComponent::IsRecipeComponentSatisfied(const FGameplayTag& ItemId, int32 RequiredQuantity) const
+{
+	// Mirrors Contains(), an absent item never satisfies a component even if the required quantity is 0
+	const int32 QuantityContained = GetQuantityTotal_Implementation(ItemId);
+	return QuantityContained > 0 && QuantityContained >= RequiredQuantity;
+}
+
+void UInventoryComponent::SetRecipeAvailable(UObjectRecipeData* Recipe, bool IsAvailable)
+{
+	for (const FGameplayTag& Category : RecipeTagFilters)
+	{
+		if (!Recipe->Tags.HasTag(Category)) continue;
+
+		if (IsAvailable)
+		{
+			CurrentAvailableRecipes.FindOrAdd(Category).Add(Recipe);
+		}
+		else if (TArray<UObjectRecipeData*>* CategoryRecipes = CurrentAvailableRecipes.Find(Category))
+		{
+			CategoryRecipes->RemoveSingle(Recipe);
+		}
+	}
+
+	OnRecipeAvailabilityChanged.Broadcast(Recipe, IsAvailable);
+}
+
 
 int32 UInventoryComponent::DropFromTaggedSlot(const FGameplayTag& SlotTag, int32 Quantity, const TArray<UItemInstanceData*>& InstancesToDrop, FVector RelativeDropLocation)
 {
@@ -2131,18 +2751,29 @@ void UInventoryComponent::DropFromTaggedSlot_ServerImpl(const FGameplayTag& Slot
 
 int32 UInventoryComponent::DropAllItems_ServerImpl()
 {
+	if (IsClient("DropAllItems_ServerImpl"))
+		return 0;
+
 	int32 DroppedCount = 0;
 
+	// Tagged items join the container items in the same placement and spawn batches
 	for (int i = TaggedSlotItems.Num() - 1; i >= 0; i--)
 	{
-		FVector DropLocation = GetOwner()->GetActorForwardVector() * DefaultDropDistance + FVector(
-			FMath::FRand() * 100, FMath::FRand() * 100, 100);
-		DropFromTaggedSlot_ServerImpl(TaggedSlotItems[i].Tag, TaggedSlotItems[i].Quantity, NoInstances, DropLocation);
-		DroppedCount++;
+		if (!TaggedSlotItems[i].IsValid()) continue;
+
+		const FGameplayTag SlotTag = TaggedSlotItems[i].Tag;
+		const FGameplayTag ItemId = TaggedSlotItems[i].ItemId;
+		TArray<UItemInstanceData*> DroppedInstances;
+		const int32 Extracted = ExtractItemFromTaggedSlot_IfServer(SlotTag, ItemId, TaggedSlotItems[i].Quantity, NoInstances, EItemChangeReason::Dropped, DroppedInstances);
+		if (Extracted > 0)
+		{
+			QueueWorldDrop(ItemId, Extracted, MoveTemp(DroppedInstances));
+			DroppedCount++;
+		}
 	}
 
 	TaggedSlotItems.Empty();
-	Super::DropAllItems_ServerImpl();
+	DroppedCount += Super::DropAllItems_ServerImpl();
 
 	return DroppedCount;
 }
@@ -2215,16 +2846,23 @@ void UInventoryComponent::UpdateWeightAndSlots()
 	ensureMsgf(UsedContainerSlotCount <= MaxSlotCount, TEXT("Used slot count is higher than max slot count!"));
 }
 
+int32 UInventoryComponent::GetGridItemQuantity(const FItemBundle& Item) const
+{
+	return GetContainerOnlyItemQuantity(Item.ItemId);
+}
+
 void UInventoryComponent::OnInventoryItemAddedHandler(const UItemStaticData* ItemData, int32 Quantity,
                                                       const TArray<UItemInstanceData*>& InstancesAdded, EItemChangeReason Reason)
 {
-	CheckAndUpdateRecipeAvailability();
+	if (ItemData)
+		UpdateRecipeAvailabilityForItem(ItemData->ItemId);
 }
 
 void UInventoryComponent::OnInventoryItemRemovedHandler(const UItemStaticData* ItemData, int32 Quantity,
 														const TArray<UItemInstanceData*>& InstancesRemoved, EItemChangeReason Reason)
 {
-	CheckAndUpdateRecipeAvailability();
+	if (ItemData)
+		UpdateRecipeAvailabilityForItem(ItemData->ItemId);
 }
 
 void UInventoryComponent::OnRep_Recipes()
@@ -10,6 +10,9 @@
 #include "Data/UsableItemDefinition.h"
 #include "Net/UnrealNetwork.h"
 #include "Net/Core/PushModel/PushModel.h"
+#include "Algo/StableSort.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
 
 const TArray<UItemInstanceData*> UItemContainerComponent::NoInstances;
 
@@ -204,6 +207,13 @@ int32 UItemContainerComponent::GetQuantityContainerCanReceiveBySlots(const UItem
 				  ? ItemData->MaxStackSize - (ContainedQuantity % ItemData->MaxStackSize)
 				  : 0
 			: 0;
+	if (JigsawMode && JigsawGrid.GetHeight() > 0)
+	{
+		// Stacks have to physically fit into the packed grid, free cells alone are not enough
+		const FIntPoint ItemSize(FMath::Max(ItemData->JigsawSizeX, 1), FMath::Max(ItemData->JigsawSizeY, 1));
+		return JigsawGrid.CountFits(ItemSize, JigsawAllowRotation) * ItemData->MaxStackSize + ItemQuantityTillNextFullSlot;
+	}
+
 	int32 SlotsTakenPerStack = 1;
 	if (JigsawMode)
 	{
@@ -257,6 +267,22 @@ int32 UItemContainerComponent::AddItem_IfServer(
 		NoInstances, AllowPartial, SuppressEvents, SuppressUpdate);
 }
 
+int32 UItemContainerComponent::AddItems_IfServer(TScriptInterface<IItemSource> ItemSource, const TArray<FItemBundle>& Items, bool AllowPartial, bool SuppressEvents)
+{
+	if (IsClient("AddItems_IfServer"))
+		return 0;
+
+	int32 TotalAdded = 0;
+	for (const FItemBundle& Item : Items)
+	{
+		TotalAdded += AddItemWithInstances_IfServer(ItemSource, Item.ItemId, Item.Quantity, NoInstances, AllowPartial, SuppressEvents, true);
+	}
+
+	UpdateWeightAndSlots();
+	MARK_PROPERTY_DIRTY_FROM_NAME(UItemContainerComponent, ItemsVer, this);
+	return TotalAdded;
+}
+
 int32 UItemContainerComponent::AddItemWithInstances_IfServer(
 	TScriptInterface<IItemSource> ItemSource,
 	const FGameplayTag& ItemId,
@@ -348,7 +374,9 @@ int32 UItemContainerComponent::AddItemWithInstances_IfServer(
 		bCreatedNewBundle = true;
 	}
 
+	const int32 OldQuantity = ContainedItem->Quantity;
 	ContainedItem->Quantity += ActualExtractedQuantity;
+	const int32 NewQuantity = ContainedItem->Quantity;
 
 	// Handle instance data ownership transfer - NO CREATION
 	if (IsValid(ItemData->DefaultInstanceDataTemplate)) // Check if item type *should* have instance data
@@ -400,14 +428,17 @@ int32 UItemContainerComponent::AddItemWithInstances_IfServer(
 	}
 
 	// 4. Final Updates and Events
-	if (!SuppressUpdate)
+	// Suppressed updates still adjust weight and slots incrementally so following adds see the new capacity
+	if (SuppressUpdate)
+		AdjustWeightAndSlots(ItemData, OldQuantity, NewQuantity);
+	else
 		UpdateWeightAndSlots();
 	if (!SuppressEvents)
 		// Broadcast using the successfully ExtractedInstances array
 		OnItemAddedToContainer.Broadcast(ItemData, ActualExtractedQuantity, ExtractedInstances,
 		                                 EItemChangeReason::Transferred); // Use Transferred reason?
 
-	if (GetOwnerRole() == ROLE_Authority || GetOwnerRole() == ROLE_None)
+	if (!SuppressUpdate && (GetOwnerRole() == ROLE_Authority || GetOwnerRole() == ROLE_None))
 	{
 		MARK_PROPERTY_DIRTY_FROM_NAME(UItemContainerComponent, ItemsVer, this);
 	}
@@ -516,6 +547,69 @@ void UItemContainerComponent::Clear_IfServer()
 	ClearServerImpl();
 }
 
+int32 UItemContainerComponent::TransferAllItemsTo_IfServer(UItemContainerComponent* Target)
+{
+	if (IsClient("TransferAllItemsTo_IfServer") || !IsValid(Target) || Target == this)
+		return 0;
+
+	// Collected first as transfers remove emptied bundles from ItemsVer
+	TArray<FGameplayTag, TInlineAllocator<64>> ItemIds;
+	for (const FItemBundle& Item : ItemsVer.Items)
+	{
+		ItemIds.Add(Item.ItemId);
+	}
+
+	int32 TotalMoved = 0;
+	for (const FGameplayTag& ItemId : ItemIds)
+	{
+		TotalMoved += TransferItemTo_ServerImpl(Target, ItemId, MAX_int32, NoInstances, false, true);
+	}
+
+	if (TotalMoved > 0)
+	{
+		// The full update also settles any float drift from the incremental weight updates
+		UpdateWeightAndSlots();
+		Target->UpdateWeightAndSlots();
+		MARK_PROPERTY_DIRTY_FROM_NAME(UItemContainerComponent, ItemsVer, this);
+		MARK_PROPERTY_DIRTY_FROM_NAME(UItemContainerComponent, ItemsVer, Target);
+	}
+
+	return TotalMoved;
+}
+
+void UItemContainerComponent::SortItems_IfServer()
+{
+	if (IsClient("SortItems_IfServer"))
+		return;
+
+	// Sort handles with their keys looked up once rather than resolving item data on every comparison
+	TArray<TPair<FRISItemSortKey, int32>> Order;
+	Order.Reserve(ItemsVer.Items.Num());
+	for (int32 i = 0; i < ItemsVer.Items.Num(); ++i)
+	{
+		Order.Emplace(FRISItemSortKey(URISSubsystem::GetItemDataById(ItemsVer.Items[i].ItemId)), i);
+	}
+	Algo::StableSortBy(Order, [](const TPair<FRISItemSortKey, int32>& Entry) -> const FRISItemSortKey& { return Entry.Key; });
+
+	bool OrderChanged = false;
+	for (int32 i = 0; i < Order.Num() && !OrderChanged; ++i)
+	{
+		OrderChanged = Order[i].Value != i;
+	}
+	if (!OrderChanged)
+		return;
+
+	TArray<FItemBundle> SortedItems;
+	SortedItems.Reserve(ItemsVer.Items.Num());
+	for (const auto& Entry : Order)
+	{
+		SortedItems.Add(MoveTemp(ItemsVer.Items[Entry.Value]));
+	}
+	ItemsVer.Items = MoveTemp(SortedItems);
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(UItemContainerComponent, ItemsVer, this);
+}
+
 void UItemContainerComponent::RequestMoveItemToOtherContainer_Server_Implementation(
 	UItemContainerComponent* TargetComponent,
 	const FGameplayTag& ItemId,
@@ -568,67 +662,135 @@ int32 UItemContainerComponent::DropAllItems_ServerImpl()
 	if (IsClient("DropAllItems_ServerImpl"))
 		return 0;
 
-	int32 DroppedStacksCount = 0;
-	AActor* OwnerActor = GetOwner();
-	if (!OwnerActor)
+	if (!GetOwner())
 	{
 		UE_LOG(LogRancInventorySystem, Error, TEXT("DropAllItems_ServerImpl: Cannot drop items, OwnerActor is null."));
 		return 0;
 	}
 
-	const int32 InitialItemTypeCount = ItemsVer.Items.Num(); // For angle calculation
-	float CurrentAngle = FMath::FRand() * 360.0f; // Start at a random angle
-	const float AngleStep = (InitialItemTypeCount > 0) ? (360.0f / InitialItemTypeCount) : 0.0f;
-
-	// Loop while the container still has items. DropItemFromContainer_Server will extract quantity,
-	// eventually emptying the bundles and causing them to be removed from ItemsVer.Items.
-	while (ItemsVer.Items.Num() > 0)
+	// Collected first as extracting removes the emptied bundles
+	TArray<FGameplayTag, TInlineAllocator<32>> ItemIds;
+	for (const FItemBundle& Item : ItemsVer.Items)
 	{
-		FItemBundle& ItemToProcess = ItemsVer.Items.Last();
-		FGameplayTag& ItemIdToProcess = ItemToProcess.ItemId;
-		int32 CurrentQuantityOfItem = ItemToProcess.Quantity;
-		const UItemStaticData* ItemData = URISSubsystem::GetItemDataById(ItemIdToProcess);
+		ItemIds.Add(Item.ItemId);
+	}
 
-		// 3a. Get Item Data and Stack Size
-		if (!ItemIdToProcess.IsValid() || !IsValid(ItemData))
+	int32 DroppedCount = 0;
+	for (const FGameplayTag& ItemId : ItemIds)
+	{
+		const FItemBundle* Item = FindItemInstance(ItemId);
+		const UItemStaticData* ItemData = URISSubsystem::GetItemDataById(ItemId);
+		if (!Item || !ItemId.IsValid() || !ItemData)
 		{
-			UE_LOG(LogRancInventorySystem, Error, TEXT("DropAllItems_ServerImpl: ItemId %s is invalid or ItemData not found."),
-			       *ItemIdToProcess.ToString());
-			ItemsVer.Items.Pop();
+			UE_LOG(LogRancInventorySystem, Error, TEXT("DropAllItems_ServerImpl: ItemId %s is invalid or ItemData not found."), *ItemId.ToString());
 			continue;
 		}
 
-		if (CurrentQuantityOfItem <= 0)
+		TArray<UItemInstanceData*> DroppedInstances;
+		int32 Remaining = ExtractItem_ServerImpl(ItemId, Item->Quantity, NoInstances, EItemChangeReason::Dropped, DroppedInstances, true, false, true);
+
+		// One world item per stack, or everything of one type as a single world item if merging is enabled
+		const int32 StackSize = bDropAllItemsMergesStacks ? Remaining : FMath::Max(ItemData->MaxStackSize, 1);
+		int32 NextInstance = 0;
+		while (Remaining > 0)
 		{
-			ItemsVer.Items.Pop();
-			continue;
+			const int32 StackQuantity = FMath::Min(Remaining, StackSize);
+			const int32 NumStackInstances = FMath::Min(StackQuantity, DroppedInstances.Num() - NextInstance);
+			TArray<UItemInstanceData*> StackInstances(DroppedInstances.GetData() + NextInstance, NumStackInstances);
+			NextInstance += NumStackInstances;
+			Remaining -= StackQuantity;
+
+			QueueWorldDrop(ItemId, StackQuantity, MoveTemp(StackInstances));
+			DroppedCount++;
 		}
+	}
 
-		int32 QuantityForThisStack = FMath::Min(CurrentQuantityOfItem, ItemData->MaxStackSize);
+	// Items without data can't be dropped, they are removed like before
+	ItemsVer.Items.RemoveAll([](const FItemBundle& Item) { return !URISSubsystem::GetItemDataById(Item.ItemId); });
 
-		FVector Direction = FVector::ForwardVector.RotateAngleAxis(CurrentAngle, FVector::UpVector);
-		FVector Offset = Direction * DefaultDropDistance;
-		Offset += FVector(FMath::FRandRange(-20.f, 20.f), FMath::FRandRange(-20.f, 20.f), FMath::FRandRange(0.f, 50.f));
-		FVector DropLocation = OwnerActor->GetActorLocation() + OwnerActor->GetActorRotation().RotateVector(Offset);
-		// Ensure offset respects actor rotation
-		TArray<UItemInstanceData*> ItemInstancesToDrop;
-		// Grab QuantityForThisStack instances from the end of ItemToProcess.InstanceData
-		if (ItemToProcess.InstanceData.Num() > 0)
-			for (int32 i = ItemToProcess.InstanceData.Num() - 1; i >= 0 && ItemInstancesToDrop.Num() <
-			     QuantityForThisStack; --i)
-				if (UItemInstanceData* InstanceData = ItemToProcess.InstanceData[i])
-					ItemInstancesToDrop.Add(InstanceData);
+	UpdateWeightAndSlots();
+	MARK_PROPERTY_DIRTY_FROM_NAME(UItemContainerComponent, ItemsVer, this);
 
-		DropItemFromContainer_ServerImpl(ItemToProcess.ItemId, QuantityForThisStack, ItemInstancesToDrop, DropLocation);
+	SpawnPendingWorldDrops();
+	return DroppedCount;
+}
 
-		DroppedStacksCount++;
-		CurrentAngle += AngleStep;
+void UItemContainerComponent::QueueWorldDrop(const FGameplayTag& ItemId, int32 Quantity, TArray<UItemInstanceData*>&& Instances)
+{
+	if (PendingWorldDrops.IsEmpty())
+	{
+		NextDropPlacementIndex = 0;
+		DropPlacementStartAngle = FMath::FRand() * 360.0f;
 	}
 
-	UpdateWeightAndSlots();
-	MARK_PROPERTY_DIRTY_FROM_NAME(UItemContainerComponent, ItemsVer, this);
+	// Rings start at DefaultDropDistance and are DropAllItemsSpacing apart, each holding as many drops as fit DropAllItemsSpacing apart
+	const float Spacing = FMath::Max(DropAllItemsSpacing, 1.f);
+	int32 RingIndex = NextDropPlacementIndex++;
+	int32 Ring = 0;
+	float Radius = DefaultDropDistance;
+	int32 RingCapacity = FMath::Max(1, FMath::FloorToInt(UE_TWO_PI * Radius / Spacing));
+	while (RingIndex >= RingCapacity)
+	{
+		RingIndex -= RingCapacity;
+		Ring++;
+		Radius += Spacing;
+		RingCapacity = FMath::Max(1, FMath::FloorToInt(UE_TWO_PI * Radius / Spacing));
+	}
 
-	return DroppedStacksCount;
+	// Odd rings are offset by half a step so drops don't line up radially
+	const float Angle = DropPlacementStartAngle + 360.0f * (RingIndex + 0.5f * (Ring % 2)) / RingCapacity;
+
+	FRISPendingWorldDrop& Drop = PendingWorldDrops.AddDefaulted_GetRef();
+	Drop.Item.ItemId = ItemId;
+	Drop.Item.Quantity = Quantity;
+	Drop.Item.InstanceData = MoveTemp(Instances);
+	Drop.Offset = FVector::ForwardVector.RotateAngleAxis(Angle, FVector::UpVector) * Radius;
+}
+
+void UItemContainerComponent::SpawnPendingWorldDrops()
+{
+	AActor* Owner = GetOwner();
+	UWorld* World = GetWorld();
+	if (PendingWorldDrops.IsEmpty() || !Owner || !World)
+		return;
+
+	const double Deadline = DropAllItemsFrameBudgetMs > 0 ? FPlatformTime::Seconds() + DropAllItemsFrameBudgetMs * 0.001 : TNumericLimits<double>::Max();
+	const FVector OwnerLocation = Owner->GetActorLocation();
+	const FRotator Facing(0, Owner->GetActorRotation().Yaw, 0);
+
+	// Each drop is traced down from above its own position so drops on slopes or ledges land on the ground below them,
+	// drops without ground below keep the owner's height
+	constexpr float GroundTraceUp = 200.f;
+	constexpr float GroundTraceDown = 1000.f;
+	constexpr float DropHeightAboveGround = 10.f;
+	const FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(RISDropGroundTrace), false, Owner);
+
+	URISSubsystem* Subsystem = URISSubsystem::Get(this);
+	int32 NumSpawned = 0;
+	while (NumSpawned < PendingWorldDrops.Num() && (NumSpawned == 0 || FPlatformTime::Seconds() < Deadline))
+	{
+		FRISPendingWorldDrop& Drop = PendingWorldDrops[NumSpawned++];
+		FVector Location = OwnerLocation + Facing.RotateVector(Drop.Offset);
+		FHitResult GroundHit;
+		if (World->LineTraceSingleByChannel(GroundHit, Location + FVector(0, 0, GroundTraceUp), Location - FVector(0, 0, GroundTraceDown), ECC_WorldStatic, TraceParams))
+			Location.Z = GroundHit.Location.Z + DropHeightAboveGround;
+		Subsystem->SpawnWorldItem(this, MoveTemp(Drop.Item), Location, DropItemClass);
+	}
+	PendingWorldDrops.RemoveAt(0, NumSpawned);
+
+	if (!PendingWorldDrops.IsEmpty())
+		World->GetTimerManager().SetTimerForNextTick(this, &UItemContainerComponent::SpawnPendingWorldDrops);
+}
+
+void UItemContainerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (EndPlayReason == EEndPlayReason::Destroyed && !PendingWorldDrops.IsEmpty())
+	{
+		DropAllItemsFrameBudgetMs = 0;
+		SpawnPendingWorldDrops();
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UItemContainerComponent::UseItem_Server_Implementation(const FGameplayTag& ItemId, int32 ItemToUseInstanceId)
@@ -877,8 +1039,12 @@ void UItemContainerComponent::UpdateWeightAndSlots()
 {
 	CurrentWeight = 0.0f; // Reset weight
 	UsedContainerSlotCount = 0;
+	ItemsChecksum = 0;
 	for (const auto& ItemInstanceWithState : ItemsVer.Items)
 	{
+		if (ItemInstanceWithState.Quantity > 0 && ItemInstanceWithState.ItemId.IsValid())
+			ItemsChecksum += FRISItemChecksum::Contribution(ItemInstanceWithState.ItemId, ItemInstanceWithState.Quantity);
+
 		if (const UItemStaticData* const ItemData = URISSubsystem::GetItemDataById(ItemInstanceWithState.ItemId))
 		{
 			int32 SlotsTakenPerStack = 1;
@@ -900,6 +1066,107 @@ void UItemContainerComponent::UpdateWeightAndSlots()
 
 	// We can't ensure here because child class inventory will call this and purposefully violate the constraint temporarily
 	// ensureMsgf(UsedContainerSlotCount <= MaxContainerSlotCount, TEXT("Used slot count is higher than max slot count!"));
+
+	if (JigsawMode)
+		UpdateJigsawGrid();
+}
+
+void UItemContainerComponent::AdjustWeightAndSlots(const UItemStaticData* ItemData, int32 OldQuantity, int32 NewQuantity)
+{
+	// Tagged slot items of inventories don't change here so their share of the slot count stays the same
+	const int32 MaxStackSize = FMath::Max(ItemData->MaxStackSize, 1);
+	const int32 SlotsTakenPerStack = JigsawMode ? ItemData->JigsawSizeX * ItemData->JigsawSizeY : 1;
+	UsedContainerSlotCount += (FMath::DivideAndRoundUp(NewQuantity, MaxStackSize) - FMath::DivideAndRoundUp(OldQuantity, MaxStackSize)) * SlotsTakenPerStack;
+	CurrentWeight += ItemData->ItemWeight * (NewQuantity - OldQuantity);
+	ItemsChecksum += FRISItemChecksum::Contribution(ItemData->ItemId, NewQuantity) - FRISItemChecksum::Contribution(ItemData->ItemId, OldQuantity);
+
+	// Only the stacks of this item are placed or removed, the rest of the layout stays as it is
+	if (JigsawMode && JigsawGrid.GetHeight() > 0)
+	{
+		const FItemBundle* Item = FindItemInstance(ItemData->ItemId);
+		SetJigsawStackCount(ItemData, Item ? FMath::DivideAndRoundUp(GetGridItemQuantity(*Item), MaxStackSize) : 0);
+	}
+}
+
+void UItemContainerComponent::UpdateJigsawGrid()
+{
+	// MaxSlotCount defaults to MAX_int32, rows are capped so an unconfigured container doesn't allocate a huge grid.
+	// A MaxSlotCount that doesn't fill the last row gets a partial row whose remaining cells are blocked
+	constexpr int32 MaxJigsawGridRows = 1024;
+	const int32 Width = FMath::Clamp(JigsawGridWidth, 1, FRISJigsawGrid::MaxWidth);
+	const int32 Height = FMath::Min(MaxSlotCount / Width + (MaxSlotCount % Width != 0 ? 1 : 0), MaxJigsawGridRows);
+	if (JigsawGrid.GetWidth() != Width || JigsawGrid.GetHeight() != Height || JigsawGrid.GetNumCells() != FMath::Min(MaxSlotCount, Width * Height))
+	{
+		JigsawGrid.Init(Width, Height, MaxSlotCount);
+		JigsawStackCounts.Reset();
+	}
+
+	// Only items whose stack count changed since the last update touch the grid
+	int32 NumItemsWithStacks = 0;
+	for (const FItemBundle& Item : ItemsVer.Items)
+	{
+		const UItemStaticData* ItemData = URISSubsystem::GetItemDataById(Item.ItemId);
+		const int32 GridQuantity = GetGridItemQuantity(Item);
+		if (!ItemData || GridQuantity <= 0) continue;
+
+		NumItemsWithStacks++;
+		SetJigsawStackCount(ItemData, FMath::DivideAndRoundUp(GridQuantity, FMath::Max(ItemData->MaxStackSize, 1)));
+	}
+
+	// Items that left the container entirely still have their placements
+	if (JigsawStackCounts.Num() > NumItemsWithStacks)
+	{
+		TArray<FGameplayTag, TInlineAllocator<8>> RemovedItems;
+		for (const auto& Pair : JigsawStackCounts)
+		{
+			const FItemBundle* Item = FindItemInstance(Pair.Key);
+			if (!Item || GetGridItemQuantity(*Item) <= 0)
+				RemovedItems.Add(Pair.Key);
+		}
+		for (const FGameplayTag& ItemId : RemovedItems)
+		{
+			SetJigsawStackCount(URISSubsystem::GetItemDataById(ItemId), 0, ItemId);
+		}
+	}
+}
+
+void UItemContainerComponent::SetJigsawStackCount(const UItemStaticData* ItemData, int32 NewStackCount, FGameplayTag ItemId)
+{
+	if (ItemData)
+		ItemId = ItemData->ItemId;
+
+	int32& PlacedStacks = JigsawStackCounts.FindOrAdd(ItemId);
+	if (PlacedStacks == NewStackCount)
+		return;
+
+	// Surplus stacks are taken off the end so the oldest placements stay where the player put them
+	for (int32 i = JigsawGrid.GetPlacements().Num() - 1; i >= 0 && PlacedStacks > NewStackCount; --i)
+	{
+		if (JigsawGrid.GetPlacements()[i].ItemId != ItemId) continue;
+
+		JigsawGrid.RemovePlacement(i);
+		PlacedStacks--;
+	}
+
+	if (ItemData)
+	{
+		const FIntPoint ItemSize(FMath::Max(ItemData->JigsawSizeX, 1), FMath::Max(ItemData->JigsawSizeY, 1));
+		for (; PlacedStacks < NewStackCount; ++PlacedStacks)
+		{
+			if (JigsawGrid.PlaceAnywhere(ItemId, ItemSize, JigsawAllowRotation) != INDEX_NONE)
+				continue;
+
+			if (JigsawGrid.AutoArrange(JigsawAllowRotation) && JigsawGrid.PlaceAnywhere(ItemId, ItemSize, JigsawAllowRotation) != INDEX_NONE)
+				continue;
+
+			// Counted as placed anyway so the same stack isn't searched for again on every update
+			UE_LOG(LogRancInventorySystem, Warning, TEXT("UpdateJigsawGrid: %s does not fit into the jigsaw grid of %s"), *ItemId.ToString(), *GetNameSafe(GetOwner()));
+		}
+	}
+	PlacedStacks = NewStackCount;
+
+	if (NewStackCount <= 0)
+		JigsawStackCounts.Remove(ItemId);
 }
 
 void UItemContainerComponent::RebuildItemsToCache()
@@ -1017,6 +1284,117 @@ void UItemContainerComponent::OnRep_Items()
 	DetectAndPublishChanges();
 }
 
+int32 UItemContainerComponent::TransferItemTo_ServerImpl(UItemContainerComponent* Target, const FGameplayTag& ItemId, int32 Quantity,
+                                                        const TArray<UItemInstanceData*>& InstancesToMove, bool SuppressEvents, bool SuppressUpdate)
+{
+	if (IsClient("TransferItemTo_ServerImpl") || !IsValid(Target) || Target == this) return 0;
+
+	const UItemStaticData* ItemData = URISSubsystem::GetItemDataById(ItemId);
+	if (BadItemData(ItemData, ItemId)) return 0;
+
+	FItemBundle* SourceItem = FindItemInstanceMutable(ItemId);
+	if (!SourceItem) return 0;
+
+	// Inventories can only give what is not held in tagged slots
+	const int32 MovableQuantity = GetGridItemQuantity(*SourceItem);
+	if (SourceItem->InstanceData.Num() > 0 && MovableQuantity != SourceItem->Quantity) return 0;
+
+	const int32 RequestedQuantity = InstancesToMove.IsEmpty() ? FMath::Min(Quantity, MovableQuantity) : InstancesToMove.Num();
+	if (RequestedQuantity <= 0) return 0;
+
+	const int32 QuantityToMove = Target->GetReceivableQuantity(ItemData, RequestedQuantity, true);
+	if (QuantityToMove <= 0)
+	{
+		UE_LOG(LogRancInventorySystem, Verbose, TEXT("TransferItemTo_ServerImpl: %s cannot receive %s"), *GetNameSafe(Target->GetOwner()), *ItemId.ToString());
+		return 0;
+	}
+
+	FItemBundle* TargetItem = Target->FindItemInstanceMutable(ItemId);
+	if (!TargetItem)
+		TargetItem = &Target->ItemsVer.Items.Emplace_GetRef(ItemId);
+
+	const int32 OldSourceQuantity = SourceItem->Quantity;
+	const int32 OldTargetQuantity = TargetItem->Quantity;
+	const int32 FirstMovedInstance = TargetItem->InstanceData.Num();
+	int32 MovedQuantity = QuantityToMove;
+
+	if (SourceItem->InstanceData.Num() > 0)
+	{
+		if (!InstancesToMove.IsEmpty())
+		{
+			for (UItemInstanceData* Instance : InstancesToMove)
+			{
+				if (TargetItem->InstanceData.Num() - FirstMovedInstance >= QuantityToMove) break;
+				if (Instance && SourceItem->InstanceData.RemoveSingle(Instance) > 0)
+					TargetItem->InstanceData.Add(Instance);
+			}
+		}
+		else if (QuantityToMove == SourceItem->InstanceData.Num() && TargetItem->InstanceData.IsEmpty())
+		{
+			// The whole stack goes into an empty bundle, hand over the array itself
+			TargetItem->InstanceData = MoveTemp(SourceItem->InstanceData);
+		}
+		else
+		{
+			// Taken from the end like FItemBundle::Extract does
+			const int32 FirstTaken = SourceItem->InstanceData.Num() - QuantityToMove;
+			TargetItem->InstanceData.Append(SourceItem->InstanceData.GetData() + FirstTaken, QuantityToMove);
+			SourceItem->InstanceData.RemoveAt(FirstTaken, QuantityToMove, EAllowShrinking::No);
+		}
+		MovedQuantity = TargetItem->InstanceData.Num() - FirstMovedInstance;
+
+		// Re-register with the new owner in one pass, containers on the same actor keep the registration
+		AActor* SourceOwner = GetOwner();
+		AActor* TargetOwner = Target->GetOwner();
+		for (int32 i = FirstMovedInstance; i < TargetItem->InstanceData.Num(); ++i)
+		{
+			UItemInstanceData* Instance = TargetItem->InstanceData[i];
+			if (SourceOwner != TargetOwner)
+			{
+				SourceOwner->RemoveReplicatedSubObject(Instance);
+				TargetOwner->AddReplicatedSubObject(Instance);
+			}
+			Instance->Initialize(true, nullptr, Target);
+		}
+	}
+
+	SourceItem->Quantity -= MovedQuantity;
+	TargetItem->Quantity += MovedQuantity;
+
+	// Events get their own copy as listeners may change either container
+	TArray<UItemInstanceData*> MovedInstances;
+	if (!SuppressEvents && TargetItem->InstanceData.Num() > FirstMovedInstance)
+		MovedInstances.Append(TargetItem->InstanceData.GetData() + FirstMovedInstance, TargetItem->InstanceData.Num() - FirstMovedInstance);
+
+	if (SourceItem->Quantity <= 0)
+		ItemsVer.Items.RemoveAt(SourceItem - ItemsVer.Items.GetData());
+	if (TargetItem->Quantity <= 0)
+		Target->ItemsVer.Items.RemoveAt(TargetItem - Target->ItemsVer.Items.GetData());
+
+	if (MovedQuantity <= 0) return 0;
+
+	if (SuppressUpdate)
+	{
+		AdjustWeightAndSlots(ItemData, OldSourceQuantity, OldSourceQuantity - MovedQuantity);
+		Target->AdjustWeightAndSlots(ItemData, OldTargetQuantity, OldTargetQuantity + MovedQuantity);
+	}
+	else
+	{
+		UpdateWeightAndSlots();
+		Target->UpdateWeightAndSlots();
+		MARK_PROPERTY_DIRTY_FROM_NAME(UItemContainerComponent, ItemsVer, this);
+		MARK_PROPERTY_DIRTY_FROM_NAME(UItemContainerComponent, ItemsVer, Target);
+	}
+
+	if (!SuppressEvents)
+	{
+		OnItemRemovedFromContainer.Broadcast(ItemData, MovedQuantity, MovedInstances, EItemChangeReason::Transferred);
+		Target->OnItemAddedToContainer.Broadcast(ItemData, MovedQuantity, MovedInstances, EItemChangeReason::Transferred);
+	}
+
+	return MovedQuantity;
+}
+
 int32 UItemContainerComponent::ReceiveExtractedItems_IfServer(const FGameplayTag& ItemId, int32 Quantiity,
                                                               const TArray<UItemInstanceData*>& ReceivedInstances, bool SuppressEvents)
 {
@@ -5,6 +5,7 @@
 #include "LogRancInventorySystem.h"
 #include <Engine/AssetManager.h>
 #include <Algo/Copy.h>
+#include <Algo/Reverse.h>
 
 void URISFunctions::UnloadAllRancItems()
 {
@@ -185,19 +186,31 @@ bool URISFunctions::ShouldItemsBeSwapped(const FGameplayTag& Source, const FGame
 	return false;
 }
 
-FRISMoveResult URISFunctions::MoveBetweenSlots(FGenericItemBundle& Source, FGenericItemBundle& Target, bool IgnoreMaxStacks, int32 RequestedQuantity, TArray<UItemInstanceData*> InstancesToMove, bool AllowPartial, bool AllowSwap)
+FRISMoveResult URISFunctions::MoveBetweenSlots(FGenericItemBundle& Source, FGenericItemBundle& Target, bool IgnoreMaxStacks, int32 RequestedQuantity, const TArray<UItemInstanceData*>& InstancesToMove, bool AllowPartial, bool AllowSwap)
 {
+	bool WereItemsSwapped = false;
+	TArrayView<UItemInstanceData* const> MovedInstances;
+	const int32 QuantityMoved = MoveBetweenSlots(Source, Target, IgnoreMaxStacks, RequestedQuantity, InstancesToMove, AllowPartial, AllowSwap, WereItemsSwapped, MovedInstances);
+	return FRISMoveResult(QuantityMoved, WereItemsSwapped, TArray<UItemInstanceData*>(MovedInstances.GetData(), MovedInstances.Num()));
+}
+
+int32 URISFunctions::MoveBetweenSlots(FGenericItemBundle& Source, FGenericItemBundle& Target, bool IgnoreMaxStacks, int32 RequestedQuantity, const TArray<UItemInstanceData*>& InstancesToMove, bool AllowPartial, bool AllowSwap,
+                                      bool& OutWereItemsSwapped, TArrayView<UItemInstanceData* const>& OutMovedInstances)
+{
+	OutWereItemsSwapped = false;
+	OutMovedInstances = TArrayView<UItemInstanceData* const>();
+
 	const UItemStaticData* SourceItemData = URISSubsystem::GetItemDataById(Source.GetItemId());
 	if (!SourceItemData)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Failed to retrieve item data for source item"));
-		return FRISMoveResult(0, false);
+		return 0;
 	}
 	
 	if (!AllowPartial && RequestedQuantity > Source.GetQuantity())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("AllowPartial set to false, can't move more than is contained."));
-		return FRISMoveResult(0, false);
+		return 0;
 	}
 		
 	int32 TransferAmount = FMath::Min(RequestedQuantity, Source.GetQuantity());
@@ -209,7 +222,7 @@ FRISMoveResult URISFunctions::MoveBetweenSlots(FGenericItemBundle& Source, FGene
 		if (!ShouldStack && Source.GetQuantity() > RequestedQuantity)
 		{
 			UE_LOG(LogTemp, Warning, TEXT("Not possible to split source slot to a occupied slot with a different item."));
-			return FRISMoveResult(0, false);
+			return 0;
 		}
 
 		const int32 RemainingSpace = IgnoreMaxStacks || !ShouldStack ? TransferAmount : SourceItemData->MaxStackSize - Target.GetQuantity();
@@ -221,64 +234,80 @@ FRISMoveResult URISFunctions::MoveBetweenSlots(FGenericItemBundle& Source, FGene
 	if (TransferAmount <= 0)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Possible transfer amount was 0"));
-		return FRISMoveResult(0, false);
+		return 0;
 	}
 	
 	if (!AllowPartial && TransferAmount < RequestedQuantity)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("AllowPartial set to false, and could not move the full requested amount"));
-		return FRISMoveResult(0, false);
+		return 0;
 	}
 
+	TArray<UItemInstanceData*>* SourceInstances = Source.GetInstances();
+	TArray<UItemInstanceData*>* TargetInstances = Target.GetInstances();
 
 	if (DoSimpleSwap)
 	{
 		const FGameplayTag TempId = Source.GetItemId();
 		const int32 TempQuantity = Source.GetQuantity();
-		const TArray<UItemInstanceData*> TempInstances = *Source.GetInstances();
 		Source.SetItemId(Target.GetItemId());  // Target might be invalid but that's fine
 		Source.SetQuantity(Target.GetQuantity());
-		Source.SetInstances(*Target.GetInstances());
 		Target.SetItemId(TempId);
 		Target.SetQuantity(TempQuantity);
-		Target.SetInstances(TempInstances);
-		
-		return FRISMoveResult(TransferAmount, Source.IsValid(), TempInstances);
+		// Swapping the arrays exchanges their allocations instead of copying the instances
+		Swap(*SourceInstances, *TargetInstances);
+
+		OutWereItemsSwapped = Source.IsValid();
+		OutMovedInstances = *TargetInstances;
+		return TransferAmount;
 	}
 
 	Target.SetItemId(Source.GetItemId());
 	Target.SetQuantity(Target.GetQuantity() + TransferAmount);
 	Source.SetQuantity(Source.GetQuantity() - TransferAmount);
 
+	// Moved instances always end up at the end of the target instances
+	const int32 FirstMovedInstance = TargetInstances ? TargetInstances->Num() : 0;
 	if (IsValid(SourceItemData->DefaultInstanceDataTemplate))
 	{
-		TArray<UItemInstanceData*>* SourceInstances = Source.GetInstances();
-		TArray<UItemInstanceData*>* TargetInstances = Target.GetInstances();
-
 		if (!InstancesToMove.IsEmpty())
 		{
 			TargetInstances->Append(InstancesToMove);
 			for (UItemInstanceData* Instance : InstancesToMove)
 			{
-				SourceInstances->Remove(Instance);
+				const int32 InstanceIndex = SourceInstances->Find(Instance);
+				if (InstanceIndex != INDEX_NONE)
+					SourceInstances->RemoveAt(InstanceIndex, 1, EAllowShrinking::No);
 			}
 		}
 		else
 		{
-			const int32 SourceInstancesCount = SourceInstances->Num();
-			for (int32 i = SourceInstancesCount - 1; TargetInstances->Num() < TransferAmount && i >= 0; --i)
+			// Taken from the end, last instance first
+			const int32 NumToMove = FMath::Min(TransferAmount, SourceInstances->Num());
+			if (NumToMove == SourceInstances->Num() && TargetInstances->IsEmpty())
+			{
+				// The whole stack goes into an empty slot, hand over the allocation
+				*TargetInstances = MoveTemp(*SourceInstances);
+				Algo::Reverse(*TargetInstances);
+			}
+			else
 			{
-				InstancesToMove.Add(SourceInstances->Last());
-				TargetInstances->Add(SourceInstances->Pop());
+				const int32 FirstMoved = SourceInstances->Num() - NumToMove;
+				for (int32 i = SourceInstances->Num() - 1; i >= FirstMoved; --i)
+				{
+					TargetInstances->Add((*SourceInstances)[i]);
+				}
+				SourceInstances->RemoveAt(FirstMoved, NumToMove, EAllowShrinking::No);
 			}
 		}
+		OutMovedInstances = TArrayView<UItemInstanceData* const>(*TargetInstances).Slice(FirstMovedInstance, TargetInstances->Num() - FirstMovedInstance);
 	}
 	
 	if (Source.GetQuantity() <= 0)
 	{
 		Source.SetItemId(FItemBundle::EmptyItemInstance.ItemId);
 		Source.SetQuantity(FItemBundle::EmptyItemInstance.Quantity);
-		Source.SetInstances(TArray<UItemInstanceData*>());
+		SourceInstances->Reset();
 	}
-	return FRISMoveResult(TransferAmount, DoSimpleSwap, InstancesToMove);
+	return TransferAmount;
 }
@@ -16,6 +16,11 @@
 TMap<FGameplayTag, UItemStaticData*> URISSubsystem::AllLoadedItemsByTag;
 TArray<FGameplayTag> URISSubsystem::AllItemIds;
 TArray<UObjectRecipeData*> URISSubsystem::AllLoadedRecipes;
+TArray<FRISRecipeRegistryEntry> URISSubsystem::RecipeRegistry;
+TMap<FPrimaryAssetId, int32> URISSubsystem::RecipeHandlesById;
+TArray<FGameplayTag> URISSubsystem::RecipeIngredientIds;
+TArray<int32> URISSubsystem::RecipeIngredientQuantities;
+URISSubsystem::FOnRecipeReregistered URISSubsystem::OnRecipeReregistered;
 
 URISSubsystem::URISSubsystem()
 {
@@ -265,10 +270,18 @@ void URISSubsystem::AllRecipesLoadedCallback()
 		TArray<UObject*> LoadedAssets;
 		if (AssetManager->GetPrimaryAssetObjectList(FPrimaryAssetType(RancInventoryRecipeDataType), LoadedAssets))
 		{
+			// Register in a deterministic order so handles match between machines running the same content
+			LoadedAssets.Sort([](const UObject& A, const UObject& B)
+			{
+				return PrimaryAssetIdLexicalLess(A.GetPrimaryAssetId(), B.GetPrimaryAssetId());
+			});
+			
 			for (UObject* const& Iterator : LoadedAssets)
 			{
 				UObjectRecipeData* const CastedAsset = Cast<UObjectRecipeData>(Iterator);
-				AllLoadedRecipes.Add(CastedAsset);
+				if (!CastedAsset) continue;
+				
+				RegisterRecipe(CastedAsset);
 				LoadedRecipesHeldRefs.Add(CastedAsset);
 			}
 		}
@@ -299,9 +312,232 @@ void URISSubsystem::HardcodeRecipe(FGameplayTag RecipeId, UObjectRecipeData* Rec
 		return;
 	}
 
-	AllLoadedRecipes.Add(RecipeData);
+	RegisterRecipe(RecipeData);
+}
+
+FRISRecipeHandle URISSubsystem::RegisterRecipe(UObjectRecipeData* Recipe)
+{
+	const FPrimaryAssetId RecipeId = Recipe->GetPrimaryAssetId();
+	const int32 NumIngredients = Recipe->Components.Num();
+	int32 Index;
+	bool bReuseIngredientRange = false;
+	const int32* ExistingIndex = RecipeHandlesById.Find(RecipeId);
+	const bool bReregistered = ExistingIndex != nullptr;
+	if (ExistingIndex)
+	{
+		Index = *ExistingIndex;
+		AllLoadedRecipes[Index] = Recipe;
+
+		// A replaced recipe with as many ingredients is written over its old range, otherwise the range is removed
+		// and the ranges behind it are moved down so re-registering recipes does not grow the arrays
+		const FRISRecipeRegistryEntry& OldEntry = RecipeRegistry[Index];
+		bReuseIngredientRange = OldEntry.NumIngredients == NumIngredients;
+		if (!bReuseIngredientRange)
+		{
+			const int32 OldFirst = OldEntry.FirstIngredient;
+			const int32 OldNum = OldEntry.NumIngredients;
+			RecipeIngredientIds.RemoveAt(OldFirst, OldNum, EAllowShrinking::No);
+			RecipeIngredientQuantities.RemoveAt(OldFirst, OldNum, EAllowShrinking::No);
+			for (FRISRecipeRegistryEntry& Other : RecipeRegistry)
+			{
+				if (Other.FirstIngredient > OldFirst)
+					Other.FirstIngredient -= OldNum;
+			}
+		}
+	}
+	else
+	{
+		Index = AllLoadedRecipes.Add(Recipe);
+		RecipeRegistry.AddDefaulted();
+		RecipeHandlesById.Add(RecipeId, Index);
+	}
+
+	FRISRecipeRegistryEntry& Entry = RecipeRegistry[Index];
+	Entry.RecipeId = RecipeId;
+	Entry.NumIngredients = NumIngredients;
+	if (!bReuseIngredientRange)
+	{
+		Entry.FirstIngredient = RecipeIngredientIds.Num();
+		RecipeIngredientIds.AddDefaulted(NumIngredients);
+		RecipeIngredientQuantities.AddDefaulted(NumIngredients);
+	}
+	for (int32 i = 0; i < NumIngredients; ++i)
+	{
+		RecipeIngredientIds[Entry.FirstIngredient + i] = Recipe->Components[i].ItemId;
+		RecipeIngredientQuantities[Entry.FirstIngredient + i] = Recipe->Components[i].Quantity;
+	}
+
+	if (bReregistered)
+		OnRecipeReregistered.Broadcast(FRISRecipeHandle(Index));
+
+	return FRISRecipeHandle(Index);
+}
+
+FRISRecipeHandle URISSubsystem::ResolveRecipeHandle(const FPrimaryAssetId& RecipeId)
+{
+	if (const int32* Index = RecipeHandlesById.Find(RecipeId))
+		return FRISRecipeHandle(*Index);
+
+	// Not loaded through the subsystem, e.g. loaded on demand by game code
+	if (UAssetManager* const AssetManager = UAssetManager::GetIfInitialized())
+	{
+		if (UObjectRecipeData* Recipe = Cast<UObjectRecipeData>(AssetManager->GetPrimaryAssetObject(RecipeId)))
+		{
+			return RegisterRecipe(Recipe);
+		}
+	}
+
+	return FRISRecipeHandle();
+}
+
+UObjectRecipeData* URISSubsystem::GetRecipeDataById(const FPrimaryRISRecipeId& RecipeId)
+{
+	return GetRecipeByHandle(ResolveRecipeHandle(RecipeId));
+}
+
+UObjectRecipeData* URISSubsystem::GetRecipeByHandle(FRISRecipeHandle Handle)
+{
+	return AllLoadedRecipes.IsValidIndex(Handle.Index) ? AllLoadedRecipes[Handle.Index] : nullptr;
+}
+
+const FPrimaryAssetId& URISSubsystem::GetRecipeIdByHandle(FRISRecipeHandle Handle)
+{
+	static const FPrimaryAssetId InvalidId;
+	return RecipeRegistry.IsValidIndex(Handle.Index) ? RecipeRegistry[Handle.Index].RecipeId : InvalidId;
+}
+
+TConstArrayView<FGameplayTag> URISSubsystem::GetRecipeIngredientIds(FRISRecipeHandle Handle)
+{
+	if (!RecipeRegistry.IsValidIndex(Handle.Index)) return {};
+	
+	const FRISRecipeRegistryEntry& Entry = RecipeRegistry[Handle.Index];
+	return MakeArrayView(RecipeIngredientIds.GetData() + Entry.FirstIngredient, Entry.NumIngredients);
+}
+
+TConstArrayView<int32> URISSubsystem::GetRecipeIngredientQuantities(FRISRecipeHandle Handle)
+{
+	if (!RecipeRegistry.IsValidIndex(Handle.Index)) return {};
+	
+	const FRISRecipeRegistryEntry& Entry = RecipeRegistry[Handle.Index];
+	return MakeArrayView(RecipeIngredientQuantities.GetData() + Entry.FirstIngredient, Entry.NumIngredients);
+}
+
+
+FRISCompiledLootTable URISSubsystem::CompileLootTable(const FRandomItemPool& Pool)
+{
+	FRISCompiledLootTable Table;
+
+	TArray<float> Weights;
+	float TotalWeight = 0.f;
+	for (int32 i = 0; i < Pool.Items.Num(); ++i)
+	{
+		const float Weight = Pool.ItemWeights.IsValidIndex(i) ? Pool.ItemWeights[i] : 1.f;
+		if (Weight <= 0.f || !Pool.Items[i].ItemData) continue;
+
+		Table.Selections.Add(Pool.Items[i]);
+		Weights.Add(Weight);
+		TotalWeight += Weight;
+	}
+
+	const int32 Num = Table.Selections.Num();
+	if (Num == 0)
+	{
+		UE_LOG(LogRancInventorySystem, Warning, TEXT("CompileLootTable: Pool %s has no selectable items"), *Pool.Description.ToString());
+		return Table;
+	}
+
+	// Vose's alias method, scaled weights average 1 so every column is filled up to 1 by at most one alias
+	Table.Probability.SetNumUninitialized(Num);
+	Table.Alias.SetNumUninitialized(Num);
+	TArray<int32> Small, Large;
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Table.Probability[i] = Weights[i] * Num / TotalWeight;
+		Table.Alias[i] = i;
+		(Table.Probability[i] < 1.f ? Small : Large).Add(i);
+	}
+
+	while (!Small.IsEmpty() && !Large.IsEmpty())
+	{
+		const int32 Less = Small.Pop();
+		const int32 More = Large.Last();
+		Table.Alias[Less] = More;
+		Table.Probability[More] -= 1.f - Table.Probability[Less];
+		if (Table.Probability[More] < 1.f)
+		{
+			Large.Pop();
+			Small.Add(More);
+		}
+	}
+
+	// Whatever is left is 1 up to float rounding
+	for (const int32 i : Small) Table.Probability[i] = 1.f;
+	for (const int32 i : Large) Table.Probability[i] = 1.f;
+
+	return Table;
+}
+
+static int32 RollLootDice(const FRandomItemSelection& Selection, FRandomStream& Stream)
+{
+	const int32 Low = Selection.DiceHas0 ? 0 : 1;
+	const int32 High = Selection.DiceHas0 ? Selection.DiceSides - 1 : Selection.DiceSides;
+	if (High < Low) return 0;
+
+	int32 Total = 0;
+	for (int32 i = 0; i < Selection.DiceCount; ++i)
+	{
+		Total += Stream.RandRange(Low, High);
+	}
+	return Total;
+}
+
+void URISSubsystem::RollLootTable(const FRISCompiledLootTable& Table, int32 Rolls, FRandomStream& Stream, TArray<FItemBundle>& OutLoot)
+{
+	OutLoot.Reset();
+	if (!Table.IsValid() || Rolls <= 0) return;
+
+	// Accumulate per selection so each roll is O(1), then merge selections sharing an item
+	const int32 Num = Table.Selections.Num();
+	TArray<int32, TInlineAllocator<32>> QuantityPerSelection;
+	QuantityPerSelection.SetNumZeroed(Num);
+	for (int32 Roll = 0; Roll < Rolls; ++Roll)
+	{
+		const int32 Column = Stream.RandHelper(Num);
+		const int32 Picked = Stream.GetFraction() < Table.Probability[Column] ? Column : Table.Alias[Column];
+		QuantityPerSelection[Picked] += RollLootDice(Table.Selections[Picked], Stream);
+	}
+
+	for (int32 i = 0; i < Num; ++i)
+	{
+		if (QuantityPerSelection[i] <= 0) continue;
+
+		const FGameplayTag& ItemId = Table.Selections[i].ItemData->ItemId;
+		if (FItemBundle* Existing = OutLoot.FindByPredicate([&ItemId](const FItemBundle& Bundle) { return Bundle.ItemId == ItemId; }))
+			Existing->Quantity += QuantityPerSelection[i];
+		else
+			OutLoot.Add(FItemBundle(ItemId, QuantityPerSelection[i]));
+	}
+}
+
+int32 URISSubsystem::GenerateLootIntoContainer_IfServer(const FRISCompiledLootTable& Table, int32 Rolls, UItemContainerComponent* Target, int32 Seed)
+{
+	FRandomStream Stream(Seed);
+	return GenerateLootIntoContainerWithStream_IfServer(Table, Rolls, Target, Stream);
 }
 
+int32 URISSubsystem::GenerateLootIntoContainerWithStream_IfServer(const FRISCompiledLootTable& Table, int32 Rolls, UItemContainerComponent* Target, FRandomStream& Stream)
+{
+	if (!Target)
+	{
+		UE_LOG(LogRancInventorySystem, Warning, TEXT("GenerateLootIntoContainer: Target is null"));
+		return 0;
+	}
+
+	TArray<FItemBundle> Loot;
+	RollLootTable(Table, Rolls, Stream, Loot);
+
+	return Target->AddItems_IfServer(this, Loot, true);
+}
 
 void URISSubsystem::PermanentlyLoadAllRecipesAsync()
 {
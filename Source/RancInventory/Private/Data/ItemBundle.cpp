@@ -246,7 +246,7 @@ int32 FTaggedItemBundle::Extract(int32 InQuantity, const TArray<UItemInstanceDat
 	return ExtractQuantityImpl(Quantity, InstanceData, InQuantity, SpecificInstancesToExtract, StateArrayToAppendTo, Owner, bAllowPartial);
 }
 
-TArray<int32> FItemBundle::ToInstanceIds(const TArray<UItemInstanceData*> Instances)
+TArray<int32> FItemBundle::ToInstanceIds(const TArray<UItemInstanceData*>& Instances)
 {
 	TArray<int32> InstanceIds;
 	InstanceIds.Reserve(Instances.Num());
@@ -277,7 +277,7 @@ TArray<UItemInstanceData*> FromInstanceIdsImpl(const TArray<UItemInstanceData*>&
 }
 
 
-TArray<UItemInstanceData*> FItemBundle::FromInstanceIds(const TArray<int32> InstanceIds) const
+TArray<UItemInstanceData*> FItemBundle::FromInstanceIds(const TArray<int32>& InstanceIds) const
 {
 	return FromInstanceIdsImpl(InstanceData, InstanceIds);
 }
@@ -308,6 +308,16 @@ TArray<UItemInstanceData*> FTaggedItemBundle::FromInstanceIds(const TArray<int32
 	return FromInstanceIdsImpl(InstanceData, InstanceIds);
 }
 
+bool FGenericItemBundle::Contains(int32 QuantityToCheck, const TArray<UItemInstanceData*>& InstancesToCheck) const
+{
+	return Instances && ContainsImpl(*Quantity, *Instances, QuantityToCheck, InstancesToCheck);
+}
+
+TArray<UItemInstanceData*> FGenericItemBundle::FromInstanceIds(const TArray<int32>& Ids) const
+{
+	return Instances ? FromInstanceIdsImpl(*Instances, Ids) : TArray<UItemInstanceData*>();
+}
+
 FItemBundle::FItemBundle(FGameplayTag InItemId, int32 InQuantity)
 {
 	ItemId = InItemId;
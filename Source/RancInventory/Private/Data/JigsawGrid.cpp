@@ -0,0 +1,245 @@
+// Copyright Rancorous Games, 2024
+
+#include "Data/JigsawGrid.h"
+#include "LogRancInventorySystem.h"
+#include "Algo/StableSort.h"
+
+void FRISJigsawGrid::Init(int32 InWidth, int32 InHeight, int32 InNumCells)
+{
+	ensureMsgf(InWidth <= MaxWidth, TEXT("Jigsaw grids are limited to %d columns, got %d"), MaxWidth, InWidth);
+	Width = FMath::Clamp(InWidth, 0, MaxWidth);
+	Height = FMath::Max(InHeight, 0);
+	NumCells = FMath::Max(InNumCells, 0);
+	Reset();
+}
+
+void FRISJigsawGrid::Reset()
+{
+	Rows.Init(0, Height);
+	Placements.Reset();
+
+	// Cells past NumCells are marked occupied without a placement so nothing is ever placed on them
+	const int32 UsableCells = GetNumCells();
+	for (int32 Y = UsableCells / FMath::Max(Width, 1); Y < Height; ++Y)
+	{
+		Rows[Y] = GetColumnMask(0, Width) & ~GetColumnMask(0, FMath::Max(UsableCells - Y * Width, 0));
+	}
+}
+
+int32 FRISJigsawGrid::GetNumFreeCells() const
+{
+	int32 OccupiedCells = 0;
+	for (const uint64 Row : Rows)
+	{
+		OccupiedCells += FMath::CountBits(Row);
+	}
+	return Width * Height - OccupiedCells;
+}
+
+uint64 FRISJigsawGrid::GetColumnMask(int32 X, int32 SizeX) const
+{
+	const uint64 Bits = SizeX >= 64 ? ~0ull : (1ull << SizeX) - 1;
+	return Bits << X;
+}
+
+bool FRISJigsawGrid::IsCellOccupied(const FIntPoint& Cell) const
+{
+	if (Cell.X < 0 || Cell.Y < 0 || Cell.X >= Width || Cell.Y >= Height) return true;
+	return (Rows[Cell.Y] >> Cell.X) & 1ull;
+}
+
+bool FRISJigsawGrid::CanPlaceAt(const FIntPoint& Position, const FIntPoint& Size) const
+{
+	if (Size.X <= 0 || Size.Y <= 0 || Position.X < 0 || Position.Y < 0) return false;
+	if (Position.X + Size.X > Width || Position.Y + Size.Y > Height) return false;
+
+	const uint64 Mask = GetColumnMask(Position.X, Size.X);
+	for (int32 Y = Position.Y; Y < Position.Y + Size.Y; ++Y)
+	{
+		if (Rows[Y] & Mask) return false;
+	}
+	return true;
+}
+
+bool FRISJigsawGrid::FindFitUnrotated(const FIntPoint& Size, FIntPoint& OutPosition) const
+{
+	if (Size.X <= 0 || Size.Y <= 0 || Size.X > Width || Size.Y > Height) return false;
+
+	const uint64 WidthMask = GetColumnMask(0, Width);
+
+	// Per row, set bits mark the columns where a run of Size.X free cells starts
+	TArray<uint64, TInlineAllocator<32>> RunStarts;
+	RunStarts.SetNumUninitialized(Height);
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		const uint64 Free = ~Rows[Y] & WidthMask;
+		uint64 Starts = Free;
+		for (int32 Shift = 1; Shift < Size.X && Starts; ++Shift)
+		{
+			Starts &= Free >> Shift;
+		}
+		RunStarts[Y] = Starts;
+	}
+
+	for (int32 Y = 0; Y + Size.Y <= Height; ++Y)
+	{
+		uint64 Candidates = RunStarts[Y];
+		for (int32 Row = Y + 1; Row < Y + Size.Y && Candidates; ++Row)
+		{
+			Candidates &= RunStarts[Row];
+		}
+
+		if (Candidates)
+		{
+			OutPosition = FIntPoint(FMath::CountTrailingZeros64(Candidates), Y);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FRISJigsawGrid::FindFit(const FIntPoint& ItemSize, bool AllowRotation, FIntPoint& OutPosition, bool& OutRotated) const
+{
+	FIntPoint Position;
+	const bool Fits = FindFitUnrotated(ItemSize, Position);
+
+	FIntPoint RotatedPosition;
+	const bool CanRotate = AllowRotation && ItemSize.X != ItemSize.Y;
+	const bool RotatedFits = CanRotate && FindFitUnrotated(FIntPoint(ItemSize.Y, ItemSize.X), RotatedPosition);
+
+	// Prefer whichever fit comes first in row-major order, the unrotated one on ties
+	if (RotatedFits && (!Fits || RotatedPosition.Y < Position.Y || (RotatedPosition.Y == Position.Y && RotatedPosition.X < Position.X)))
+	{
+		OutPosition = RotatedPosition;
+		OutRotated = true;
+		return true;
+	}
+
+	OutPosition = Position;
+	OutRotated = false;
+	return Fits;
+}
+
+void FRISJigsawGrid::SetCells(const FIntPoint& Position, const FIntPoint& Size, bool Occupied)
+{
+	const uint64 Mask = GetColumnMask(Position.X, Size.X);
+	for (int32 Y = Position.Y; Y < Position.Y + Size.Y; ++Y)
+	{
+		Rows[Y] = Occupied ? Rows[Y] | Mask : Rows[Y] & ~Mask;
+	}
+}
+
+int32 FRISJigsawGrid::Place(const FGameplayTag& ItemId, const FIntPoint& Position, const FIntPoint& ItemSize, bool Rotated)
+{
+	const FIntPoint Size = Rotated ? FIntPoint(ItemSize.Y, ItemSize.X) : ItemSize;
+	if (!CanPlaceAt(Position, Size)) return INDEX_NONE;
+
+	SetCells(Position, Size, true);
+
+	FRISJigsawPlacement& Placement = Placements.AddDefaulted_GetRef();
+	Placement.ItemId = ItemId;
+	Placement.Position = Position;
+	Placement.Size = Size;
+	Placement.Rotated = Rotated;
+	return Placements.Num() - 1;
+}
+
+int32 FRISJigsawGrid::PlaceAnywhere(const FGameplayTag& ItemId, const FIntPoint& ItemSize, bool AllowRotation)
+{
+	FIntPoint Position;
+	bool Rotated;
+	if (!FindFit(ItemSize, AllowRotation, Position, Rotated)) return INDEX_NONE;
+
+	return Place(ItemId, Position, ItemSize, Rotated);
+}
+
+void FRISJigsawGrid::RemovePlacement(int32 PlacementIndex)
+{
+	if (!Placements.IsValidIndex(PlacementIndex)) return;
+
+	SetCells(Placements[PlacementIndex].Position, Placements[PlacementIndex].Size, false);
+	Placements.RemoveAt(PlacementIndex);
+}
+
+int32 FRISJigsawGrid::FindPlacementAt(const FIntPoint& Position) const
+{
+	return Placements.IndexOfByPredicate([&Position](const FRISJigsawPlacement& Placement) { return Placement.Position == Position; });
+}
+
+int32 FRISJigsawGrid::FindPlacementCoveringCell(const FIntPoint& Cell) const
+{
+	if (!IsCellOccupied(Cell)) return INDEX_NONE;
+
+	return Placements.IndexOfByPredicate([&Cell](const FRISJigsawPlacement& Placement)
+	{
+		return Cell.X >= Placement.Position.X && Cell.X < Placement.Position.X + Placement.Size.X &&
+			Cell.Y >= Placement.Position.Y && Cell.Y < Placement.Position.Y + Placement.Size.Y;
+	});
+}
+
+int32 FRISJigsawGrid::CountFits(const FIntPoint& ItemSize, bool AllowRotation, int32 MaxCount) const
+{
+	const int32 ItemArea = ItemSize.X * ItemSize.Y;
+	if (ItemArea <= 0 || MaxCount <= 0) return 0;
+
+	// Placing on a copy of the occupancy keeps the count consistent with how items are actually placed
+	FRISJigsawGrid Scratch;
+	Scratch.Width = Width;
+	Scratch.Height = Height;
+	Scratch.Rows = Rows;
+
+	const int32 MaxByArea = GetNumFreeCells() / ItemArea;
+	int32 Count = 0;
+	while (Count < MaxCount && Count < MaxByArea)
+	{
+		FIntPoint Position;
+		bool Rotated;
+		if (!Scratch.FindFit(ItemSize, AllowRotation, Position, Rotated)) break;
+
+		Scratch.SetCells(Position, Rotated ? FIntPoint(ItemSize.Y, ItemSize.X) : ItemSize, true);
+		++Count;
+	}
+	return Count;
+}
+
+bool FRISJigsawGrid::AutoArrange(bool AllowRotation, TArray<int32>* OutPreviousIndices)
+{
+	TArray<FRISJigsawPlacement> Previous = Placements;
+
+	TArray<int32> Order;
+	Order.Reserve(Previous.Num());
+	for (int32 i = 0; i < Previous.Num(); ++i)
+	{
+		Order.Add(i);
+	}
+	Algo::StableSort(Order, [&Previous](int32 IndexA, int32 IndexB)
+	{
+		const FIntPoint& A = Previous[IndexA].Size;
+		const FIntPoint& B = Previous[IndexB].Size;
+		if (A.X * A.Y != B.X * B.Y) return A.X * A.Y > B.X * B.Y;
+		return FMath::Max(A.X, A.Y) > FMath::Max(B.X, B.Y);
+	});
+
+	Reset();
+	for (const int32 PreviousIndex : Order)
+	{
+		const FRISJigsawPlacement& Item = Previous[PreviousIndex];
+		// Placements store the rotated size, rotate back to the item size before searching
+		const FIntPoint ItemSize = Item.Rotated ? FIntPoint(Item.Size.Y, Item.Size.X) : Item.Size;
+		if (PlaceAnywhere(Item.ItemId, ItemSize, AllowRotation) == INDEX_NONE)
+		{
+			Reset();
+			for (const FRISJigsawPlacement& Old : Previous)
+			{
+				SetCells(Old.Position, Old.Size, true);
+			}
+			Placements = MoveTemp(Previous);
+			UE_LOG(LogRancInventorySystem, Verbose, TEXT("FRISJigsawGrid::AutoArrange: Could not re-place %s, layout left unchanged."), *Item.ItemId.ToString());
+			return false;
+		}
+	}
+
+	if (OutPreviousIndices)
+		*OutPreviousIndices = MoveTemp(Order);
+	return true;
+}
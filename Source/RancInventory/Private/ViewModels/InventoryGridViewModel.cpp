@@ -8,10 +8,20 @@
 #include "LogRancInventorySystem.h"
 #include "Data/UsableItemDefinition.h"
 #include "Actors/WorldItem.h" // Added include
+#include "Algo/BinarySearch.h"
+#include "Algo/StableSort.h"
 
 // Define the static dummy member
 FItemBundle UInventoryGridViewModel::DummyEmptyBundle = FItemBundle();
 
+namespace
+{
+    FIntPoint JigsawSizeOf(const UItemStaticData* ItemData)
+    {
+        return ItemData ? FIntPoint(FMath::Max(ItemData->JigsawSizeX, 1), FMath::Max(ItemData->JigsawSizeY, 1)) : FIntPoint(1, 1);
+    }
+}
+
 // --- Initialization and Lifecycle ---
 
 void UInventoryGridViewModel::Initialize_Implementation(UItemContainerComponent* ContainerComponent)
@@ -40,7 +50,10 @@ void UInventoryGridViewModel::Initialize_Implementation(UItemContainerComponent*
     LinkedInventoryComponent = Cast<UInventoryComponent>(ContainerComponent); // Attempt cast
 
     NumberOfGridSlots = LinkedContainerComponent->MaxSlotCount;
-    ViewableGridSlots.Init(FItemBundle::EmptyItemInstance, NumberOfGridSlots);
+    GridSlotRecords.Init(FRISGridSlotRecord(), NumberOfGridSlots);
+    GridInstanceLists.Reset();
+    FreeGridInstanceLists.Reset();
+    RebuildGridSlotIndex();
     OperationsToConfirm.Empty();
 
     // Subscribe to BASE container events
@@ -104,30 +117,29 @@ void UInventoryGridViewModel::BeginDestroy()
 
 bool UInventoryGridViewModel::IsGridSlotEmpty(int32 SlotIndex) const
 {
-    return !ViewableGridSlots.IsValidIndex(SlotIndex) || !ViewableGridSlots[SlotIndex].IsValid();
+    return !GridSlotRecords.IsValidIndex(SlotIndex) || GridSlotRecords[SlotIndex].ItemHandle == INDEX_NONE;
 }
 
 FItemBundle UInventoryGridViewModel::GetGridItem(int32 SlotIndex) const
 {
-    if (ViewableGridSlots.IsValidIndex(SlotIndex))
-    {
-        return ViewableGridSlots[SlotIndex];
-    }
-    return FItemBundle::EmptyItemInstance;
+    return BuildGridItem(SlotIndex);
 }
 
 int32 UInventoryGridViewModel::DropItem(FGameplayTag SourceTaggedSlot, int32 SourceSlotIndex, int32 Quantity)
 {
     if (!LinkedContainerComponent || Quantity <= 0) return 0;
 
-    const bool bSourceIsGrid = !SourceTaggedSlot.IsValid() && ViewableGridSlots.IsValidIndex(SourceSlotIndex);
+    const bool bSourceIsGrid = !SourceTaggedSlot.IsValid() && GridSlotRecords.IsValidIndex(SourceSlotIndex);
     const bool bSourceIsTag = SourceTaggedSlot.IsValid();
 
+    // Grid slots are edited through a built copy that is written back with SetGridItem
+    FItemBundle GridItem;
     FItemBundle* SourceItemPtr = nullptr;
     ERISSlotOperation ExpectedOperationType;
 
     if (bSourceIsGrid) {
-        SourceItemPtr = &ViewableGridSlots[SourceSlotIndex];
+        GridItem = BuildGridItem(SourceSlotIndex);
+        SourceItemPtr = &GridItem;
         ExpectedOperationType = ERISSlotOperation::Remove;
     } else if (bSourceIsTag) {
         if (!LinkedInventoryComponent) return 0;
@@ -170,7 +182,9 @@ int32 UInventoryGridViewModel::DropItem(FGameplayTag SourceTaggedSlot, int32 Sou
             SourceItem = FItemBundle::EmptyItemInstance;
         }
 
-        if (bSourceIsGrid) OnGridSlotUpdated.Broadcast(SourceSlotIndex, InstancesToDrop);
+        if (bSourceIsGrid) SetGridItem(SourceSlotIndex, SourceItem);
+
+        if (bSourceIsGrid) BroadcastGridSlotUpdated(SourceSlotIndex, InstancesToDrop);
         else OnTaggedSlotUpdated.Broadcast(SourceTaggedSlot, InstancesToDrop);
     }
     else
@@ -193,17 +207,17 @@ int32 UInventoryGridViewModel::DropItem(FGameplayTag SourceTaggedSlot, int32 Sou
 bool UInventoryGridViewModel::CanGridSlotReceiveItem_Implementation(const FGameplayTag& ItemId, int32 Quantity, int32 SlotIndex) const
 {
     // Implementation moved from UContainerGridViewModel::CanGridSlotReceiveItem_Implementation
-    if (!ViewableGridSlots.IsValidIndex(SlotIndex) || Quantity <= 0 || !ItemId.IsValid())
+    if (!GridSlotRecords.IsValidIndex(SlotIndex) || Quantity <= 0 || !ItemId.IsValid())
     {
         return false;
     }
 
     if (!LinkedContainerComponent || !LinkedContainerComponent->CanReceiveItem(ItemId, Quantity)) return false;
 
-    const FItemBundle& TargetSlotItem = ViewableGridSlots[SlotIndex];
-    const bool TargetSlotEmpty = !TargetSlotItem.IsValid();
+    const FRISGridSlotRecord& TargetSlotItem = GridSlotRecords[SlotIndex];
+    const bool TargetSlotEmpty = TargetSlotItem.ItemHandle == INDEX_NONE;
 
-    if (TargetSlotEmpty || TargetSlotItem.ItemId == ItemId)
+    if (TargetSlotEmpty || GridItemIds[TargetSlotItem.ItemHandle] == ItemId)
     {
         const UItemStaticData* ItemData = URISSubsystem::GetItemDataById(ItemId);
         if (!ItemData)
@@ -211,6 +225,11 @@ bool UInventoryGridViewModel::CanGridSlotReceiveItem_Implementation(const FGamep
             return false;
         }
 
+        if (TargetSlotEmpty && !CanJigsawItemFitAtSlot(ItemId, SlotIndex))
+        {
+            return false;
+        }
+
         const int32 AvailableSpace = ItemData->MaxStackSize > 1 ? ItemData->MaxStackSize - TargetSlotItem.Quantity : TargetSlotEmpty ? 1 : 0;
         return AvailableSpace >= Quantity;
     }
@@ -267,14 +286,16 @@ int32 UInventoryGridViewModel::UseItem(FGameplayTag SourceTaggedSlot, int32 Sour
 {
     if (!LinkedContainerComponent) return 0;
 
-    const bool bSourceIsGrid = !SourceTaggedSlot.IsValid() && ViewableGridSlots.IsValidIndex(SourceSlotIndex);
+    const bool bSourceIsGrid = !SourceTaggedSlot.IsValid() && GridSlotRecords.IsValidIndex(SourceSlotIndex);
     const bool bSourceIsTag = SourceTaggedSlot.IsValid();
 
+    FItemBundle GridItem;
     FItemBundle* SourceItemPtr = nullptr;
     ERISSlotOperation ExpectedOperationType;
 
     if (bSourceIsGrid) {
-        SourceItemPtr = &ViewableGridSlots[SourceSlotIndex];
+        GridItem = BuildGridItem(SourceSlotIndex);
+        SourceItemPtr = &GridItem;
         ExpectedOperationType = ERISSlotOperation::Remove;
     } else if (bSourceIsTag) {
         if (!LinkedInventoryComponent) return 0;
@@ -344,9 +365,11 @@ int32 UInventoryGridViewModel::UseItem(FGameplayTag SourceTaggedSlot, int32 Sour
             if (SourceItem.Quantity <= 0 && QuantityToConsume > 0) { // Double check if consumed item made quantity zero
                 SourceItem = FItemBundle::EmptyItemInstance;
             }
+            if (bSourceIsGrid) SetGridItem(SourceSlotIndex, SourceItem);
         } else { // Server rejected consumption or consumed 0 when we expected >0
             // Revert predictive changes if server consumed 0 but we predicted >0
             SourceItem = OriginalSourceItemForOpConfirm; // Restore original state
+            if (bSourceIsGrid) SetGridItem(SourceSlotIndex, SourceItem);
             for (int32 i = OperationsToConfirm.Num() - 1; i >= 0; --i) { // Remove the pending op
                  const FRISExpectedOperation& Op = OperationsToConfirm[i];
                  if (Op.Operation == ExpectedOperationType && Op.ItemId == ItemIdToUse && Op.Quantity == QuantityToConsume &&
@@ -364,7 +387,7 @@ int32 UInventoryGridViewModel::UseItem(FGameplayTag SourceTaggedSlot, int32 Sour
         if (InstanceDataToUse)
             InstancesToUpdate.Add(InstanceDataToUse);
         
-        if (bSourceIsGrid) OnGridSlotUpdated.Broadcast(SourceSlotIndex, InstancesToUpdate);
+        if (bSourceIsGrid) BroadcastGridSlotUpdated(SourceSlotIndex, InstancesToUpdate);
         else OnTaggedSlotUpdated.Broadcast(SourceTaggedSlot, InstancesToUpdate);
     }
     // If QuantityToConsume was 0, ActualConsumed should also likely be 0 unless UseItem can return other codes.
@@ -430,20 +453,25 @@ bool UInventoryGridViewModel::MoveItemToAnyTaggedSlot_Implementation(const FGame
     if (!LinkedInventoryComponent) return false; // Requires inventory features
 
     const bool bSourceIsTag = SourceTaggedSlot.IsValid();
-    const bool bSourceIsGrid = !bSourceIsTag && ViewableGridSlots.IsValidIndex(SourceSlotIndex);
+    const bool bSourceIsGrid = !bSourceIsTag && GridSlotRecords.IsValidIndex(SourceSlotIndex);
 
     if (!bSourceIsTag && !bSourceIsGrid) return false;
 
-    FGenericItemBundle SourceItem;
+    FGameplayTag SourceItemId;
+    int32 SourceQuantity = 0;
     if (bSourceIsTag) {
-        SourceItem = &GetMutableItemForTaggedSlotInternal(SourceTaggedSlot); // Use internal helper
+        const FItemBundle& SourceItem = GetMutableItemForTaggedSlotInternal(SourceTaggedSlot); // Use internal helper
+        if (!SourceItem.IsValid()) return false;
+        SourceItemId = SourceItem.ItemId;
+        SourceQuantity = SourceItem.Quantity;
     } else {
-        SourceItem = &ViewableGridSlots[SourceSlotIndex];
+        const FRISGridSlotRecord& SourceRecord = GridSlotRecords[SourceSlotIndex];
+        if (SourceRecord.ItemHandle == INDEX_NONE) return false;
+        SourceItemId = GridItemIds[SourceRecord.ItemHandle];
+        SourceQuantity = SourceRecord.Quantity;
     }
 
-    if (!SourceItem.IsValid()) return false;
-
-    const FGameplayTag TargetSlotTag = FindTaggedSlotForItem(SourceItem.GetItemId(), SourceItem.GetQuantity(), EPreferredSlotPolicy::PreferSpecializedTaggedSlot);
+    const FGameplayTag TargetSlotTag = FindTaggedSlotForItem(SourceItemId, SourceQuantity, EPreferredSlotPolicy::PreferSpecializedTaggedSlot);
 
     if (!TargetSlotTag.IsValid()) {
         return false;
@@ -530,14 +558,15 @@ bool UInventoryGridViewModel::MoveItemToOtherViewModel(
     }
     else // Source is Grid
     {
-        this->ViewableGridSlots[SourceSlotIndex].Quantity -= QuantityToMove;
-        if (this->ViewableGridSlots[SourceSlotIndex].Quantity <= 0)
+        SourceItemCopy.Quantity -= QuantityToMove;
+        if (SourceItemCopy.Quantity <= 0)
         {
-             this->ViewableGridSlots[SourceSlotIndex] = FItemBundle::EmptyItemInstance;
+             SourceItemCopy = FItemBundle::EmptyItemInstance;
         } else if (!InstancesToMove.IsEmpty()) {
-             this->ViewableGridSlots[SourceSlotIndex].InstanceData.RemoveAll([&InstancesToMove](UItemInstanceData* Inst){ return InstancesToMove.Contains(Inst); });
+             SourceItemCopy.InstanceData.RemoveAll([&InstancesToMove](UItemInstanceData* Inst){ return InstancesToMove.Contains(Inst); });
         }
-        this->OnGridSlotUpdated.Broadcast(SourceSlotIndex, InstancesToMove);
+        this->SetGridItem(SourceSlotIndex, SourceItemCopy);
+        BroadcastGridSlotUpdated(SourceSlotIndex, InstancesToMove);
     }
 
     if (bTargetIsTag)
@@ -554,13 +583,15 @@ bool UInventoryGridViewModel::MoveItemToOtherViewModel(
     }
     else // Target is Grid
     {
-        TArray<UItemInstanceData*> OldTargetInstances = TargetViewModel->ViewableGridSlots[TargetGridSlotIndex].InstanceData;
-        TargetViewModel->ViewableGridSlots[TargetGridSlotIndex].Quantity += QuantityToMove;
-        if (TargetViewModel->ViewableGridSlots[TargetGridSlotIndex].ItemId != ItemIdToMove)
+        FItemBundle TargetItem = TargetViewModel->BuildGridItem(TargetGridSlotIndex);
+        TArray<UItemInstanceData*> OldTargetInstances = TargetItem.InstanceData;
+        TargetItem.Quantity += QuantityToMove;
+        if (TargetItem.ItemId != ItemIdToMove)
         {
-            TargetViewModel->ViewableGridSlots[TargetGridSlotIndex] = FItemBundle(ItemIdToMove, QuantityToMove, InstancesToMove);
+            TargetItem = FItemBundle(ItemIdToMove, QuantityToMove, InstancesToMove);
         }
-        TargetViewModel->OnGridSlotUpdated.Broadcast(TargetGridSlotIndex, OldTargetInstances);
+        TargetViewModel->SetGridItem(TargetGridSlotIndex, TargetItem);
+        TargetViewModel->BroadcastGridSlotUpdated(TargetGridSlotIndex, OldTargetInstances);
     }
 
     ERISSlotOperation RemoveOp = bSourceIsTag ? RemoveTagged : Remove;
@@ -613,14 +644,15 @@ void UInventoryGridViewModel::PickupItem(AWorldItem* WorldItem, EPreferredSlotPo
              // Find first available grid slot visually and add there
              int32 TargetSlot = FindGridSlotIndexForItem(ItemToPickup.ItemId, AddedQty);
              if (TargetSlot != -1) {
-                 FItemBundle& Slot = ViewableGridSlots[TargetSlot];
-                 if (!Slot.IsValid()) {
-                     Slot.ItemId = ItemToPickup.ItemId;
+                 FRISGridSlotRecord& Slot = GridSlotRecords[TargetSlot];
+                 const FRISGridSlotRecord OldSlot = Slot;
+                 if (Slot.ItemHandle == INDEX_NONE) {
+                     Slot.ItemHandle = GetGridItemHandle(ItemToPickup.ItemId); // Assume instances are handled by HandleItemAdded later
                      Slot.Quantity = 0;
-                     Slot.InstanceData = TArray<UItemInstanceData*>(); // Assume instances are handled by HandleItemAdded later
                  }
                  Slot.Quantity += AddedQty;
-                 OnGridSlotUpdated.Broadcast(TargetSlot, FItemBundle::NoInstances);
+                 CommitGridSlot(TargetSlot, OldSlot);
+                 BroadcastGridSlotUpdated(TargetSlot, FItemBundle::NoInstances);
              }
              // If server interaction succeeded, and DestroyAfterPickup is true, destroy the world item.
              if (DestroyAfterPickup && WorldItem && WorldItem->GetQuantityTotal_Implementation(ItemToPickup.ItemId) <= 0) // Check if source is empty
@@ -662,6 +694,8 @@ bool UInventoryGridViewModel::AssertViewModelSettled() const
         }
     }
 
+    if (bOpsSettled && ChecksumsMatchLinkedComponent()) return true;
+
     bool bQuantitiesMatch = true;
     bool bTaggedConsistency = true;
 
@@ -679,11 +713,11 @@ bool UInventoryGridViewModel::AssertViewModelSettled() const
         }
 
         // Get ViewModel Totals (Grid)
-        for (const FItemBundle& Slot : ViewableGridSlots)
+        for (const FRISGridSlotRecord& Slot : GridSlotRecords)
         {
-            if (Slot.IsValid())
+            if (Slot.ItemHandle != INDEX_NONE)
             {
-                ViewModelTotalQuantities.FindOrAdd(Slot.ItemId) += Slot.Quantity;
+                ViewModelTotalQuantities.FindOrAdd(GridItemIds[Slot.ItemHandle]) += Slot.Quantity;
             }
         }
         // Get ViewModel Totals (Tagged - only if Inventory)
@@ -775,36 +809,551 @@ bool UInventoryGridViewModel::AssertViewModelSettled() const
 }
 
 
+bool UInventoryGridViewModel::ChecksumsMatchLinkedComponent() const
+{
+    if (!LinkedContainerComponent) return false;
+
+    // Tagged slots are few so they are summed here rather than tracked
+    uint64 ViewModelItemsChecksum = GridItemsChecksum;
+    uint64 ViewModelTaggedChecksum = 0;
+    for (const auto& Pair : ViewableTaggedSlots)
+    {
+        if (!Pair.Value.IsValid()) continue;
+        ViewModelItemsChecksum += FRISItemChecksum::Contribution(Pair.Value.ItemId, Pair.Value.Quantity);
+        ViewModelTaggedChecksum += FRISItemChecksum::TaggedContribution(Pair.Key, Pair.Value.ItemId, Pair.Value.Quantity, Pair.Value.InstanceData.Num());
+    }
+
+    if (ViewModelItemsChecksum != LinkedContainerComponent->GetItemsChecksum()) return false;
+    return !LinkedInventoryComponent || ViewModelTaggedChecksum == LinkedInventoryComponent->GetTaggedItemsChecksum();
+}
+
 int32 UInventoryGridViewModel::FindGridSlotIndexForItem_Implementation(const FGameplayTag& ItemId, int32 Quantity)
 {
-    // Implementation moved from UContainerGridViewModel::FindGridSlotIndexForItem_Implementation
     if (!ItemId.IsValid()) return -1;
 
     const UItemStaticData* ItemData = URISSubsystem::GetItemDataById(ItemId);
     if (!ItemData) return -1;
 
-    int32 FirstEmptySlot = -1;
+    // Candidates come from the placement index, a stale candidate is re-indexed and the next one tried.
+    // Re-indexing skips slots outside the grid, so stale candidates are also dropped explicitly or the loops would not end
 
     // Pass 1: Find existing partial stack
     if (ItemData->MaxStackSize > 1) {
-        for (int32 Index = 0; Index < ViewableGridSlots.Num(); ++Index) {
-            const FItemBundle& ExistingItem = ViewableGridSlots[Index];
-            if (ExistingItem.IsValid() && ExistingItem.ItemId == ItemId && ExistingItem.Quantity < ItemData->MaxStackSize) {
-                return Index; // Found first partial stack
+        while (TArray<int32>* Stacks = PartialGridStacks.Find(ItemId)) {
+            const int32 Index = (*Stacks)[0];
+            if (GridSlotRecords.IsValidIndex(Index)) {
+                const FRISGridSlotRecord& Existing = GridSlotRecords[Index];
+                if (Existing.ItemHandle != INDEX_NONE && GridItemIds[Existing.ItemHandle] == ItemId && Existing.Quantity < ItemData->MaxStackSize) {
+                    return Index; // Found first partial stack
+                }
+                UpdateGridSlotIndex(Index, Existing.ItemHandle, Existing.Quantity);
+            }
+
+            Stacks = PartialGridStacks.Find(ItemId);
+            if (Stacks && (*Stacks)[0] == Index) {
+                Stacks->RemoveAt(0);
+                if (Stacks->IsEmpty()) PartialGridStacks.Remove(ItemId);
+                if (IndexedPartialStackItems.IsValidIndex(Index)) IndexedPartialStackItems[Index] = FGameplayTag();
             }
         }
     }
 
     // Pass 2: Find first empty slot
-    for (int32 Index = 0; Index < ViewableGridSlots.Num(); ++Index) {
-        if (!ViewableGridSlots[Index].IsValid()) {
-            return Index; // Found first empty slot
+    if (JigsawLayout.GetWidth() > 0) {
+        FIntPoint Position;
+        bool Rotated;
+        if (!JigsawLayout.FindFit(JigsawSizeOf(ItemData), LinkedContainerComponent->JigsawAllowRotation, Position, Rotated)) return -1;
+        return Position.Y * JigsawLayout.GetWidth() + Position.X;
+    }
+
+    for (int32 Index = FreeGridSlots.Find(true); Index != INDEX_NONE; Index = FreeGridSlots.Find(true)) {
+        if (GridSlotRecords.IsValidIndex(Index)) {
+            const FRISGridSlotRecord& Existing = GridSlotRecords[Index];
+            if (Existing.ItemHandle == INDEX_NONE) {
+                return Index; // Found first empty slot
+            }
+            UpdateGridSlotIndex(Index, Existing.ItemHandle, Existing.Quantity);
         }
+        FreeGridSlots[Index] = false;
     }
 
     return -1; // No suitable slot found
 }
 
+void UInventoryGridViewModel::UpdateGridSlotIndex(int32 SlotIndex, int32 OldHandle, int32 OldQuantity)
+{
+    if (!GridSlotRecords.IsValidIndex(SlotIndex) || !FreeGridSlots.IsValidIndex(SlotIndex)) return;
+
+    const FRISGridSlotRecord& Record = GridSlotRecords[SlotIndex];
+    const bool IsEmpty = Record.ItemHandle == INDEX_NONE;
+    const FGameplayTag ItemId = IsEmpty ? FGameplayTag() : GridItemIds[Record.ItemHandle];
+    FreeGridSlots[SlotIndex] = IsEmpty;
+
+    if (OldHandle != INDEX_NONE)
+        GridItemsChecksum -= FRISItemChecksum::Contribution(GridItemIds[OldHandle], OldQuantity);
+    if (!IsEmpty)
+        GridItemsChecksum += FRISItemChecksum::Contribution(ItemId, Record.Quantity);
+
+    if (OldHandle != Record.ItemHandle)
+    {
+        // Only vacating the first slot of an item scans, for the next slot holding it
+        if (OldHandle != INDEX_NONE && FirstGridSlots[OldHandle] == SlotIndex)
+        {
+            FirstGridSlots[OldHandle] = INDEX_NONE;
+            for (int32 NextSlot = SlotIndex + 1; NextSlot < GridSlotRecords.Num(); ++NextSlot)
+            {
+                if (GridSlotRecords[NextSlot].ItemHandle == OldHandle)
+                {
+                    FirstGridSlots[OldHandle] = NextSlot;
+                    break;
+                }
+            }
+        }
+        if (Record.ItemHandle != INDEX_NONE && (FirstGridSlots[Record.ItemHandle] == INDEX_NONE || SlotIndex < FirstGridSlots[Record.ItemHandle]))
+            FirstGridSlots[Record.ItemHandle] = SlotIndex;
+    }
+
+    const UItemStaticData* ItemData = IsEmpty ? nullptr : URISSubsystem::GetItemDataById(ItemId);
+
+    if (JigsawLayout.GetWidth() > 0)
+    {
+        // A placement of the same item at this anchor is kept as is so it keeps its rotation
+        const FIntPoint Cell = SlotIndexToJigsawCell(SlotIndex);
+        const int32 PlacementIndex = JigsawLayout.FindPlacementAt(Cell);
+        if (PlacementIndex == INDEX_NONE || IsEmpty || JigsawLayout.GetPlacements()[PlacementIndex].ItemId != ItemId)
+        {
+            bool WasRotated = false;
+            if (PlacementIndex != INDEX_NONE)
+            {
+                WasRotated = JigsawLayout.GetPlacements()[PlacementIndex].Rotated;
+                JigsawLayout.RemovePlacement(PlacementIndex);
+            }
+
+            if (!IsEmpty)
+            {
+                const FIntPoint ItemSize = JigsawSizeOf(ItemData);
+                const bool AllowRotation = LinkedContainerComponent && LinkedContainerComponent->JigsawAllowRotation;
+                if (JigsawLayout.Place(ItemId, Cell, ItemSize, WasRotated) == INDEX_NONE &&
+                    (!AllowRotation || JigsawLayout.Place(ItemId, Cell, ItemSize, !WasRotated) == INDEX_NONE))
+                {
+                    UE_LOG(LogRancInventorySystem, Warning, TEXT("UpdateGridSlotIndex: %s in grid slot %d overlaps another jigsaw item."), *ItemId.ToString(), SlotIndex);
+                }
+            }
+        }
+    }
+
+    FGameplayTag PartialStackItemId;
+    if (ItemData && ItemData->MaxStackSize > 1 && Record.Quantity < ItemData->MaxStackSize)
+        PartialStackItemId = ItemId;
+
+    FGameplayTag& IndexedItemId = IndexedPartialStackItems[SlotIndex];
+    if (IndexedItemId == PartialStackItemId) return;
+
+    if (IndexedItemId.IsValid())
+    {
+        if (TArray<int32>* Stacks = PartialGridStacks.Find(IndexedItemId))
+        {
+            const int32 Position = Algo::BinarySearch(*Stacks, SlotIndex);
+            if (Position != INDEX_NONE) Stacks->RemoveAt(Position);
+            if (Stacks->IsEmpty()) PartialGridStacks.Remove(IndexedItemId);
+        }
+    }
+
+    if (PartialStackItemId.IsValid())
+    {
+        TArray<int32>& Stacks = PartialGridStacks.FindOrAdd(PartialStackItemId);
+        Stacks.Insert(SlotIndex, Algo::LowerBound(Stacks, SlotIndex));
+    }
+
+    IndexedItemId = PartialStackItemId;
+}
+
+void UInventoryGridViewModel::RebuildGridSlotIndex()
+{
+    FreeGridSlots.Init(true, GridSlotRecords.Num());
+    IndexedPartialStackItems.Init(FGameplayTag(), GridSlotRecords.Num());
+    FirstGridSlots.Init(INDEX_NONE, GridItemIds.Num());
+    GridItemsChecksum = 0;
+    PartialGridStacks.Reset();
+
+    if (LinkedContainerComponent && LinkedContainerComponent->JigsawMode)
+    {
+        const int32 Width = FMath::Clamp(LinkedContainerComponent->JigsawGridWidth, 1, FRISJigsawGrid::MaxWidth);
+        // A slot count that doesn't fill the last row gets a partial row, the cells past the last slot are blocked
+        const int32 Height = FMath::DivideAndRoundUp(GridSlotRecords.Num(), Width);
+        if (JigsawLayout.GetWidth() != Width || JigsawLayout.GetHeight() != Height || JigsawLayout.GetNumCells() != GridSlotRecords.Num())
+            JigsawLayout.Init(Width, Height, GridSlotRecords.Num());
+
+        // Drop placements that no longer match their slot first so re-placing below can't collide with them
+        for (int32 i = JigsawLayout.GetPlacements().Num() - 1; i >= 0; --i)
+        {
+            const FRISJigsawPlacement& Placement = JigsawLayout.GetPlacements()[i];
+            const int32 AnchorSlot = Placement.Position.Y * Width + Placement.Position.X;
+            const int32 Handle = GridSlotRecords[AnchorSlot].ItemHandle;
+            if (Handle == INDEX_NONE || GridItemIds[Handle] != Placement.ItemId)
+                JigsawLayout.RemovePlacement(i);
+        }
+    }
+    else
+    {
+        JigsawLayout.Init(0, 0);
+    }
+
+    // Everything was reset above so each slot is indexed as if it had been empty
+    for (int32 SlotIndex = 0; SlotIndex < GridSlotRecords.Num(); ++SlotIndex)
+    {
+        UpdateGridSlotIndex(SlotIndex, INDEX_NONE, 0);
+    }
+}
+
+FItemBundle UInventoryGridViewModel::BuildGridItem(int32 SlotIndex) const
+{
+    if (!GridSlotRecords.IsValidIndex(SlotIndex) || GridSlotRecords[SlotIndex].ItemHandle == INDEX_NONE)
+        return FItemBundle::EmptyItemInstance;
+
+    ++NumGridItemsBuilt;
+    const FRISGridSlotRecord& Record = GridSlotRecords[SlotIndex];
+    return FItemBundle(GridItemIds[Record.ItemHandle], Record.Quantity, GetGridSlotInstances(SlotIndex));
+}
+
+const TArray<UItemInstanceData*>& UInventoryGridViewModel::GetGridSlotInstances(int32 SlotIndex) const
+{
+    if (!GridSlotRecords.IsValidIndex(SlotIndex) || GridSlotRecords[SlotIndex].InstanceList == INDEX_NONE)
+        return FItemBundle::NoInstances;
+    return GridInstanceLists[GridSlotRecords[SlotIndex].InstanceList].Instances;
+}
+
+void UInventoryGridViewModel::SetGridItem(int32 SlotIndex, const FItemBundle& Item)
+{
+    if (!GridSlotRecords.IsValidIndex(SlotIndex)) return;
+
+    FRISGridSlotRecord& Record = GridSlotRecords[SlotIndex];
+    const FRISGridSlotRecord OldRecord = Record;
+    if (Item.IsValid())
+    {
+        Record.ItemHandle = GetGridItemHandle(Item.ItemId);
+        Record.Quantity = Item.Quantity;
+        if (Item.InstanceData.Num() > 0)
+            GetOrAddGridInstanceList(Record) = Item.InstanceData;
+        else
+            ReleaseGridInstanceList(Record);
+    }
+    else
+    {
+        Record.Quantity = 0;
+    }
+    CommitGridSlot(SlotIndex, OldRecord);
+}
+
+void UInventoryGridViewModel::CommitGridSlot(int32 SlotIndex, const FRISGridSlotRecord& OldRecord)
+{
+    FRISGridSlotRecord& Record = GridSlotRecords[SlotIndex];
+    if (Record.Quantity <= 0 || Record.ItemHandle == INDEX_NONE)
+    {
+        ReleaseGridInstanceList(Record);
+        Record = FRISGridSlotRecord();
+    }
+    else if (Record.InstanceList != INDEX_NONE && GridInstanceLists[Record.InstanceList].Instances.IsEmpty())
+    {
+        ReleaseGridInstanceList(Record);
+    }
+    UpdateGridSlotIndex(SlotIndex, OldRecord.ItemHandle, OldRecord.Quantity);
+}
+
+TArray<UItemInstanceData*>& UInventoryGridViewModel::GetOrAddGridInstanceList(FRISGridSlotRecord& Record)
+{
+    if (Record.InstanceList == INDEX_NONE)
+        Record.InstanceList = FreeGridInstanceLists.Num() > 0 ? FreeGridInstanceLists.Pop(EAllowShrinking::No) : GridInstanceLists.AddDefaulted();
+    return GridInstanceLists[Record.InstanceList].Instances;
+}
+
+void UInventoryGridViewModel::ReleaseGridInstanceList(FRISGridSlotRecord& Record)
+{
+    if (Record.InstanceList == INDEX_NONE) return;
+
+    GridInstanceLists[Record.InstanceList].Instances.Reset();
+    FreeGridInstanceLists.Add(Record.InstanceList);
+    Record.InstanceList = INDEX_NONE;
+}
+
+int32 UInventoryGridViewModel::GetGridItemHandle(const FGameplayTag& ItemId)
+{
+    if (const int32* Handle = GridItemHandles.Find(ItemId)) return *Handle;
+
+    const int32 Handle = GridItemIds.Add(ItemId);
+    GridItemHandles.Add(ItemId, Handle);
+    FirstGridSlots.Add(INDEX_NONE);
+    return Handle;
+}
+
+void UInventoryGridViewModel::BroadcastGridSlotUpdated(int32 SlotIndex, const TArray<UItemInstanceData*>& OldInstances)
+{
+    if (IsGridSlotVisible(SlotIndex))
+        OnGridSlotUpdated.Broadcast(SlotIndex, OldInstances);
+}
+
+void UInventoryGridViewModel::SetGridPageSize(int32 PageSize)
+{
+    GridPageSize = FMath::Max(PageSize, 0);
+    VisibleGridPage = FMath::Clamp(VisibleGridPage, 0, FMath::Max(GetNumGridPages() - 1, 0));
+    OnGridPageShown.Broadcast(VisibleGridPage);
+}
+
+void UInventoryGridViewModel::SetVisibleGridPage(int32 PageIndex)
+{
+    PageIndex = FMath::Clamp(PageIndex, 0, FMath::Max(GetNumGridPages() - 1, 0));
+    if (PageIndex == VisibleGridPage) return;
+
+    VisibleGridPage = PageIndex;
+    OnGridPageShown.Broadcast(VisibleGridPage);
+}
+
+int32 UInventoryGridViewModel::GetNumGridPages() const
+{
+    return GridPageSize > 0 ? FMath::DivideAndRoundUp(GridSlotRecords.Num(), GridPageSize) : 1;
+}
+
+bool UInventoryGridViewModel::IsGridSlotVisible(int32 SlotIndex) const
+{
+    return GridPageSize <= 0 || SlotIndex / GridPageSize == VisibleGridPage;
+}
+
+TArray<int32> UInventoryGridViewModel::FilterGridSlots(const FGameplayTagQuery& CategoryQuery, const FString& NameFilter) const
+{
+    // Decide per item type first, the slot scan then only compares handles
+    TBitArray<> MatchingHandles(false, GridItemIds.Num());
+    for (int32 Handle = 0; Handle < GridItemIds.Num(); ++Handle)
+    {
+        const UItemStaticData* ItemData = URISSubsystem::GetItemDataById(GridItemIds[Handle]);
+        if (!ItemData) continue;
+
+        MatchingHandles[Handle] = (CategoryQuery.IsEmpty() || CategoryQuery.Matches(ItemData->ItemCategories)) &&
+            (NameFilter.IsEmpty() || ItemData->ItemName.ToString().Contains(NameFilter));
+    }
+
+    TArray<int32> MatchingSlots;
+    for (int32 SlotIndex = 0; SlotIndex < GridSlotRecords.Num(); ++SlotIndex)
+    {
+        const int32 Handle = GridSlotRecords[SlotIndex].ItemHandle;
+        if (Handle != INDEX_NONE && MatchingHandles[Handle])
+            MatchingSlots.Add(SlotIndex);
+    }
+    return MatchingSlots;
+}
+
+int32 UInventoryGridViewModel::FindFirstGridSlotWithItem(const FGameplayTag& ItemId) const
+{
+    const int32* Handle = GridItemHandles.Find(ItemId);
+    return Handle ? FirstGridSlots[*Handle] : INDEX_NONE;
+}
+
+TArray<FItemBundle> UInventoryGridViewModel::GetVisibleGridPageItems() const
+{
+    const int32 FirstSlot = GridPageSize > 0 ? VisibleGridPage * GridPageSize : 0;
+    const int32 EndSlot = GridPageSize > 0 ? FMath::Min(FirstSlot + GridPageSize, GridSlotRecords.Num()) : GridSlotRecords.Num();
+
+    TArray<FItemBundle> PageItems;
+    PageItems.Reserve(FMath::Max(EndSlot - FirstSlot, 0));
+    for (int32 SlotIndex = FirstSlot; SlotIndex < EndSlot; ++SlotIndex)
+    {
+        PageItems.Add(BuildGridItem(SlotIndex));
+    }
+    return PageItems;
+}
+
+FIntPoint UInventoryGridViewModel::SlotIndexToJigsawCell(int32 SlotIndex) const
+{
+    const int32 Width = FMath::Max(JigsawLayout.GetWidth(), 1);
+    return FIntPoint(SlotIndex % Width, SlotIndex / Width);
+}
+
+bool UInventoryGridViewModel::CanJigsawItemFitAtSlot(const FGameplayTag& ItemId, int32 SlotIndex, TConstArrayView<int32> IgnoredSlots) const
+{
+    if (JigsawLayout.GetWidth() <= 0) return true;
+
+    FRISJigsawGrid Layout = JigsawLayout;
+    for (const int32 IgnoredSlot : IgnoredSlots)
+    {
+        Layout.RemovePlacement(Layout.FindPlacementAt(SlotIndexToJigsawCell(IgnoredSlot)));
+    }
+
+    const FIntPoint Cell = SlotIndexToJigsawCell(SlotIndex);
+    const FIntPoint ItemSize = JigsawSizeOf(URISSubsystem::GetItemDataById(ItemId));
+    return Layout.CanPlaceAt(Cell, ItemSize) ||
+        (LinkedContainerComponent && LinkedContainerComponent->JigsawAllowRotation && Layout.CanPlaceAt(Cell, FIntPoint(ItemSize.Y, ItemSize.X)));
+}
+
+FIntPoint UInventoryGridViewModel::GetJigsawItemSize(int32 SlotIndex) const
+{
+    const int32 PlacementIndex = JigsawLayout.GetWidth() > 0 ? JigsawLayout.FindPlacementAt(SlotIndexToJigsawCell(SlotIndex)) : INDEX_NONE;
+    return PlacementIndex != INDEX_NONE ? JigsawLayout.GetPlacements()[PlacementIndex].Size : FIntPoint(1, 1);
+}
+
+int32 UInventoryGridViewModel::GetJigsawSlotCoveringCell(int32 CellIndex) const
+{
+    if (JigsawLayout.GetWidth() <= 0) return IsGridSlotEmpty(CellIndex) ? -1 : CellIndex;
+
+    const int32 PlacementIndex = JigsawLayout.FindPlacementCoveringCell(SlotIndexToJigsawCell(CellIndex));
+    if (PlacementIndex == INDEX_NONE) return -1;
+
+    const FIntPoint& Position = JigsawLayout.GetPlacements()[PlacementIndex].Position;
+    return Position.Y * JigsawLayout.GetWidth() + Position.X;
+}
+
+bool UInventoryGridViewModel::AutoArrangeJigsaw()
+{
+    if (JigsawLayout.GetWidth() <= 0 || !LinkedContainerComponent) return false;
+
+    // Placements only know their item id, remember which slot each one belongs to
+    TArray<int32> PlacementSlots;
+    for (const FRISJigsawPlacement& Placement : JigsawLayout.GetPlacements())
+    {
+        PlacementSlots.Add(Placement.Position.Y * JigsawLayout.GetWidth() + Placement.Position.X);
+    }
+
+    TArray<int32> PreviousIndices;
+    if (!JigsawLayout.AutoArrange(LinkedContainerComponent->JigsawAllowRotation, &PreviousIndices)) return false;
+
+    // Records move with their instance lists, nothing is copied
+    TMap<int32, FRISGridSlotRecord> PrevGridSlots;
+    for (const int32 SlotIndex : PlacementSlots)
+    {
+        PrevGridSlots.Add(SlotIndex, GridSlotRecords[SlotIndex]);
+        GridSlotRecords[SlotIndex] = FRISGridSlotRecord();
+    }
+
+    const TArray<FRISJigsawPlacement>& Placements = JigsawLayout.GetPlacements();
+    for (int32 i = 0; i < Placements.Num(); ++i)
+    {
+        const int32 NewSlot = Placements[i].Position.Y * JigsawLayout.GetWidth() + Placements[i].Position.X;
+        if (!PrevGridSlots.Contains(NewSlot))
+            PrevGridSlots.Add(NewSlot, FRISGridSlotRecord());
+        GridSlotRecords[NewSlot] = PrevGridSlots[PlacementSlots[PreviousIndices[i]]];
+    }
+
+    PrevGridSlots.KeySort(TLess<int32>());
+    for (const auto& Pair : PrevGridSlots)
+    {
+        UpdateGridSlotIndex(Pair.Key, Pair.Value.ItemHandle, Pair.Value.Quantity);
+        if (GridSlotRecords[Pair.Key] != Pair.Value)
+            BroadcastGridSlotUpdated(Pair.Key, Pair.Value.InstanceList != INDEX_NONE ? GridInstanceLists[Pair.Value.InstanceList].Instances : FItemBundle::NoInstances);
+    }
+    return true;
+}
+
+namespace
+{
+    // All stacks of one item while SortAndCompactGrid lays out the grid
+    struct FGridSortEntry
+    {
+        FGameplayTag ItemId;
+        const UItemStaticData* ItemData = nullptr;
+        FRISItemSortKey SortKey;
+        int32 Quantity = 0;
+        TArray<UItemInstanceData*> Instances;
+    };
+}
+
+bool UInventoryGridViewModel::SortAndCompactGrid()
+{
+    if (!LinkedContainerComponent) return false;
+
+    // Merge every grid stack into one entry per item, in order of first appearance so equal keys keep their relative order
+    TArray<FGridSortEntry> Entries;
+    TMap<FGameplayTag, int32> EntryIndexByItem;
+    for (int32 SlotIndex = 0; SlotIndex < GridSlotRecords.Num(); ++SlotIndex)
+    {
+        const FRISGridSlotRecord& Slot = GridSlotRecords[SlotIndex];
+        if (Slot.ItemHandle == INDEX_NONE) continue;
+
+        const FGameplayTag& ItemId = GridItemIds[Slot.ItemHandle];
+        int32& EntryIndex = EntryIndexByItem.FindOrAdd(ItemId, INDEX_NONE);
+        if (EntryIndex == INDEX_NONE)
+        {
+            EntryIndex = Entries.Num();
+            FGridSortEntry& NewEntry = Entries.AddDefaulted_GetRef();
+            NewEntry.ItemId = ItemId;
+            NewEntry.ItemData = URISSubsystem::GetItemDataById(ItemId);
+            NewEntry.SortKey = FRISItemSortKey(NewEntry.ItemData);
+        }
+
+        Entries[EntryIndex].Quantity += Slot.Quantity;
+        Entries[EntryIndex].Instances.Append(GetGridSlotInstances(SlotIndex));
+    }
+
+    TArray<int32> Order;
+    Order.Reserve(Entries.Num());
+    for (int32 i = 0; i < Entries.Num(); ++i)
+    {
+        Order.Add(i);
+    }
+    Algo::StableSort(Order, [&Entries](int32 A, int32 B) { return Entries[A].SortKey < Entries[B].SortKey; });
+
+    // Lay the sorted stacks out into a new grid, full stacks first. Jigsaw grids place them first-fit in sorted order
+    const bool IsJigsaw = JigsawLayout.GetWidth() > 0;
+    const bool AllowRotation = LinkedContainerComponent->JigsawAllowRotation;
+    FRISJigsawGrid NewLayout;
+    if (IsJigsaw)
+        NewLayout.Init(JigsawLayout.GetWidth(), JigsawLayout.GetHeight(), JigsawLayout.GetNumCells());
+
+    TArray<FRISGridSlotRecord> NewGridSlots;
+    NewGridSlots.Init(FRISGridSlotRecord(), GridSlotRecords.Num());
+    TArray<FRISGridSlotInstances> NewInstanceLists;
+    int32 NextSlot = 0;
+    for (const int32 EntryIndex : Order)
+    {
+        const FGridSortEntry& Entry = Entries[EntryIndex];
+        const int32 MaxStackSize = Entry.ItemData ? FMath::Max(Entry.ItemData->MaxStackSize, 1) : Entry.Quantity;
+        int32 PlacedInstances = 0;
+        for (int32 Remaining = Entry.Quantity; Remaining > 0; Remaining -= MaxStackSize)
+        {
+            int32 SlotIndex = NextSlot++;
+            if (IsJigsaw)
+            {
+                const int32 PlacementIndex = NewLayout.PlaceAnywhere(Entry.ItemId, JigsawSizeOf(Entry.ItemData), AllowRotation);
+                SlotIndex = PlacementIndex == INDEX_NONE ? INDEX_NONE :
+                    NewLayout.GetPlacements()[PlacementIndex].Position.Y * NewLayout.GetWidth() + NewLayout.GetPlacements()[PlacementIndex].Position.X;
+            }
+
+            if (!NewGridSlots.IsValidIndex(SlotIndex))
+            {
+                UE_LOG(LogRancInventorySystem, Verbose, TEXT("SortAndCompactGrid: %s does not fit into the sorted grid, grid left unchanged."), *Entry.ItemId.ToString());
+                return false;
+            }
+
+            FRISGridSlotRecord& Stack = NewGridSlots[SlotIndex];
+            Stack.ItemHandle = GetGridItemHandle(Entry.ItemId);
+            Stack.Quantity = FMath::Min(Remaining, MaxStackSize);
+            const int32 NumInstances = FMath::Min(Stack.Quantity, Entry.Instances.Num() - PlacedInstances);
+            if (NumInstances > 0)
+            {
+                Stack.InstanceList = NewInstanceLists.Num();
+                NewInstanceLists.AddDefaulted_GetRef().Instances.Append(Entry.Instances.GetData() + PlacedInstances, NumInstances);
+                PlacedInstances += NumInstances;
+            }
+        }
+    }
+
+    // Apply the whole layout before broadcasting so listeners never see a half sorted grid
+    Swap(GridSlotRecords, NewGridSlots);
+    Swap(GridInstanceLists, NewInstanceLists);
+    FreeGridInstanceLists.Reset();
+    if (IsJigsaw)
+        JigsawLayout = MoveTemp(NewLayout);
+    RebuildGridSlotIndex();
+
+    // The swapped out records and lists are the previous grid
+    for (int32 SlotIndex = 0; SlotIndex < GridSlotRecords.Num(); ++SlotIndex)
+    {
+        const FRISGridSlotRecord& OldSlot = NewGridSlots[SlotIndex];
+        const TArray<UItemInstanceData*>& OldInstances = OldSlot.InstanceList != INDEX_NONE ? NewInstanceLists[OldSlot.InstanceList].Instances : FItemBundle::NoInstances;
+        if (GridSlotRecords[SlotIndex].ItemHandle != OldSlot.ItemHandle || GridSlotRecords[SlotIndex].Quantity != OldSlot.Quantity ||
+            GetGridSlotInstances(SlotIndex) != OldInstances)
+            BroadcastGridSlotUpdated(SlotIndex, OldInstances);
+    }
+    return true;
+}
+
 FGameplayTag UInventoryGridViewModel::FindTaggedSlotForItem(const FGameplayTag& ItemId, int32 Quantity, EPreferredSlotPolicy SlotPolicy) const
 {
       // Validate
@@ -941,14 +1490,15 @@ void UInventoryGridViewModel::HandleItemAdded_Implementation(const UItemStaticDa
              break;
         }
 
-        FItemBundle& TargetSlot = ViewableGridSlots[SlotIndex];
+        FRISGridSlotRecord& TargetSlot = GridSlotRecords[SlotIndex];
+        const FRISGridSlotRecord OldTargetSlot = TargetSlot;
+        const int32 ItemHandle = GetGridItemHandle(ItemData->ItemId);
         int32 AddableQuantity = ItemData->MaxStackSize > 1 ? ItemData->MaxStackSize : 1;
-         if (TargetSlot.IsValid() && TargetSlot.ItemId == ItemData->ItemId) {
+         if (TargetSlot.ItemHandle == ItemHandle) {
              AddableQuantity -= TargetSlot.Quantity;
-         } else if (!TargetSlot.IsValid()) {
-             TargetSlot.ItemId = ItemData->ItemId;
+         } else if (TargetSlot.ItemHandle == INDEX_NONE) {
+             TargetSlot.ItemHandle = ItemHandle;
              TargetSlot.Quantity = 0;
-             TargetSlot.InstanceData.Empty();
          } else {
              UE_LOG(LogRancInventorySystem, Error, TEXT("HandleItemAdded: FindGridSlotIndexForItem returned incompatible slot %d."), SlotIndex);
              ForceFullUpdate(); // Resync
@@ -966,13 +1516,15 @@ void UInventoryGridViewModel::HandleItemAdded_Implementation(const UItemStaticDa
         // Append instance data for the amount added to this slot
         if (InstanceIdx < InstancesAdded.Num()) {
             int32 NumInstancesToAdd = FMath::Min(ActuallyAddedToSlot, InstancesAdded.Num() - InstanceIdx);
+            TArray<UItemInstanceData*>& SlotInstances = GetOrAddGridInstanceList(TargetSlot);
             for(int32 k=0; k<NumInstancesToAdd; ++k) {
-                TargetSlot.InstanceData.Add(InstancesAdded[InstanceIdx++]);
+                SlotInstances.Add(InstancesAdded[InstanceIdx++]);
             }
         }
 
         RemainingItems -= ActuallyAddedToSlot;
-        OnGridSlotUpdated.Broadcast(SlotIndex, FItemBundle::NoInstances);
+        CommitGridSlot(SlotIndex, OldTargetSlot);
+        BroadcastGridSlotUpdated(SlotIndex, FItemBundle::NoInstances);
     }
 }
 
@@ -996,23 +1548,28 @@ void UInventoryGridViewModel::HandleItemRemoved_Implementation(const UItemStatic
 
     UE_LOG(LogRancInventorySystem, Log, TEXT("HandleItemRemoved: Received unpredicted remove for %s x%d. Updating visuals."), *ItemData->ItemId.ToString(), Quantity);
     int32 RemainingToRemove = Quantity;
-    for (int32 SlotIndex = 0; SlotIndex < ViewableGridSlots.Num() && RemainingToRemove > 0; ++SlotIndex)
+    const int32* ItemHandle = GridItemHandles.Find(ItemData->ItemId);
+    const int32 FirstSlot = ItemHandle ? FirstGridSlots[*ItemHandle] : INDEX_NONE;
+    for (int32 SlotIndex = FMath::Max(FirstSlot, 0); FirstSlot != INDEX_NONE && SlotIndex < GridSlotRecords.Num() && RemainingToRemove > 0; ++SlotIndex)
     {
-        FItemBundle& CurrentSlot = ViewableGridSlots[SlotIndex];
-        if (CurrentSlot.IsValid() && CurrentSlot.ItemId == ItemData->ItemId)
+        FRISGridSlotRecord& CurrentSlot = GridSlotRecords[SlotIndex];
+        if (CurrentSlot.ItemHandle == *ItemHandle)
         {
+            const FRISGridSlotRecord OldSlot = CurrentSlot;
             if (!InstancesRemoved.IsEmpty())
             {
-                int32 RemovedCount = CurrentSlot.InstanceData.RemoveAll([&InstancesRemoved](UItemInstanceData* Instance) {
+                if (CurrentSlot.InstanceList == INDEX_NONE) continue;
+
+                TArray<UItemInstanceData*>& SlotInstances = GridInstanceLists[CurrentSlot.InstanceList].Instances;
+                int32 RemovedCount = SlotInstances.RemoveAll([&InstancesRemoved](UItemInstanceData* Instance) {
                     return InstancesRemoved.Contains(Instance);
                 });
-                int32 OldQuantity = CurrentSlot.Quantity;
-                CurrentSlot.Quantity = CurrentSlot.InstanceData.Num(); // Sync quantity with instances
 
                 if (RemovedCount > 0) {
+                    CurrentSlot.Quantity = SlotInstances.Num(); // Sync quantity with instances
                     RemainingToRemove -= RemovedCount;
-                    if (CurrentSlot.Quantity <= 0) CurrentSlot = FItemBundle::EmptyItemInstance;
-                    OnGridSlotUpdated.Broadcast(SlotIndex, InstancesRemoved);
+                    CommitGridSlot(SlotIndex, OldSlot);
+                    BroadcastGridSlotUpdated(SlotIndex, InstancesRemoved);
                 }
             }
             else // Remove by quantity
@@ -1023,16 +1580,14 @@ void UInventoryGridViewModel::HandleItemRemoved_Implementation(const UItemStatic
                     CurrentSlot.Quantity -= CanRemoveFromSlot;
                     RemainingToRemove -= CanRemoveFromSlot;
                     // Remove instances from the end if removing by quantity
-                    if(CurrentSlot.InstanceData.Num() > 0) {
-                        int32 InstToRemove = FMath::Min(CanRemoveFromSlot, CurrentSlot.InstanceData.Num()); // Should match CanRemoveFromSlot unless data is inconsistent
-                        for(int32 k=0; k<InstToRemove; ++k) CurrentSlot.InstanceData.Pop(EAllowShrinking::No);
-                        CurrentSlot.InstanceData.Shrink();
+                    if (CurrentSlot.InstanceList != INDEX_NONE) {
+                        TArray<UItemInstanceData*>& SlotInstances = GridInstanceLists[CurrentSlot.InstanceList].Instances;
+                        int32 InstToRemove = FMath::Min(CanRemoveFromSlot, SlotInstances.Num()); // Should match CanRemoveFromSlot unless data is inconsistent
+                        for(int32 k=0; k<InstToRemove; ++k) SlotInstances.Pop(EAllowShrinking::No);
                     }
 
-                    if (CurrentSlot.Quantity <= 0)
-                        CurrentSlot = FItemBundle::EmptyItemInstance;
-
-                    OnGridSlotUpdated.Broadcast(SlotIndex, InstancesRemoved);
+                    CommitGridSlot(SlotIndex, OldSlot);
+                    BroadcastGridSlotUpdated(SlotIndex, InstancesRemoved);
                 }
             }
         }
@@ -1206,9 +1761,9 @@ bool UInventoryGridViewModel::MoveItem_Internal(FGameplayTag SourceTaggedSlot, i
     // Implementation moved from UInventoryGridViewModel::MoveItem_Internal
     if (!LinkedContainerComponent) return false;
 
-    const bool bSourceIsGrid = !SourceTaggedSlot.IsValid() && ViewableGridSlots.IsValidIndex(SourceSlotIndex);
+    const bool bSourceIsGrid = !SourceTaggedSlot.IsValid() && GridSlotRecords.IsValidIndex(SourceSlotIndex);
     const bool bSourceIsTag = SourceTaggedSlot.IsValid() && (!LinkedInventoryComponent || ViewableTaggedSlots.Contains(SourceTaggedSlot)); // Source tag requires inventory
-    const bool bTargetIsGrid = !TargetTaggedSlot.IsValid() && ViewableGridSlots.IsValidIndex(TargetSlotIndex);
+    const bool bTargetIsGrid = !TargetTaggedSlot.IsValid() && GridSlotRecords.IsValidIndex(TargetSlotIndex);
     const bool bTargetIsTag = TargetTaggedSlot.IsValid() && (!LinkedInventoryComponent || ViewableTaggedSlots.Contains(TargetTaggedSlot)); // Target tag requires inventory
 
     // Basic validation
@@ -1222,11 +1777,16 @@ bool UInventoryGridViewModel::MoveItem_Internal(FGameplayTag SourceTaggedSlot, i
     }
 
 
+    // Grid slots are moved through built copies that are written back with SetGridItem
+    FItemBundle SourceGridItem;
+    FItemBundle TargetGridItem;
+
     FItemBundle* SourceItem = nullptr;
     if (bSourceIsTag) {
         SourceItem = &GetMutableItemForTaggedSlotInternal(SourceTaggedSlot);
     } else {
-        SourceItem = &ViewableGridSlots[SourceSlotIndex];
+        SourceGridItem = BuildGridItem(SourceSlotIndex);
+        SourceItem = &SourceGridItem;
     }
     if (!SourceItem || !SourceItem->IsValid()) return false;
 
@@ -1241,7 +1801,8 @@ bool UInventoryGridViewModel::MoveItem_Internal(FGameplayTag SourceTaggedSlot, i
      if (bTargetIsTag) {
          TargetItem = &GetMutableItemForTaggedSlotInternal(TargetTaggedSlot);
      } else {
-         TargetItem = &ViewableGridSlots[TargetSlotIndex];
+         TargetGridItem = BuildGridItem(TargetSlotIndex);
+         TargetItem = &TargetGridItem;
      }
      if(!TargetItem) return false; // Should not happen if logic above is correct
 
@@ -1253,6 +1814,28 @@ bool UInventoryGridViewModel::MoveItem_Internal(FGameplayTag SourceTaggedSlot, i
         }
     }
 
+    // Jigsaw items need room at the target anchor, the slots they are leaving don't count as occupied
+    if (bSourceIsGrid && bTargetIsGrid && JigsawLayout.GetWidth() > 0) {
+        if (!TargetItem->IsValid()) {
+            TArray<int32, TInlineAllocator<1>> IgnoredSlots;
+            if (!IsSplit || RequestedQuantity == SourceItem->Quantity)
+                IgnoredSlots.Add(SourceSlotIndex);
+            if (!CanJigsawItemFitAtSlot(ItemIdToMove, TargetSlotIndex, IgnoredSlots))
+                return false;
+        } else if (!IsSplit && TargetItem->ItemId != ItemIdToMove) {
+            FRISJigsawGrid SwappedLayout = JigsawLayout;
+            for (const int32 Anchor : { SourceSlotIndex, TargetSlotIndex })
+                SwappedLayout.RemovePlacement(SwappedLayout.FindPlacementAt(SlotIndexToJigsawCell(Anchor)));
+            const bool AllowRotation = LinkedContainerComponent->JigsawAllowRotation;
+            auto PlaceEitherWay = [&SwappedLayout, AllowRotation](const FGameplayTag& ItemId, const FIntPoint& Cell) {
+                const FIntPoint ItemSize = JigsawSizeOf(URISSubsystem::GetItemDataById(ItemId));
+                return SwappedLayout.Place(ItemId, Cell, ItemSize, false) != INDEX_NONE || (AllowRotation && SwappedLayout.Place(ItemId, Cell, ItemSize, true) != INDEX_NONE);
+            };
+            if (!PlaceEitherWay(ItemIdToMove, SlotIndexToJigsawCell(TargetSlotIndex)) || !PlaceEitherWay(TargetItem->ItemId, SlotIndexToJigsawCell(SourceSlotIndex)))
+                return false;
+        }
+    }
+
     auto InstancesToMove = SourceItem->GetInstancesFromEnd(RequestedQuantity);
     FGameplayTag SwapItemId = FGameplayTag();
     int32 SwapQuantity = -1;
@@ -1268,6 +1851,8 @@ bool UInventoryGridViewModel::MoveItem_Internal(FGameplayTag SourceTaggedSlot, i
         QuantityValidatedByServer = LinkedInventoryComponent->ValidateMoveItem(ItemIdToMove, RequestedQuantity, InstancesToMove, SourceTaggedSlot, TargetTaggedSlot, SwapItemId, SwapQuantity);
         if (QuantityValidatedByServer <= 0 && bTargetIsTag && !IsSplit && TryUnblockingMove(TargetTaggedSlot, ItemIdToMove))
         {
+             // Unblocking may have put the blocking item into the grid, refresh the copy of the source slot
+             if (bSourceIsGrid) SourceGridItem = BuildGridItem(SourceSlotIndex);
              QuantityValidatedByServer = LinkedInventoryComponent->ValidateMoveItem(ItemIdToMove, RequestedQuantity, InstancesToMove, SourceTaggedSlot, TargetTaggedSlot, SwapItemId, SwapQuantity);
         }
         if (QuantityValidatedByServer <= 0) return false;
@@ -1288,13 +1873,20 @@ bool UInventoryGridViewModel::MoveItem_Internal(FGameplayTag SourceTaggedSlot, i
     FGenericItemBundle TargetItemGB(TargetItem);
     // Important: Pass correct instances to MoveBetweenSlots
     FRISMoveResult MoveResult = URISFunctions::MoveBetweenSlots(SourceItemGB, TargetItemGB, false, QuantityToActuallyMove, InstancesToMove, !IsSplit);
+    if (bSourceIsGrid && bTargetIsGrid && MoveResult.WereItemsSwapped && JigsawLayout.GetWidth() > 0) {
+        // Both anchors change at once, clear them so neither item is re-placed against the other's old placement
+        for (const int32 Anchor : { SourceSlotIndex, TargetSlotIndex })
+            JigsawLayout.RemovePlacement(JigsawLayout.FindPlacementAt(SlotIndexToJigsawCell(Anchor)));
+    }
+    if (bSourceIsGrid) SetGridItem(SourceSlotIndex, SourceGridItem);
+    if (bTargetIsGrid) SetGridItem(TargetSlotIndex, TargetGridItem);
 
     // --- Handle Results and Pending Operations ---
     if (MoveResult.QuantityMoved > 0 || MoveResult.WereItemsSwapped)
     {
         // --- Broadcast Updates ---
-        if(bSourceIsTag) OnTaggedSlotUpdated.Broadcast(SourceTaggedSlot, InstancesToMove); else OnGridSlotUpdated.Broadcast(SourceSlotIndex, InstancesToMove);
-        if(bTargetIsTag) OnTaggedSlotUpdated.Broadcast(TargetTaggedSlot, InstancesToSwapBack); else OnGridSlotUpdated.Broadcast(TargetSlotIndex, InstancesToSwapBack);
+        if(bSourceIsTag) OnTaggedSlotUpdated.Broadcast(SourceTaggedSlot, InstancesToMove); else BroadcastGridSlotUpdated(SourceSlotIndex, InstancesToMove);
+        if(bTargetIsTag) OnTaggedSlotUpdated.Broadcast(TargetTaggedSlot, InstancesToSwapBack); else BroadcastGridSlotUpdated(TargetSlotIndex, InstancesToSwapBack);
 
         if (bSourceIsTag || bTargetIsTag)
         {
@@ -1328,9 +1920,28 @@ bool UInventoryGridViewModel::MoveItem_Internal(FGameplayTag SourceTaggedSlot, i
     return false; // Visual move failed
 }
 
+namespace
+{
+    // Backing state of one item while ForceFullUpdate reconciles the grid
+    struct FGridResyncEntry
+    {
+        const UItemStaticData* ItemData = nullptr;
+        int32 RemainingQuantity = 0;
+        TArray<UItemInstanceData*> Instances; // Backing order, used when placing new stacks
+        TSet<UItemInstanceData*> UnplacedInstances;
+    };
+
+    // Content of a grid slot before ForceFullUpdate touched it
+    struct FGridSlotSnapshot
+    {
+        int32 ItemHandle = INDEX_NONE;
+        int32 Quantity = 0;
+        TArray<UItemInstanceData*> Instances;
+    };
+}
+
 void UInventoryGridViewModel::ForceFullUpdate_Implementation()
 {
-    // Implementation moved from UInventoryGridViewModel::ForceFullUpdate_Implementation
     if (!LinkedContainerComponent)
     {
         UE_LOG(LogRancInventorySystem, Error, TEXT("ForceFullUpdate: Cannot update, LinkedContainerComponent is null."));
@@ -1343,91 +1954,190 @@ void UInventoryGridViewModel::ForceFullUpdate_Implementation()
     OperationsToConfirm.Empty();
 
     // --- Update Grid Slots ---
-    TArray<FItemBundle> PrevViewableGridSlots = ViewableGridSlots;
-    
-    ViewableGridSlots.Init(FItemBundle::EmptyItemInstance, NumberOfGridSlots);
-
-    TArray<FItemBundle> ActualItems = LinkedContainerComponent->GetAllItems();
-    for (const FItemBundle& BackingItem : ActualItems)
+    // The grid is diffed against the component instead of rebuilt, slots that still match keep their position and are not broadcast
+    TMap<FGameplayTag, FGridResyncEntry> ResyncEntries;
+    for (const FItemBundle& BackingItem : LinkedContainerComponent->GetAllItems())
     {
         if (BackingItem.Quantity <= 0) continue;
 
         const UItemStaticData* ItemData = URISSubsystem::GetItemDataById(BackingItem.ItemId);
         if (!ItemData) continue;
 
-        int32 RemainingQuantity = BackingItem.Quantity;
-        int32 InstanceIdx = 0; // Track instances from the backing item
+        FGridResyncEntry& Entry = ResyncEntries.FindOrAdd(BackingItem.ItemId);
+        Entry.ItemData = ItemData;
+        Entry.RemainingQuantity += BackingItem.Quantity;
+        Entry.Instances.Append(BackingItem.InstanceData);
+    }
+
+    // Items in tagged slots are also part of the container items but are not shown in the grid
+    if (LinkedInventoryComponent)
+    {
+        for (const FTaggedItemBundle& TaggedItem : LinkedInventoryComponent->GetAllTaggedItems())
+        {
+            FGridResyncEntry* Entry = TaggedItem.IsValid() ? ResyncEntries.Find(TaggedItem.ItemId) : nullptr;
+            if (!Entry) continue;
+
+            Entry->RemainingQuantity -= TaggedItem.Quantity;
+            Entry->Instances.RemoveAll([&TaggedItem](UItemInstanceData* Instance) { return TaggedItem.InstanceData.Contains(Instance); });
+        }
+    }
+
+    for (auto& Pair : ResyncEntries)
+    {
+        Pair.Value.UnplacedInstances.Append(Pair.Value.Instances);
+    }
+
+    TMap<int32, FGridSlotSnapshot> PrevGridSlots; // Original content of every slot we touched
+
+    // Pass 1: Keep what is still backed by the component, trim or clear the rest. Works on the records, no bundles are built
+    for (int32 SlotIndex = 0; SlotIndex < GridSlotRecords.Num(); ++SlotIndex)
+    {
+        FRISGridSlotRecord& Slot = GridSlotRecords[SlotIndex];
+        if (Slot.ItemHandle == INDEX_NONE) continue;
+
+        const TArray<UItemInstanceData*>& SlotInstances = GetGridSlotInstances(SlotIndex);
+        TArray<UItemInstanceData*> ReconciledInstances;
+        bool InstancesChanged = false;
+        int32 ReconciledQuantity = Slot.Quantity;
+        FGridResyncEntry* Entry = ResyncEntries.Find(GridItemIds[Slot.ItemHandle]);
+        if (!Entry || Entry->RemainingQuantity <= 0)
+        {
+            ReconciledQuantity = 0;
+        }
+        else if (Entry->Instances.Num() > 0 || SlotInstances.Num() > 0)
+        {
+            ReconciledInstances = SlotInstances;
+            ReconciledInstances.RemoveAll([Entry](UItemInstanceData* Instance) { return !Entry->UnplacedInstances.Contains(Instance); });
+            for (UItemInstanceData* Instance : ReconciledInstances)
+                Entry->UnplacedInstances.Remove(Instance);
+            ReconciledQuantity = ReconciledInstances.Num();
+            InstancesChanged = ReconciledInstances.Num() != SlotInstances.Num();
+        }
+        else
+        {
+            const int32 StackLimit = Entry->ItemData->MaxStackSize > 1 ? Entry->ItemData->MaxStackSize : 1;
+            ReconciledQuantity = FMath::Min3(ReconciledQuantity, Entry->RemainingQuantity, StackLimit);
+        }
+
+        if (ReconciledQuantity > 0)
+            Entry->RemainingQuantity -= ReconciledQuantity;
+
+        if (ReconciledQuantity != Slot.Quantity || InstancesChanged)
+        {
+            PrevGridSlots.Add(SlotIndex, { Slot.ItemHandle, Slot.Quantity, SlotInstances });
+            if (ReconciledQuantity <= 0)
+            {
+                ReleaseGridInstanceList(Slot);
+                Slot = FRISGridSlotRecord();
+            }
+            else
+            {
+                Slot.Quantity = ReconciledQuantity;
+                if (InstancesChanged && ReconciledInstances.IsEmpty())
+                    ReleaseGridInstanceList(Slot);
+                else if (InstancesChanged)
+                    GetOrAddGridInstanceList(Slot) = MoveTemp(ReconciledInstances);
+            }
+        }
+    }
+
+    // Pass 1 edited the records without going through the index, so rebuild it before placing
+    RebuildGridSlotIndex();
 
-        while (RemainingQuantity > 0)
+    // Pass 2: Place whatever the grid is still missing
+    for (auto& Pair : ResyncEntries)
+    {
+        const FGameplayTag& ItemId = Pair.Key;
+        FGridResyncEntry& Entry = Pair.Value;
+        int32 InstanceIdx = 0;
+
+        while (Entry.RemainingQuantity > 0)
         {
-            int32 SlotToAddTo = FindGridSlotIndexForItem(BackingItem.ItemId, RemainingQuantity);
+            int32 SlotToAddTo = FindGridSlotIndexForItem(ItemId, Entry.RemainingQuantity);
             if (SlotToAddTo == -1)
             {
-                UE_LOG(LogRancInventorySystem, Error, TEXT("ForceFullUpdate: Failed to find visual grid slot for item %s during resync."), *BackingItem.ItemId.ToString());
+                UE_LOG(LogRancInventorySystem, Error, TEXT("ForceFullUpdate: Failed to find visual grid slot for item %s during resync."), *ItemId.ToString());
                 break;
             }
 
-            FItemBundle& TargetSlot = ViewableGridSlots[SlotToAddTo];
-            int32 AddLimit = ItemData->MaxStackSize > 1 ? ItemData->MaxStackSize : 1;
+            FRISGridSlotRecord& TargetSlot = GridSlotRecords[SlotToAddTo];
+            const FRISGridSlotRecord OldTargetSlot = TargetSlot;
+            const int32 ItemHandle = GetGridItemHandle(ItemId);
+            int32 AddLimit = Entry.ItemData->MaxStackSize > 1 ? Entry.ItemData->MaxStackSize : 1;
 
-            if (TargetSlot.IsValid() && TargetSlot.ItemId == BackingItem.ItemId) {
+            if (TargetSlot.ItemHandle == ItemHandle) {
                  AddLimit -= TargetSlot.Quantity;
-            } else if (!TargetSlot.IsValid()) {
-                 TargetSlot.ItemId = BackingItem.ItemId;
-                 TargetSlot.Quantity = 0;
-                 TargetSlot.InstanceData.Empty();
-            } else {
+            } else if (TargetSlot.ItemHandle != INDEX_NONE) {
                  UE_LOG(LogRancInventorySystem, Error, TEXT("ForceFullUpdate: FindGridSlotIndexForItem returned incompatible grid slot %d."), SlotToAddTo);
                  break;
             }
 
-            int32 AddedAmount = FMath::Min(RemainingQuantity, AddLimit);
+            int32 AddedAmount = FMath::Min(Entry.RemainingQuantity, AddLimit);
             if(AddedAmount <= 0) {
                  UE_LOG(LogRancInventorySystem, Error, TEXT("ForceFullUpdate: Calculated Grid AddedAmount is zero for slot %d."), SlotToAddTo);
                  break;
             }
 
+            if (!PrevGridSlots.Contains(SlotToAddTo))
+                PrevGridSlots.Add(SlotToAddTo, { TargetSlot.ItemHandle, TargetSlot.Quantity, GetGridSlotInstances(SlotToAddTo) });
+
+            if (TargetSlot.ItemHandle == INDEX_NONE) {
+                 TargetSlot.ItemHandle = ItemHandle;
+                 TargetSlot.Quantity = 0;
+            }
+
             TargetSlot.Quantity += AddedAmount;
-            // Append correct instances
-            if(InstanceIdx < BackingItem.InstanceData.Num()) {
-                int32 NumInstancesToAdd = FMath::Min(AddedAmount, BackingItem.InstanceData.Num() - InstanceIdx);
-                for(int32 k=0; k < NumInstancesToAdd; ++k) {
-                    TargetSlot.InstanceData.Add(BackingItem.InstanceData[InstanceIdx++]);
+            // Append the instances that are not shown anywhere yet
+            for (int32 Added = 0; Added < AddedAmount && InstanceIdx < Entry.Instances.Num(); ++InstanceIdx)
+            {
+                UItemInstanceData* Instance = Entry.Instances[InstanceIdx];
+                if (Entry.UnplacedInstances.Remove(Instance) > 0)
+                {
+                    GetOrAddGridInstanceList(TargetSlot).Add(Instance);
+                    ++Added;
                 }
             }
 
-            RemainingQuantity -= AddedAmount;
+            Entry.RemainingQuantity -= AddedAmount;
+            CommitGridSlot(SlotToAddTo, OldTargetSlot);
         }
     }
-    // Broadcast grid updates
-    for(int32 PrevGridSlotIndex = 0; PrevGridSlotIndex < PrevViewableGridSlots.Num(); ++PrevGridSlotIndex)
-        OnGridSlotUpdated.Broadcast(PrevGridSlotIndex, PrevViewableGridSlots[PrevGridSlotIndex].InstanceData);
 
+    // Broadcast grid updates, only for slots whose content actually changed
+    PrevGridSlots.KeySort(TLess<int32>());
+    for (const auto& Pair : PrevGridSlots)
+    {
+        const FRISGridSlotRecord& Slot = GridSlotRecords[Pair.Key];
+        if (Slot.ItemHandle != Pair.Value.ItemHandle || Slot.Quantity != Pair.Value.Quantity || GetGridSlotInstances(Pair.Key) != Pair.Value.Instances)
+            BroadcastGridSlotUpdated(Pair.Key, Pair.Value.Instances);
+    }
 
     // --- Update Tagged Slots (if inventory) ---
     if (LinkedInventoryComponent)
     {
-        TMap<FGameplayTag, FItemBundle> PrevViewableTaggedSlots = ViewableTaggedSlots;
-
-        // Clear visual tagged slots first (or update in place)
-         for (auto& Pair : ViewableTaggedSlots) { Pair.Value = FItemBundle::EmptyItemInstance; }
-
-        const TArray<FTaggedItemBundle>& ActualTaggedItems = LinkedInventoryComponent->GetAllTaggedItems();
-        for (const FTaggedItemBundle& TaggedItem : ActualTaggedItems)
+        TMap<FGameplayTag, FItemBundle> ActualTaggedSlots;
+        ActualTaggedSlots.Reserve(ViewableTaggedSlots.Num());
+        for (const FTaggedItemBundle& TaggedItem : LinkedInventoryComponent->GetAllTaggedItems())
         {
-            if (ViewableTaggedSlots.Contains(TaggedItem.Tag))
-            {
-                ViewableTaggedSlots[TaggedItem.Tag] = FItemBundle(TaggedItem.ItemId, TaggedItem.Quantity, TaggedItem.InstanceData);
-            }
-            else if (TaggedItem.Tag.IsValid())
+            if (!TaggedItem.Tag.IsValid()) continue;
+
+            if (!ViewableTaggedSlots.Contains(TaggedItem.Tag))
             {
                  UE_LOG(LogRancInventorySystem, Warning, TEXT("ForceFullUpdate: Tagged item %s found in component but tag %s is not registered visually. Adding."), *TaggedItem.ItemId.ToString(), *TaggedItem.Tag.ToString());
-                 ViewableTaggedSlots.Add(TaggedItem.Tag, FItemBundle(TaggedItem.ItemId, TaggedItem.Quantity, TaggedItem.InstanceData));
-                 OnTaggedSlotUpdated.Broadcast(TaggedItem.Tag, TaggedItem.InstanceData);
+                 ViewableTaggedSlots.Add(TaggedItem.Tag, FItemBundle::EmptyItemInstance);
             }
+            ActualTaggedSlots.Add(TaggedItem.Tag, FItemBundle(TaggedItem.ItemId, TaggedItem.Quantity, TaggedItem.InstanceData));
+        }
+
+        for (auto& Pair : ViewableTaggedSlots)
+        {
+            const FItemBundle* Actual = ActualTaggedSlots.Find(Pair.Key);
+            const FItemBundle& NewValue = Actual && Actual->IsValid() ? *Actual : FItemBundle::EmptyItemInstance;
+            if (Pair.Value == NewValue) continue;
+
+            const TArray<UItemInstanceData*> OldInstances = Pair.Value.InstanceData;
+            Pair.Value = NewValue;
+            OnTaggedSlotUpdated.Broadcast(Pair.Key, OldInstances);
         }
-        // Broadcast tagged updates
-        for(const auto& Pair : PrevViewableTaggedSlots)
-            OnTaggedSlotUpdated.Broadcast(Pair.Key, Pair.Value.InstanceData);
     }
-}
\ No newline at end of file
+}
@@ -4,12 +4,14 @@
 
 #include <CoreMinimal.h>
 #include <Components/ActorComponent.h>
+#include <tuple>
 #include "ItemContainerComponent.h"
 #include "Core/RISSubsystem.h"
 #include "InventoryComponent.generated.h"
 
 // Forward declarations
 class UObjectRecipeData;
+class UItemRecipeData;
 struct FPrimaryRISRecipeId;
 
 USTRUCT(Blueprintable)
@@ -49,6 +51,69 @@ struct FUniversalTaggedSlot
 	}
 };
 
+UENUM(BlueprintType)
+enum class ECraftingSourceOrder : uint8
+{
+	// Consume from the crafting inventory, then from the extra sources in the order given
+	OwnInventoryFirst,
+	// Consume from the extra sources in the order given, then from the crafting inventory
+	ExternalSourcesFirst,
+	// Per component, consume from whichever source holds the most of it first
+	LargestSourceFirst
+};
+
+// Summed quantity per distinct component ItemId for a single craft
+using FRISRecipeRequirements = TArray<TPair<FGameplayTag, int32>, TInlineAllocator<8>>;
+
+// One step of a crafting plan, sub recipes are ordered before the recipes that consume their output
+USTRUCT(BlueprintType)
+struct FRISCraftStep
+{
+	GENERATED_BODY()
+
+	FRISCraftStep() = default;
+	FRISCraftStep(const UObjectRecipeData* InRecipe, int32 InCount) : Recipe(const_cast<UObjectRecipeData*>(InRecipe)), Count(InCount) {}
+
+	UPROPERTY(BlueprintReadOnly, Category = "RIS | Crafting")
+	UObjectRecipeData* Recipe = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "RIS | Crafting")
+	int32 Count = 0;
+};
+
+// Queued crafts have their components consumed when queued, so Remaining is the number of crafts still owed
+USTRUCT(BlueprintType)
+struct FRISCraftQueueEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "RIS | Crafting")
+	UObjectRecipeData* Recipe = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "RIS | Crafting")
+	int32 Remaining = 0;
+
+	// Components consumed for the remaining crafts, instance data included so a refund restores them as they were
+	UPROPERTY()
+	TArray<FItemBundle> HeldComponents;
+};
+
+// Per unlocked recipe bookkeeping for incremental availability updates, not exposed to blueprints
+struct FRISRecipeAvailabilityState
+{
+	UObjectRecipeData* Recipe = nullptr;
+	FRISRecipeHandle Handle; // Components are read from the subsystems flattened ingredient arrays
+	int32 FirstComponentBit = 0; // Offset into RecipeComponentSatisfied for this recipes components
+	int32 MissingComponents = 0; // Recipe is craftable when this reaches 0
+};
+
+// Reverse index entry, one per recipe component, keyed by the components ItemId
+struct FRISRecipeIngredientRef
+{
+	int32 RecipeIndex = 0;
+	int32 ComponentIndex = 0;
+};
+
 UENUM(BlueprintType)
 enum class EPreferredSlotPolicy : uint8
 {
@@ -96,6 +161,9 @@ public:
 	UFUNCTION(BlueprintPure, Category = "RIS")
 	TArray<FTaggedItemBundle> GetAllTaggedItems() const;
 
+	/* Checksum of the content of every tagged slot, see FRISItemChecksum */
+	uint64 GetTaggedItemsChecksum() const;
+
 	UFUNCTION(BlueprintPure, Category=RIS)
 	int32 GetContainerOnlyItemQuantity(const FGameplayTag& ItemId) const;
 	
@@ -176,10 +244,25 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "RIS | Crafting")
 	bool CanCraftCraftingRecipe(const FPrimaryRISRecipeId& RecipeId) const;
+
+	// How many times the recipe can be crafted from the current contents, components sharing an ItemId are summed
+	UFUNCTION(BlueprintPure, Category = "RIS | Crafting")
+	int32 GetMaxCraftableCount(const UObjectRecipeData* Recipe) const;
+
+	// Same as GetMaxCraftableCount but also counting the contents of ExtraSources, e.g. nearby storage
+	UFUNCTION(BlueprintPure, Category = "RIS | Crafting")
+	int32 GetMaxCraftableCountFromSources(const UObjectRecipeData* Recipe, const TArray<TScriptInterface<IItemSource>>& ExtraSources) const;
+
+	/* Plans crafting Count of Recipe, crafting missing components from unlocked item recipes up to MaxDepth levels deep.
+	 * Returns false if no plan exists. OutSteps ends with Recipe itself */
+	bool PlanCraft(const UObjectRecipeData* Recipe, int32 Count, TArray<FRISCraftStep>& OutSteps, int32 MaxDepth = 4) const;
 	
 	UFUNCTION(BlueprintCallable, Category = "RIS | Recipes")
 	UObjectRecipeData* GetRecipeById(const FPrimaryRISRecipeId& RecipeId);
 
+	UFUNCTION(BlueprintPure, Category = "RIS | Recipes")
+	bool IsRecipeUnlocked(const FPrimaryRISRecipeId& RecipeId) const;
+
 	UFUNCTION(BlueprintCallable, Category = "RIS | Recipes")
 	TArray<UObjectRecipeData*> GetAvailableRecipes(FGameplayTag TagFilter);
 
@@ -187,6 +270,15 @@ public:
 	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "RIS | Crafting")
 	void CraftRecipeId_Server(const FPrimaryRISRecipeId& RecipeId);
 
+	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "RIS | Crafting")
+	void CraftRecipeIdQuantity_Server(const FPrimaryRISRecipeId& RecipeId, int32 Count, bool CraftIntermediates = false);
+
+	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "RIS | Crafting")
+	void QueueCraftRecipeId_Server(const FPrimaryRISRecipeId& RecipeId, int32 Count);
+
+	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "RIS | Crafting")
+	void CancelCraftQueue_Server();
+
 	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "RIS | Recipes")
 	void SetRecipeLock_Server(const FPrimaryRISRecipeId& RecipeId, bool LockState);
 
@@ -194,6 +286,31 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "RIS | Crafting")
 	bool CraftRecipe_IfServer(const UObjectRecipeData* Recipe);
 
+	/* Crafts Count of the recipe, or as many as possible if AllowPartial. Components for all crafts are validated
+	 * before anything is removed and are removed with a single weight/slot update. Returns the number crafted */
+	UFUNCTION(BlueprintCallable, Category = "RIS | Crafting")
+	int32 CraftRecipeQuantity_IfServer(const UObjectRecipeData* Recipe, int32 Count, bool AllowPartial = true);
+
+	/* Crafts from this inventory and ExtraSources as one planned operation, the result goes to this inventory.
+	 * Quantities are gathered with one pass per source and every component is validated before anything is consumed.
+	 * No range or ownership checks are done on the sources, that is up to the caller. Returns the number crafted */
+	UFUNCTION(BlueprintCallable, Category = "RIS | Crafting")
+	int32 CraftRecipeFromSources_IfServer(const UObjectRecipeData* Recipe, int32 Count, const TArray<TScriptInterface<IItemSource>>& ExtraSources,
+	                                      ECraftingSourceOrder SourceOrder = ECraftingSourceOrder::OwnInventoryFirst, bool AllowPartial = true);
+
+	// Crafts missing intermediate components from unlocked item recipes first. Either the whole plan is applied or nothing is
+	UFUNCTION(BlueprintCallable, Category = "RIS | Crafting")
+	bool CraftRecipeWithIntermediates_IfServer(const UObjectRecipeData* Recipe, int32 Count = 1);
+
+	/* Consumes the components of Count crafts immediately and produces one craft every Recipe->CraftingTime seconds
+	 * Returns the number of crafts queued */
+	UFUNCTION(BlueprintCallable, Category = "RIS | Crafting")
+	int32 QueueCraft_IfServer(const UObjectRecipeData* Recipe, int32 Count, bool AllowPartial = true);
+
+	// Returns the components of all crafts that have not completed yet, with their instance data
+	UFUNCTION(BlueprintCallable, Category = "RIS | Crafting")
+	void CancelCraftQueue_IfServer();
+
 
 	////////////////// ACTIONS ///////////////////
 	// == CLIENT INTERFACE (Other Actions) ==
@@ -233,10 +350,19 @@ public: // For Events and Vars section, following base class structure
 	UPROPERTY(BlueprintAssignable, Category = "RIS | Equipment")
 	FOnCraftConfirmed OnCraftConfirmed;
 
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnCraftQueueUpdated);
+	UPROPERTY(BlueprintAssignable, Category = "RIS | Crafting")
+	FOnCraftQueueUpdated OnCraftQueueUpdated;
+
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnAvailableRecipesUpdated);
 	UPROPERTY(BlueprintAssignable, Category = "RIS | Equipment")
 	FOnAvailableRecipesUpdated OnAvailableRecipesUpdated;
 
+	// Fired once per recipe whose craftability flipped, before OnAvailableRecipesUpdated
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRecipeAvailabilityChanged, UObjectRecipeData*, Recipe, bool, IsAvailable);
+	UPROPERTY(BlueprintAssignable, Category = "RIS | Recipes")
+	FOnRecipeAvailabilityChanged OnRecipeAvailabilityChanged;
+
 	// --- PUBLIC CONFIGURABLE UPROPERTIES ---
 	// Tagged Slot Configuration
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RIS | Equipment")
@@ -249,11 +375,19 @@ public: // For Events and Vars section, following base class structure
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RIS | Recipes")
 	FGameplayTagContainer RecipeTagFilters;
 
+	// Upper bound for the craft count of a single client request, counts from clients are clamped to it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RIS | Crafting", meta = (ClampMin = "1"))
+	int32 MaxCraftCountPerRequest = 1000;
+
 	// --- PUBLIC REPLICATED STATE UPROPERTIES ---
 	// Crafting State
 	UPROPERTY(ReplicatedUsing=OnRep_Recipes, EditAnywhere, BlueprintReadOnly, Category = "RIS | Recipes")
 	TArray<FPrimaryRISRecipeId> AllUnlockedRecipes;
 
+	// Server only, the head entry is the one currently being crafted
+	UPROPERTY(BlueprintReadOnly, Category = "RIS | Crafting")
+	TArray<FRISCraftQueueEntry> CraftQueue;
+
 protected:
 	// == SERVER RPC IMPLEMENTATIONS (for public UFUNCTION(Server, Reliable) stubs) ==
 	UFUNCTION(Server, Reliable, Category = "RIS | Equipment")
@@ -284,8 +418,9 @@ protected:
 										         const FGameplayTag& SourceTaggedSlot,
 										         const FGameplayTag& TargetTaggedSlot);
 	
+	// InstancesToMove may be the instance array of one of this components bundles, it is copied before the move then
 	int32 MoveItem_ServerImpl(const FGameplayTag& ItemId, int32 RequestedQuantity,
-	                          TArray<UItemInstanceData*> InstancesToMove,
+	                          const TArray<UItemInstanceData*>& InstancesToMove,
 							  const FGameplayTag& SourceTaggedSlot = FGameplayTag(),
 							  const FGameplayTag& TargetTaggedSlot = FGameplayTag(),
 							  bool AllowAutomaticSwapping = true,
@@ -298,7 +433,30 @@ protected:
 	void UpdateBlockingState(FGameplayTag SlotTag, const UItemStaticData* ItemData, bool IsEquip);
 	
 	// Crafting Logic
+	// Full rebuild of the ingredient index and availability, only needed when the unlocked recipes or filters change
 	void CheckAndUpdateRecipeAvailability();
+	// Re-evaluates only the recipes that use ItemId as a component, publishing the ones whose availability flipped
+	void UpdateRecipeAvailabilityForItem(const FGameplayTag& ItemId);
+	void HandleRecipeReregistered(FRISRecipeHandle Handle);
+	bool IsRecipeComponentSatisfied(const FGameplayTag& ItemId, int32 RequiredQuantity) const;
+	void SetRecipeAvailable(UObjectRecipeData* Recipe, bool IsAvailable);
+	static void GatherRecipeRequirements(const UObjectRecipeData* Recipe, FRISRecipeRequirements& OutRequirements);
+	/* Fills OutSources in consumption order and OutAvailable as a Sources x Requirements matrix.
+	 * Returns how many crafts the combined sources can supply */
+	int32 GatherCraftingSources(const FRISRecipeRequirements& Requirements, const TArray<TScriptInterface<IItemSource>>& ExtraSources, ECraftingSourceOrder SourceOrder,
+	                            TArray<UObject*, TInlineAllocator<16>>& OutSources, TArray<int32>& OutAvailable) const;
+	bool PlanCraftRecursive(const UObjectRecipeData* Recipe, int32 Count, TMap<FGameplayTag, int32>& VirtualStock, TArray<FRISCraftStep>& OutSteps, int32 DepthLeft) const;
+	// Removes the net consumed components of all steps with one weight/slot update, then adds the net produced items.
+	// Returns false without consuming anything if the container can't cover the steps
+	bool ApplyCraftSteps(const TArray<FRISCraftStep>& Steps);
+	void ConsumeRecipeComponents(const UObjectRecipeData* Recipe, int32 Count, TArray<FItemBundle>& OutHeldComponents);
+	void ProduceRecipeOutput(const UObjectRecipeData* Recipe, int32 Count);
+	// Adds to the container, dropping whatever does not fit
+	void AddOrDropItem_ServerImpl(const FGameplayTag& ItemId, int32 Quantity);
+	void ScheduleNextQueuedCraft();
+	void OnCraftQueueTimer();
+	// Empties the queue, giving the held components of all unfinished crafts back or dropping them
+	void RefundCraftQueue_ServerImpl();
 
 	// Internal Query Helpers (used by server logic)
 	bool ContainedInUniversalSlot(const FGameplayTag& TagToFind) const;
@@ -306,8 +464,10 @@ protected:
 
 	// == OVERRIDES OF BASE PROTECTED VIRTUALS ==
 	virtual void UpdateWeightAndSlots() override;
+	virtual int32 GetGridItemQuantity(const FItemBundle& Item) const override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	virtual int32 DropAllItems_ServerImpl() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual int32 DestroyItemImpl(const FGameplayTag& ItemId, int32 Quantity, TArray<UItemInstanceData*> InstancesToDestroy, EItemChangeReason Reason, bool AllowPartial = false, bool SuppressEvents = false, bool SuppressUpdate = false) override;
 	virtual void ClearServerImpl() override;
 	virtual int32 ExtractItem_ServerImpl(const FGameplayTag& ItemId, int32 Quantity, const TArray<UItemInstanceData*>& InstancesToExtract, EItemChangeReason Reason, TArray<UItemInstanceData*>& InstanceArrayToAppendTo, bool AllowPartial, bool SuppressEvents, bool SuppressUpdate) override;
@@ -334,6 +494,13 @@ protected:
 
 	// --- PROTECTED NON-REPLICATED INTERNAL STATE ---
 	TMap<FGameplayTag, TArray<UObjectRecipeData*>> CurrentAvailableRecipes;
+	TArray<FRISRecipeAvailabilityState> TrackedRecipes;
+	TMap<FGameplayTag, TArray<FRISRecipeIngredientRef>> RecipesByIngredient; // Component ItemId -> recipes using it
+	TBitArray<> RecipeComponentSatisfied;
+	TBitArray<> UnlockedRecipeBits; // Indexed by recipe registry handle, mirrors AllUnlockedRecipes
+	TMap<FGameplayTag, const UItemRecipeData*> UnlockedItemRecipesByResult; // Used by the planner to find intermediates
+	FDelegateHandle RecipeReregisteredHandle;
+	FTimerHandle CraftQueueTimer;
 	TMap<FGameplayTag, FItemBundle> CachedTaggedSlotItems; // For client-side change detection for tagged slots
 
 private:
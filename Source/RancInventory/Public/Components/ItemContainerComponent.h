@@ -7,6 +7,7 @@
 #include "Core/IItemSource.h"
 #include "Data/RISDataTypes.h"
 #include "Data/ItemStaticData.h"
+#include "Data/JigsawGrid.h"
 #include "ViewModels/RISNetworkingData.h"
 #include "ItemContainerComponent.generated.h"
 
@@ -84,6 +85,9 @@ public:
 	UFUNCTION(BlueprintPure, Category=RIS)
 	TArray<FItemBundle> GetAllItems() const;
 	
+	/* Checksum of the quantity of every item, see FRISItemChecksum. Updated together with weight and slots */
+	uint64 GetItemsChecksum() const { return ItemsChecksum; }
+	
 	/* Returns copy of all items instance data of the given type */
 	UFUNCTION(BlueprintPure, Category=RIS)
 	TArray<UItemInstanceData*> GetItemInstanceData(const FGameplayTag& ItemId) const;
@@ -102,7 +106,7 @@ public:
 	 * @param RequestedQuantity The quantity to add (ignored if InstancesToExtract is not empty).
 	 * @param AllowPartial If true, allows adding fewer items than requested if capacity or source is limited.
 	 * @param SuppressEvents If true, suppresses broadcasting OnItemAddedToContainer event.
-	 * @param SuppressUpdate If true, suppresses updating weight/slots after adding.
+	 * @param SuppressUpdate If true, weight/slots are only adjusted incrementally and the caller must do the full update and dirty ItemsVer.
 	 * @return The actual quantity of items successfully added to this container. */
 	UFUNCTION(BlueprintCallable, Category = RIS, meta = (AutoCreateRefTerm = "InstancesToExtract"))
 	int32 AddItem_IfServer(
@@ -114,6 +118,12 @@ public:
 		bool SuppressUpdate = false
 	);
 
+	/* Adds several items from the same source as one batch, e.g. generated loot.
+	 * Each item is added like AddItem_IfServer with SuppressUpdate, followed by a single full weight/slot update and replication dirty mark.
+	 * @return The total quantity of items successfully added to this container. */
+	UFUNCTION(BlueprintCallable, Category = RIS)
+	int32 AddItems_IfServer(TScriptInterface<IItemSource> ItemSource, const TArray<FItemBundle>& Items, bool AllowPartial = true, bool SuppressEvents = false);
+
 	/* Adds items to this container, extracting them from the specified source.
 	 * Cannot be called on clients, clients must use e.g. pickup or otherwise indirectly add item
 	 * Prioritizes extracting specific InstancesToExtract if provided, otherwise extracts by quantity.
@@ -123,7 +133,7 @@ public:
 	 * @param InstancesToExtract Specific instances to extract from the source and add to this container, usually not specified.
 	 * @param AllowPartial If true, allows adding fewer items than requested if capacity or source is limited.
 	 * @param SuppressEvents If true, suppresses broadcasting OnItemAddedToContainer event.
-	 * @param SuppressUpdate If true, suppresses updating weight/slots after adding.
+	 * @param SuppressUpdate If true, weight/slots are only adjusted incrementally and the caller must do the full update and dirty ItemsVer.
 	 * @return The actual quantity of items successfully added to this container. */
 	UFUNCTION(BlueprintCallable, Category = RIS, meta = (AutoCreateRefTerm = "InstancesToExtract"))
 	virtual int32 AddItemWithInstances_IfServer(
@@ -193,14 +203,30 @@ public:
 	
 	virtual int32 ExtractItem_IfServer_Implementation(const FGameplayTag& ItemId, int32 Quantity, const TArray<UItemInstanceData*>& InstancesToExtract, EItemChangeReason Reason, TArray<UItemInstanceData*>& StateArrayToAppendTo, bool AllowPartial) override;
 
-	/* Useful for e.g. Death, drops items evenly spaced in a circle with radius DropDistance */
+	/* Useful for e.g. Death, drops one world item per stack (or per item type with bDropAllItemsMergesStacks) packed on rings around the owner starting at DefaultDropDistance.
+	 * The items leave the container right away, spawning is spread over frames according to DropAllItemsFrameBudgetMs */
 	UFUNCTION(BlueprintCallable, Category=RIS)
 	int32 DropAllItems_IfServer();
+
+	// World items DropAllItems has not spawned yet
+	UFUNCTION(BlueprintPure, Category=RIS)
+	int32 GetNumPendingWorldDrops() const { return PendingWorldDrops.Num(); }
 	
     // Removes all items and publishes the removals
     UFUNCTION(BlueprintCallable, Category=RIS)
     void Clear_IfServer();
 
+	/* Moves as much of every item as Target can hold straight into Target, items held in tagged slots stay.
+	 * Both containers update their weight and slots and replicate once. Returns the total quantity moved */
+	UFUNCTION(BlueprintCallable, Category=RIS)
+	int32 TransferAllItemsTo_IfServer(UItemContainerComponent* Target);
+
+	/* Reorders the contained items by category, type, value and weight (see FRISItemSortKey).
+	 * Only the order changes so this is a single replicated update without add/remove events,
+	 * view models created afterwards lay their grid out in this order */
+	UFUNCTION(BlueprintCallable, Category=RIS)
+	void SortItems_IfServer();
+
 protected:
 
 	// Protected Add
@@ -222,8 +248,14 @@ protected:
 	void DropItemFromContainer_Server(const FGameplayTag& ItemId, int32 Quantity, const TArray<int32>& InstanceIdsToDrop, FVector RelativeDropLocation = FVector(1e+300, 0,0));
 	void DropItemFromContainer_ServerImpl(FGameplayTag ItemId, int32 Quantity, const TArray<UItemInstanceData*>& InstancesToDrop, FVector RelativeDropLocation = FVector(1e+300, 0,0));
 
-	// Drops all items, respecting stack sizes. Returns number of worlditems created			
+	// Drops all items, one world item per stack or per item type with bDropAllItemsMergesStacks. Returns number of worlditems queued			
 	virtual int32 DropAllItems_ServerImpl();
+
+	// Queues an item that already left the container for the drop scheduler, placing it on the next free ring position
+	void QueueWorldDrop(const FGameplayTag& ItemId, int32 Quantity, TArray<UItemInstanceData*>&& Instances);
+
+	// Spawns queued drops on the ground below their positions until the frame budget is used up, reschedules itself for the next frame if any remain
+	void SpawnPendingWorldDrops();
 	
 	UFUNCTION(Server, Reliable)
 	void UseItem_Server(const FGameplayTag& ItemId, int32 ItemToUseUniqueId = -1);
@@ -237,6 +269,9 @@ protected:
 	virtual int32 ExtractItem_ServerImpl(const FGameplayTag& ItemId, int32 Quantity, const TArray<UItemInstanceData*>& InstancesToExtract, EItemChangeReason Reason, TArray<UItemInstanceData*>& StateArrayToAppendTo, bool AllowPartial, bool SuppressEvents = false, bool SuppressUpdate = false);
 
 	// == OTHER ==
+
+	// Spawns what is left of the drop queue so the items are not lost with the owner
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	const FItemBundle* FindItemInstance(const FGameplayTag& ItemId) const;
 	
@@ -245,6 +280,17 @@ protected:
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	
 	virtual void UpdateWeightAndSlots();
+
+	// Quantity of the item that takes up grid space, inventories leave out what is in tagged slots
+	virtual int32 GetGridItemQuantity(const FItemBundle& Item) const { return Item.Quantity; }
+
+	// Keeps the packed jigsaw layout in line with the items, only items whose stack count changed are placed or removed
+	void UpdateJigsawGrid();
+	// Places or removes stacks of one item until the grid holds NewStackCount of them, ItemId is only used if ItemData is null
+	void SetJigsawStackCount(const UItemStaticData* ItemData, int32 NewStackCount, FGameplayTag ItemId = FGameplayTag());
+	FRISJigsawGrid JigsawGrid;
+	// Stacks of each item the jigsaw grid was last updated for
+	TMap<FGameplayTag, int32> JigsawStackCounts;
     
 	void RebuildItemsToCache();
 	
@@ -259,6 +305,16 @@ protected:
 	 * Called only by MoveBetweenContainers_ServerImpl
 	 */
 	virtual int32 ReceiveExtractedItems_IfServer(const FGameplayTag& ItemId, int32 Quantity, const TArray<UItemInstanceData*>& ReceivedInstances, bool SuppressEvents = false);
+
+	/* Moves items from this containers generic items straight into Target without the extract/receive round trip.
+	 * Capacity is validated once against Target and instance pointers are handed over and re-registered in one pass.
+	 * Instanced items that are partly held in tagged slots are not moved since the tagged instances can't be told apart here.
+	 * Always allows partial, returns the quantity moved.
+	 * With SuppressUpdate weight and slots are adjusted incrementally and the caller must dirty ItemsVer of both containers */
+	int32 TransferItemTo_ServerImpl(UItemContainerComponent* Target, const FGameplayTag& ItemId, int32 Quantity, const TArray<UItemInstanceData*>& InstancesToMove, bool SuppressEvents = false, bool SuppressUpdate = false);
+
+	// Applies the quantity change of one item to weight, used slots and checksum without rescanning all items
+	void AdjustWeightAndSlots(const UItemStaticData* ItemData, int32 OldQuantity, int32 NewQuantity);
 	
 	// === EVENTS AND VARS ===
 	
@@ -280,6 +336,19 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=RIS)
     TSubclassOf<AWorldItem> DropItemClass = AWorldItem::StaticClass();
 
+    /* Milliseconds per frame DropAllItems may spend spawning world items, at least one is spawned per frame.
+     * 0 spawns everything in the same frame. Only used on server */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=RIS, meta = (ClampMin = "0"))
+    float DropAllItemsFrameBudgetMs = 0;
+
+    /* Distance DropAllItems keeps between the dropped world items. Only used on server */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=RIS, meta = (ClampMin = "1"))
+    float DropAllItemsSpacing = 50;
+
+    /* If set DropAllItems drops everything of one item type as a single world item instead of one per MaxStackSize stack. Only used on server */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=RIS)
+    bool bDropAllItemsMergesStacks = false;
+
     /* Max weight allowed for this item container, this also applies to any child classes */
     UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Ranc Inventory", meta = (ClampMin = "1", UIMin = "1"))
     float MaxWeight = 999999;
@@ -290,11 +359,19 @@ public:
     int32 MaxSlotCount = MAX_int32;
 	
 	/* Set whether the container should be configured to a diablo-like jigsaw style
-	 * Note that the inventory/container doesn't actually respect the jigsaw puzzle, only the number of slots.
-	 * This is so that we dont need to replicate the players setup to the server
-	 * The client only viewmodel will handle keeping track of jigsaw configuration displayed */
+	 * The container packs its items into a JigsawGridWidth wide grid to check that new items physically fit.
+	 * That packing is never replicated so we dont need to replicate the players setup to the server,
+	 * the client only viewmodel keeps track of the jigsaw configuration displayed */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Ranc Inventory")
 	bool JigsawMode = false;
+
+	/* Columns of the jigsaw grid, the grid has MaxSlotCount / JigsawGridWidth rows rounded up, cells of the last row past MaxSlotCount stay blocked */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Ranc Inventory", meta = (ClampMin = "1", UIMin = "1", ClampMax = "64", UIMax = "64", EditCondition = "JigsawMode"))
+	int32 JigsawGridWidth = 10;
+
+	/* Whether jigsaw items may be turned sideways to fit */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Ranc Inventory", meta = (EditCondition = "JigsawMode"))
+	bool JigsawAllowRotation = true;
 	
 	UPROPERTY(BlueprintReadOnly, Category=RIS)
 	int32 UsedContainerSlotCount = 0;
@@ -317,6 +394,17 @@ protected:
 	// The last known state of items, used to detect changes after replication, only used on client
 	UPROPERTY(ReplicatedUsing=OnRep_Items, BlueprintReadOnly, Category=RIS)
 	FVersionedItemInstanceArray CachedItemsVer;
+
+	// Sum of FRISItemChecksum contributions of ItemsVer, recomputed by UpdateWeightAndSlots
+	uint64 ItemsChecksum = 0;
+
+	// Dropped items waiting for frame budget, only used on server
+	UPROPERTY(Transient)
+	TArray<FRISPendingWorldDrop> PendingWorldDrops;
+
+	// Ring position of the next queued drop, restarts once the queue is empty
+	int32 NextDropPlacementIndex = 0;
+	float DropPlacementStartAngle = 0;
 	
 	FAddItemValidationDelegate OnValidateAddItem;
 
@@ -359,4 +447,5 @@ public:
 
 	friend class UInventoryComponent; // Necessary for MoveBetweenContainers_ServerImpl as protected doesnt work for static functions
 	friend class FInventoryComponentTestScenarios;
+	friend class FItemContainerTestScenarios;
 };
\ No newline at end of file
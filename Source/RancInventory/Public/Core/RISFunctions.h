@@ -57,7 +57,13 @@ public:
      * IgnoreMaxStacks will allow a target slot to go above the item datas maxstacksize (used for itemcontainer)
      * AllowPartial if enabled will allow a move to partially succeed, e.g. only move 2 of requested 3 quantity, if false moves full or nothing
      */
-    static FRISMoveResult MoveBetweenSlots(FGenericItemBundle& Source, FGenericItemBundle& Target, bool IgnoreMaxStacks, int32 RequestedQuantity, TArray<UItemInstanceData*> InstancesToMove, bool AllowPartial, bool AllowSwap = true);
+    static FRISMoveResult MoveBetweenSlots(FGenericItemBundle& Source, FGenericItemBundle& Target, bool IgnoreMaxStacks, int32 RequestedQuantity, const TArray<UItemInstanceData*>& InstancesToMove, bool AllowPartial, bool AllowSwap = true);
+
+    /* Allocation free variant for hot paths, returns the quantity moved. Whole stacks and swaps hand over the instance arrays,
+     * partial moves only allocate if the target instances have to grow.
+     * Moved instances always end up at the end of the target instances, OutMovedInstances views them and is only valid until Target changes */
+    static int32 MoveBetweenSlots(FGenericItemBundle& Source, FGenericItemBundle& Target, bool IgnoreMaxStacks, int32 RequestedQuantity, const TArray<UItemInstanceData*>& InstancesToMove, bool AllowPartial, bool AllowSwap,
+                                  bool& OutWereItemsSwapped, TArrayView<UItemInstanceData* const>& OutMovedInstances);
     
     
     template<typename Ty>
@@ -10,6 +10,15 @@
 // Forward declarations
 class UItemStaticData;
 class UObjectRecipeData;
+class UItemContainerComponent;
+
+// Registry bookkeeping for one recipe, its ingredients live in URISSubsystem's flattened ingredient arrays
+struct FRISRecipeRegistryEntry
+{
+    FPrimaryAssetId RecipeId;
+    int32 FirstIngredient = 0;
+    int32 NumIngredients = 0;
+};
 
 UCLASS()
 class RANCINVENTORY_API URISSubsystem : public UGameInstanceSubsystem, public IItemSource
@@ -64,12 +73,45 @@ public:
     UFUNCTION(BlueprintPure, Category = "RIS")
     static UItemStaticData* GetItemDataById(FGameplayTag TagId);
 
+    // Recipe Registry
+    // Handles index AllLoadedRecipes, so they are only stable within the running process.
+    // Resolving through the registry avoids both the asset manager lookup and rebuilding the recipes primary id string
+    UFUNCTION(BlueprintPure, Category = "RIS")
+    static UObjectRecipeData* GetRecipeDataById(const FPrimaryRISRecipeId& RecipeId);
+
+    // Registers recipes that were loaded outside the subsystem on first lookup
+    static FRISRecipeHandle ResolveRecipeHandle(const FPrimaryAssetId& RecipeId);
+    static UObjectRecipeData* GetRecipeByHandle(FRISRecipeHandle Handle);
+    static const FPrimaryAssetId& GetRecipeIdByHandle(FRISRecipeHandle Handle);
+    static TConstArrayView<FGameplayTag> GetRecipeIngredientIds(FRISRecipeHandle Handle);
+    static TConstArrayView<int32> GetRecipeIngredientQuantities(FRISRecipeHandle Handle);
+    static int32 GetNumRegisteredRecipes() { return AllLoadedRecipes.Num(); }
+
+    // Fired when a recipe id that is already registered is registered again, its ingredients may have changed.
+    // Anything indexing ingredients by handle and component index has to rebuild that index
+    DECLARE_MULTICAST_DELEGATE_OneParam(FOnRecipeReregistered, FRISRecipeHandle);
+    static FOnRecipeReregistered OnRecipeReregistered;
+
     UFUNCTION(BlueprintCallable, Category = "RIS")
     UItemStaticData* GetSingleItemDataById(const FPrimaryRISItemId& InID, const TArray<FName>& InBundles, const bool bAutoUnload = true);
 
     UFUNCTION(BlueprintCallable, Category = "RIS")
     TArray<UItemStaticData*> GetItemDataArrayById(const TArray<FPrimaryRISItemId>& InIDs, const TArray<FName>& InBundles, const bool bAutoUnload = true);
 
+    // Loot Tables
+    // Missing weights count as 1, selections with a weight of 0 or less can never be picked
+    UFUNCTION(BlueprintCallable, Category = "RIS | Loot")
+    static FRISCompiledLootTable CompileLootTable(const FRandomItemPool& Pool);
+
+    /* Picks Rolls times and rolls the dice of each pick for its quantity, identical items are merged into one bundle.
+     * The result only depends on the table and the stream state so seeded streams give reproducible loot */
+    static void RollLootTable(const FRISCompiledLootTable& Table, int32 Rolls, FRandomStream& Stream, TArray<FItemBundle>& OutLoot);
+
+    // Rolls the table and adds the loot to Target with one add per distinct item. Returns the total quantity added
+    UFUNCTION(BlueprintCallable, Category = "RIS | Loot")
+    int32 GenerateLootIntoContainer_IfServer(const FRISCompiledLootTable& Table, int32 Rolls, UItemContainerComponent* Target, int32 Seed);
+    int32 GenerateLootIntoContainerWithStream_IfServer(const FRISCompiledLootTable& Table, int32 Rolls, UItemContainerComponent* Target, FRandomStream& Stream);
+
     // Debugging and Testing
     void HardcodeItem(FGameplayTag ItemId, UItemStaticData* ItemData);
     void HardcodeRecipe(FGameplayTag RecipeId, UObjectRecipeData* RecipeData);
@@ -116,6 +158,13 @@ private:
     static TArray<FGameplayTag> AllItemIds;
     static TArray<UObjectRecipeData*> AllLoadedRecipes;
 
+    // Registering a recipe id that is already known replaces the recipe but keeps its handle, its ingredient range is reused or compacted away
+    static FRISRecipeHandle RegisterRecipe(UObjectRecipeData* Recipe);
+    static TArray<FRISRecipeRegistryEntry> RecipeRegistry; // Parallel to AllLoadedRecipes
+    static TMap<FPrimaryAssetId, int32> RecipeHandlesById;
+    static TArray<FGameplayTag> RecipeIngredientIds;
+    static TArray<int32> RecipeIngredientQuantities;
+
     UPROPERTY()
     TArray<UItemStaticData*> LoadedItemsHeldRefs;
     TArray<UObjectRecipeData*> LoadedRecipesHeldRefs;
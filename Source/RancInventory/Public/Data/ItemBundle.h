@@ -4,7 +4,6 @@
 
 #include <CoreMinimal.h>
 #include <GameplayTagContainer.h>
-#include <variant>
 
 #include "Data/ItemInstanceData.h"
 #include "ItemBundle.generated.h"
@@ -37,8 +36,8 @@ struct RANCINVENTORY_API FItemBundle
 	// Checks if at least QuantityToCheck exists AND all provided (if any) instances are contained
 	bool Contains(int32 QuantityToCheck, const TArray<UItemInstanceData*>& InstancesToCheck) const;
 	
-    static TArray<int32> ToInstanceIds(const TArray<UItemInstanceData*> Instances);
-	TArray<UItemInstanceData*> FromInstanceIds(const TArray<int32> InstanceIds) const;
+    static TArray<int32> ToInstanceIds(const TArray<UItemInstanceData*>& Instances);
+	TArray<UItemInstanceData*> FromInstanceIds(const TArray<int32>& InstanceIds) const;
 
     TArray<UItemInstanceData*> GetInstancesFromEnd(int32 Quantity) const;
 	
@@ -212,161 +211,54 @@ struct RANCINVENTORY_API FTaggedItemBundle
 };
 
 
-// Class to wrap any of the above item bundle types in a unified type since we cant use inheritance
+/* Wraps any of the above item bundle types in a unified type since we cant use inheritance for the USTRUCTs.
+ * Both bundles share the ItemId, Quantity and InstanceData core, the wrapper points straight at those fields
+ * so accessors are plain loads. The tagged bundle is kept for the slot specific fields */
 struct RANCINVENTORY_API FGenericItemBundle
 {
-    using BundleVariant = std::variant<FItemBundle*, FTaggedItemBundle*, std::monostate>;
-    
-    BundleVariant Data;
-
-    FGenericItemBundle() : Data(std::monostate{}) {}  // Initialize with monostate instead of nullptr
-    FGenericItemBundle(FItemBundle* Bundle) : Data(Bundle ? Bundle : BundleVariant(std::monostate{})) {}
-    FGenericItemBundle(FTaggedItemBundle* Bundle) : Data(Bundle ? Bundle : BundleVariant(std::monostate{})) {}
-
-    bool IsValid() const 
+    FGenericItemBundle() = default;
+    FGenericItemBundle(FItemBundle* Bundle)
     {
-        if (std::holds_alternative<std::monostate>(Data)) return false;
-        return std::visit([](auto&& arg) -> bool {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, std::monostate>)
-                return false;
-            else
-                return arg && arg->ItemId.IsValid();
-        }, Data);
+        if (Bundle) BindCore(Bundle->ItemId, Bundle->Quantity, Bundle->InstanceData);
     }
-
-	bool Contains(int32 QuantityToCheck, const TArray<UItemInstanceData*>& InstancesToCheck) const 
+    FGenericItemBundle(FTaggedItemBundle* Bundle) : TaggedBundle(Bundle)
     {
-    	if (std::holds_alternative<std::monostate>(Data)) return false;
-    	return std::visit([QuantityToCheck, InstancesToCheck](auto&& arg) -> bool {
-			using T = std::decay_t<decltype(arg)>;
-			if constexpr (std::is_same_v<T, std::monostate>)
-				return false;
-			else
-				return arg && arg->Contains(QuantityToCheck, InstancesToCheck);
-		}, Data);
+        if (Bundle) BindCore(Bundle->ItemId, Bundle->Quantity, Bundle->InstanceData);
     }
 
-    FGameplayTag GetItemId() const 
-    {
-        if (std::holds_alternative<std::monostate>(Data)) return FGameplayTag();
-        return std::visit([](auto&& arg) -> FGameplayTag {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, std::monostate>)
-                return FGameplayTag();
-            else
-                return arg ? arg->ItemId : FGameplayTag();
-        }, Data);
-    }
+    bool IsValid() const { return ItemId && ItemId->IsValid(); }
 
-    int32 GetQuantity() const 
-    {
-        if (std::holds_alternative<std::monostate>(Data)) return 0;
-        return std::visit([](auto&& arg) -> int32 {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, std::monostate>)
-                return 0;
-            else
-                return arg ? arg->Quantity : 0;
-        }, Data);
-    }
+    bool Contains(int32 QuantityToCheck, const TArray<UItemInstanceData*>& InstancesToCheck) const;
 
-	TArray<UItemInstanceData*>* GetInstances() const 
-	{
-		if (std::holds_alternative<std::monostate>(Data)) return nullptr;
-		return std::visit([]<typename T0>(T0&& arg) -> TArray<UItemInstanceData*>* {
-			using T = std::decay_t<T0>;
-			if constexpr (std::is_same_v<T, std::monostate>)
-				return nullptr;
-			else
-				return arg ? &arg->InstanceData : nullptr;
-		}, Data);
-	}
+    FGameplayTag GetItemId() const { return ItemId ? *ItemId : FGameplayTag(); }
+    int32 GetQuantity() const { return Quantity ? *Quantity : 0; }
+    TArray<UItemInstanceData*>* GetInstances() const { return Instances; }
 
-	TArray<UItemInstanceData*> FromInstanceIds(TArray<int32> Ids) const 
-    {
-    	if (std::holds_alternative<std::monostate>(Data)) return TArray<UItemInstanceData*>();
-    	return std::visit([Ids]<typename T0>(T0&& arg) -> TArray<UItemInstanceData*> {
-			using T = std::decay_t<T0>;
-			if constexpr (std::is_same_v<T, std::monostate>)
-				return TArray<UItemInstanceData*>();
-			else
-				return arg ? arg->FromInstanceIds(Ids) : TArray<UItemInstanceData*>();
-		}, Data);
-    }
+    TArray<UItemInstanceData*> FromInstanceIds(const TArray<int32>& Ids) const;
 
-    void SetQuantity(int32 NewQuantity) 
-    {
-        if (std::holds_alternative<std::monostate>(Data)) return;
-        std::visit([NewQuantity](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (!std::is_same_v<T, std::monostate>)
-                if (arg) arg->Quantity = NewQuantity;
-        }, Data);
-    }
+    void SetQuantity(int32 NewQuantity) { if (Quantity) *Quantity = NewQuantity; }
+    void SetItemId(const FGameplayTag& NewId) { if (ItemId) *ItemId = NewId; }
+    void SetInstances(const TArray<UItemInstanceData*>& NewInstances) { if (Instances) *Instances = NewInstances; }
 
-    void SetItemId(const FGameplayTag& NewId) 
-    {
-        if (std::holds_alternative<std::monostate>(Data)) return;
-        std::visit([&NewId](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (!std::is_same_v<T, std::monostate>)
-                if (arg) arg->ItemId = NewId;
-        }, Data);
-    }
-	
-	void SetInstances(const TArray<UItemInstanceData*>& NewInstances)
-	{
-		if (std::holds_alternative<std::monostate>(Data)) return;
-		std::visit([&NewInstances](auto&& arg) {
-    				using T = std::decay_t<decltype(arg)>;
-					if constexpr (!std::is_same_v<T, std::monostate>)
-						if (arg) arg->InstanceData = NewInstances;
-				}, Data);
-    }
-	
-	bool IsBlocked() const 
-    {
-    	// Return false if bundle is FTaggedItemBundle and IsBlocked is true
-    	return std::visit([](auto&& arg) -> bool {
-			using T = std::decay_t<decltype(arg)>;
-			if constexpr (std::is_same_v<T, FTaggedItemBundle*>)
-			{
-				return arg ? arg->IsBlocked : false;
-			}
-			else
-			{
-				return false;
-			}
-		}, Data);
-    }
+    // Returns true if the bundle is a blocked FTaggedItemBundle
+    bool IsBlocked() const { return TaggedBundle && TaggedBundle->IsBlocked; }
 
-	// Gets tag if bundle is FTaggedItemBundle
-	FGameplayTag GetSlotTag() const
-    {
-    	return std::visit([](auto&& arg) -> FGameplayTag {
-			using T = std::decay_t<decltype(arg)>;
-			if constexpr (std::is_same_v<T, FTaggedItemBundle*>)
-			{
-				return arg ? arg->Tag : FGameplayTag();
-			}
-			else
-			{
-				return FGameplayTag();
-			}
-		}, Data);
-    }
+    // Gets tag if bundle is FTaggedItemBundle
+    FGameplayTag GetSlotTag() const { return TaggedBundle ? TaggedBundle->Tag : FGameplayTag(); }
+
+    // Sets tag if bundle is FTaggedItemBundle
+    void SetSlotTag(const FGameplayTag& NewTag) { if (TaggedBundle) TaggedBundle->Tag = NewTag; }
 
-	// Sets tag if bundle is FTaggedItemBundle
-	void SetSlotTag(const FGameplayTag& NewTag)
+private:
+    void BindCore(FGameplayTag& InItemId, int32& InQuantity, TArray<UItemInstanceData*>& InInstances)
     {
-    	std::visit([&NewTag](auto&& arg) {
-			using T = std::decay_t<decltype(arg)>;
-			if constexpr (std::is_same_v<T, FTaggedItemBundle*>)
-			{
-				if (arg) arg->Tag = NewTag;
-			}
-		}, Data);
+        ItemId = &InItemId;
+        Quantity = &InQuantity;
+        Instances = &InInstances;
     }
 
+    FGameplayTag* ItemId = nullptr;
+    int32* Quantity = nullptr;
+    TArray<UItemInstanceData*>* Instances = nullptr;
+    FTaggedItemBundle* TaggedBundle = nullptr;
 };
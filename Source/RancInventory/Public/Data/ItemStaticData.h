@@ -136,3 +136,43 @@ public:
 			return nullptr;
 		}
 };
+
+/* Cached sort order of an item type, used when sorting containers and grids.
+ * Orders by category (first tag of ItemCategories), primary type, then most valuable and heaviest first.
+ * Items without a category or type go after those that have one */
+struct FRISItemSortKey
+{
+	FName Category;
+	FName Type;
+	float Value = 0;
+	float Weight = 0;
+	FName ItemId;
+
+	FRISItemSortKey() = default;
+	explicit FRISItemSortKey(const UItemStaticData* ItemData)
+	{
+		if (!ItemData) return;
+		
+		Category = ItemData->ItemCategories.IsEmpty() ? NAME_None : ItemData->ItemCategories.First().GetTagName();
+		Type = ItemData->ItemPrimaryType.GetTagName();
+		Value = ItemData->ItemValue;
+		Weight = ItemData->ItemWeight;
+		ItemId = ItemData->ItemId.GetTagName();
+	}
+
+	bool operator<(const FRISItemSortKey& Other) const
+	{
+		if (const int32 Order = CompareNames(Category, Other.Category)) return Order < 0;
+		if (const int32 Order = CompareNames(Type, Other.Type)) return Order < 0;
+		if (Value != Other.Value) return Value > Other.Value;
+		if (Weight != Other.Weight) return Weight > Other.Weight;
+		return CompareNames(ItemId, Other.ItemId) < 0;
+	}
+
+private:
+	static int32 CompareNames(const FName& A, const FName& B)
+	{
+		if (A.IsNone() || B.IsNone()) return A.IsNone() - B.IsNone();
+		return A.Compare(B);
+	}
+};
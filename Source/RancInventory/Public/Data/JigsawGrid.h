@@ -0,0 +1,66 @@
+// Copyright Rancorous Games, 2024
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <GameplayTagContainer.h>
+
+// One item stack occupying a rectangle of a jigsaw grid
+struct RANCINVENTORY_API FRISJigsawPlacement
+{
+	FGameplayTag ItemId;
+	FIntPoint Position = FIntPoint::ZeroValue; // Top left cell
+	FIntPoint Size = FIntPoint(1, 1); // Occupied size, already rotated
+	bool Rotated = false;
+};
+
+/* Occupancy bitmap for diablo-like jigsaw containers, each row is a 64 bit mask so grids are limited to 64 columns.
+ * Fits are searched first-fit from the top left, testing all columns of a row at once with the row masks */
+struct RANCINVENTORY_API FRISJigsawGrid
+{
+	static constexpr int32 MaxWidth = 64;
+
+	// Cells past InNumCells in row-major order stay occupied, for cell counts that don't fill the last row
+	void Init(int32 InWidth, int32 InHeight, int32 InNumCells = MAX_int32);
+	void Reset();
+
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	int32 GetNumCells() const { return FMath::Min(NumCells, Width * Height); }
+	int32 GetNumFreeCells() const;
+	const TArray<FRISJigsawPlacement>& GetPlacements() const { return Placements; }
+
+	bool IsCellOccupied(const FIntPoint& Cell) const;
+	bool CanPlaceAt(const FIntPoint& Position, const FIntPoint& Size) const;
+
+	// Finds the first free position for an item, rotation is only used if it fits earlier than the unrotated item
+	bool FindFit(const FIntPoint& ItemSize, bool AllowRotation, FIntPoint& OutPosition, bool& OutRotated) const;
+
+	// Returns the placement index, or INDEX_NONE if the item does not fit there
+	int32 Place(const FGameplayTag& ItemId, const FIntPoint& Position, const FIntPoint& ItemSize, bool Rotated);
+	int32 PlaceAnywhere(const FGameplayTag& ItemId, const FIntPoint& ItemSize, bool AllowRotation);
+
+	// Placement indices after the removed one shift down by one
+	void RemovePlacement(int32 PlacementIndex);
+	int32 FindPlacementAt(const FIntPoint& Position) const;
+	int32 FindPlacementCoveringCell(const FIntPoint& Cell) const;
+
+	// How many more items of this size fit when placed one after another, stops counting at MaxCount
+	int32 CountFits(const FIntPoint& ItemSize, bool AllowRotation, int32 MaxCount = MAX_int32) const;
+
+	/* Compacts the grid by re-placing every item, largest first. Placement indices are not preserved,
+	 * OutPreviousIndices receives the old index of each new placement.
+	 * Leaves the grid unchanged and returns false if the items cannot all be re-placed */
+	bool AutoArrange(bool AllowRotation, TArray<int32>* OutPreviousIndices = nullptr);
+
+private:
+	bool FindFitUnrotated(const FIntPoint& Size, FIntPoint& OutPosition) const;
+	void SetCells(const FIntPoint& Position, const FIntPoint& Size, bool Occupied);
+	uint64 GetColumnMask(int32 X, int32 SizeX) const;
+
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 NumCells = MAX_int32;
+	TArray<uint64> Rows; // Set bit = occupied cell
+	TArray<FRISJigsawPlacement> Placements;
+};
@@ -39,7 +39,7 @@ struct FRISMoveResult
     FRISMoveResult() = default;
     
     FRISMoveResult(int32 Quantity, bool Swapped) : QuantityMoved(Quantity), WereItemsSwapped(Swapped) {};
-    FRISMoveResult(int32 Quantity, bool Swapped, TArray<UItemInstanceData*> Instances) : QuantityMoved(Quantity), WereItemsSwapped(Swapped), InstancesMoved(Instances) {};
+    FRISMoveResult(int32 Quantity, bool Swapped, TArray<UItemInstanceData*> Instances) : QuantityMoved(Quantity), WereItemsSwapped(Swapped), InstancesMoved(MoveTemp(Instances)) {};
 
     
     UPROPERTY()
@@ -52,6 +52,28 @@ struct FRISMoveResult
 };
 
 
+// A world item DropAllItems has taken out of its container but not spawned yet
+USTRUCT()
+struct FRISPendingWorldDrop
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FItemBundle Item;
+
+    // Offset from the owner in the owners facing, the height is found by a ground trace when spawning
+    UPROPERTY()
+    FVector Offset = FVector::ZeroVector;
+};
+
+
+// Orders by type then name using FName comparisons instead of building "Type:Name" strings per compare
+inline bool PrimaryAssetIdLexicalLess(const FPrimaryAssetId& A, const FPrimaryAssetId& B)
+{
+    const int32 TypeOrder = A.PrimaryAssetType.GetName().Compare(B.PrimaryAssetType.GetName());
+    return TypeOrder != 0 ? TypeOrder < 0 : A.PrimaryAssetName.Compare(B.PrimaryAssetName) < 0;
+}
+
 USTRUCT(BlueprintType, Category = "RIS | Structs")
 struct FPrimaryRISItemId : public FPrimaryAssetId
 {
@@ -71,12 +93,12 @@ struct FPrimaryRISItemId : public FPrimaryAssetId
 
     bool operator>(const FPrimaryRISItemId& Other) const
     {
-        return ToString() > Other.ToString();
+        return Other < *this;
     }
 
     bool operator<(const FPrimaryRISItemId& Other) const
     {
-        return ToString() < Other.ToString();
+        return PrimaryAssetIdLexicalLess(*this, Other);
     }
 };
 
@@ -104,15 +126,33 @@ struct FPrimaryRISRecipeId : public FPrimaryAssetId
 
     bool operator>(const FPrimaryRISRecipeId& Other) const
     {
-        return ToString() > Other.ToString();
+        return Other < *this;
     }
 
     bool operator<(const FPrimaryRISRecipeId& Other) const
     {
-        return ToString() < Other.ToString();
+        return PrimaryAssetIdLexicalLess(*this, Other);
     }
 };
 
+// Compact index into the URISSubsystem recipe registry, only meaningful within the running process
+USTRUCT(BlueprintType, Category = "RIS | Structs")
+struct FRISRecipeHandle
+{
+    GENERATED_BODY()
+
+    FRISRecipeHandle() = default;
+    explicit FRISRecipeHandle(int32 InIndex) : Index(InIndex) {}
+
+    UPROPERTY()
+    int32 Index = INDEX_NONE;
+
+    bool IsValid() const { return Index != INDEX_NONE; }
+    bool operator==(const FRISRecipeHandle& Other) const { return Index == Other.Index; }
+    bool operator!=(const FRISRecipeHandle& Other) const { return Index != Other.Index; }
+    friend uint32 GetTypeHash(const FRISRecipeHandle& Handle) { return ::GetTypeHash(Handle.Index); }
+};
+
 USTRUCT(BlueprintType, Category = "RIS | Structs")
 struct FPrimaryRISItemIdContainer
 {
@@ -184,4 +224,50 @@ struct FRandomItemPool
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ranc Inventory")
     TArray<FRandomItemSelection> Items;
     // TArray<FRandomItemSelection> Items; old version had a struct but why cant we just use itembundle? i dont know what was in that struct originally
-};
\ No newline at end of file
+};
+
+/* A FRandomItemPool compiled into alias tables by URISSubsystem::CompileLootTable
+ * Each weighted pick costs one random index and one random fraction regardless of pool size */
+USTRUCT(BlueprintType, Category = "RIS | Structs")
+struct FRISCompiledLootTable
+{
+    GENERATED_BODY()
+
+    // Only selections with a positive weight and valid item data are kept
+    UPROPERTY()
+    TArray<FRandomItemSelection> Selections;
+
+    UPROPERTY()
+    TArray<float> Probability;
+
+    UPROPERTY()
+    TArray<int32> Alias;
+
+    bool IsValid() const { return Selections.Num() > 0; }
+};
+/* Order independent checksum of item quantities, the checksum of a set of items is the wrapping sum of each items contribution
+ * so it can be kept up to date by adding and subtracting contributions. Equal contents always give equal checksums */
+struct FRISItemChecksum
+{
+    static uint64 Contribution(const FGameplayTag& ItemId, int32 Quantity)
+    {
+        return Mix(GetTypeHash(ItemId)) * static_cast<uint64>(Quantity);
+    }
+
+    static uint64 TaggedContribution(const FGameplayTag& SlotTag, const FGameplayTag& ItemId, int32 Quantity, int32 NumInstances)
+    {
+        return Mix(HashCombine(GetTypeHash(SlotTag), GetTypeHash(ItemId)) | static_cast<uint64>(NumInstances) << 32) * static_cast<uint64>(Quantity);
+    }
+
+private:
+    // 64 bit finalizer so similar tag hashes don't give similar contributions
+    static uint64 Mix(uint64 Value)
+    {
+        Value ^= Value >> 33;
+        Value *= 0xff51afd7ed558ccdull;
+        Value ^= Value >> 33;
+        Value *= 0xc4ceb9fe1a85ec53ull;
+        Value ^= Value >> 33;
+        return Value | 1; // Odd so no quantity can cancel the contribution out
+    }
+};
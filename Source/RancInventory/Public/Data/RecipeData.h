@@ -5,6 +5,7 @@
 #include <CoreMinimal.h>
 #include <GameplayTagContainer.h>
 #include <Engine/DataAsset.h>
+#include <Misc/StringBuilder.h>
 #include "RecipeData.generated.h"
 
 // This class is used to define a recipe for crafting any object type, RIS helps you specify the class but not instantiating the object
@@ -18,14 +19,12 @@ public:
     
     FORCEINLINE virtual FPrimaryAssetId GetPrimaryAssetId() const override
     {
-        // Create a string by appending the resulting item ID to each component
-        FString ResultingItemIdString = ResultingObject ? ResultingObject->GetName() : FString("Null-");
-        for (const auto& Component : Components)
-        {
-            ResultingItemIdString += Component.ItemId.ToString();
-        }
-        
-        return FPrimaryRISRecipeId(TEXT("RancInventory_ItemRecipe"), *ResultingItemIdString);
+        TStringBuilder<256> AssetName;
+        if (ResultingObject)
+            AssetName << ResultingObject->GetFName();
+        else
+            AssetName << TEXT("Null-");
+        return MakeRecipeAssetId(AssetName);
     }
     
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "RIS", meta = (AssetBundles = "Data"))
@@ -34,6 +33,10 @@ public:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "RIS", meta = (AssetBundles = "Data"))
     int32 QuantityCreated = 1;
 
+    /* Seconds per craft when crafted through an inventory crafting queue, direct crafting is always instant */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "RIS", meta = (AssetBundles = "Data"))
+    float CraftingTime = 0.f;
+
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "RIS", meta = (AssetBundles = "Data"))
     TArray<FItemBundle> Components;
 
@@ -44,6 +47,17 @@ public:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "RIS", meta = (AssetBundles = "UI"))
     TSoftObjectPtr<UTexture2D> Icon;
 
+protected:
+    // Appends each component ItemId to the result name in a single buffer, the registry in URISSubsystem caches the result
+    FPrimaryAssetId MakeRecipeAssetId(FStringBuilderBase& AssetName) const
+    {
+        for (const auto& Component : Components)
+        {
+            AssetName << Component.ItemId.GetTagName();
+        }
+        
+        return FPrimaryRISRecipeId(TEXT("RancInventory_ItemRecipe"), *AssetName);
+    }
 };
 
 
@@ -61,14 +75,9 @@ public:
     
     FORCEINLINE virtual FPrimaryAssetId GetPrimaryAssetId() const override
     {
-        // Create a string by appending the resulting item ID to each component
-        FString ResultingItemIdString = ResultingItemId.ToString();
-        for (const auto& Component : Components)
-        {
-            ResultingItemIdString += Component.ItemId.ToString();
-        }
-        
-        return FPrimaryAssetId(TEXT("RancInventory_ItemRecipe"), *ResultingItemIdString);
+        TStringBuilder<256> AssetName;
+        AssetName << ResultingItemId.GetTagName();
+        return MakeRecipeAssetId(AssetName);
     }
 public:
     // Replaces use of ResultingItem
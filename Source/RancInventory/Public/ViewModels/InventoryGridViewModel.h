@@ -5,6 +5,7 @@
 #include "UObject/Object.h"
 #include "Data/ItemBundle.h"
 #include "Data/RISDataTypes.h"
+#include "Data/JigsawGrid.h"
 #include "RISNetworkingData.h"
 #include "GameplayTagContainer.h" // Added for FGameplayTag
 #include "Components/InventoryComponent.h" // Added for EPreferredSlotPolicy
@@ -17,6 +18,30 @@ class UItemStaticData;
 class AWorldItem;
 struct FTaggedItemBundle;
 
+/** Compact state of one grid slot of UInventoryGridViewModel. The grid is stored as these and FItemBundles are only built for the slots that are read */
+struct FRISGridSlotRecord
+{
+    int32 ItemHandle = INDEX_NONE; // Index into GridItemIds
+    int32 Quantity = 0;
+    int32 InstanceList = INDEX_NONE; // Index into GridInstanceLists, INDEX_NONE if the slot holds no instance data
+
+    bool operator==(const FRISGridSlotRecord& Other) const
+    {
+        return ItemHandle == Other.ItemHandle && Quantity == Other.Quantity && InstanceList == Other.InstanceList;
+    }
+    bool operator!=(const FRISGridSlotRecord& Other) const { return !(*this == Other); }
+};
+
+/** Instance data of one grid slot, only slots holding instanced items have one */
+USTRUCT()
+struct FRISGridSlotInstances
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<UItemInstanceData*> Instances;
+};
+
 /**
  * Unified View Model for displaying and interacting with Item Containers,
  * handling both grid-only containers and full inventories with tagged slots.
@@ -113,10 +138,76 @@ public:
 	/** Attempts to drop a quantity of an item from a grid or tagged slot into the world. */
 	UFUNCTION(BlueprintCallable, Category="ViewModel|Grid|Actions")
 	virtual int32 DropItem(FGameplayTag TaggedSlot, int32 GridSlotIndex, int32 Quantity);
+
+    /** Sorts the grid by category, type, value and weight and merges partial stacks of the same item.
+     * The grid layout only exists in the view model so this sends nothing to the server, the whole layout is applied at once
+     * and only slots whose content changed are broadcast. Returns false and leaves the grid unchanged if the result does not fit. */
+    UFUNCTION(BlueprintCallable, Category="ViewModel|Grid|Actions")
+    bool SortAndCompactGrid();
+
+    // --- Jigsaw (JigsawMode containers only) ---
+    // In jigsaw mode every grid slot index is a cell (Y * JigsawGridWidth + X) and items are stored in the slot of their top left cell
+
+    /** Number of cells per row of the jigsaw grid, 0 if the container is not in jigsaw mode. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ViewModel|Jigsaw")
+    int32 GetJigsawGridWidth() const { return JigsawLayout.GetWidth(); }
+
+    /** Size in cells of the item stored in a grid slot, rotation applied. (1,1) for empty slots or outside jigsaw mode. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ViewModel|Jigsaw")
+    FIntPoint GetJigsawItemSize(int32 SlotIndex) const;
+
+    /** Grid slot of the item covering a cell, -1 if the cell is free. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ViewModel|Jigsaw")
+    int32 GetJigsawSlotCoveringCell(int32 CellIndex) const;
+
+    /** Compacts the displayed jigsaw layout, largest items first. Returns false and leaves the layout unchanged if it cannot be compacted. */
+    UFUNCTION(BlueprintCallable, Category="ViewModel|Jigsaw")
+    bool AutoArrangeJigsaw();
 	
+    // --- Paging & Search (large grids) ---
+    // While paged, OnGridSlotUpdated only fires for slots on the visible page so widgets are only needed for that page.
+    // When another page is shown OnGridPageShown fires and its slots should be read with GetVisibleGridPageItems.
+    // Slots are stored as FRISGridSlotRecord, bundles are only built for the slots that are read so the rest of the grid costs no bundle copies
+
+    /** Splits the grid into pages of PageSize slots, 0 disables paging. */
+    UFUNCTION(BlueprintCallable, Category="ViewModel|Grid|Paging")
+    void SetGridPageSize(int32 PageSize);
+
+    UFUNCTION(BlueprintCallable, Category="ViewModel|Grid|Paging")
+    void SetVisibleGridPage(int32 PageIndex);
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ViewModel|Grid|Paging")
+    int32 GetNumGridPages() const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ViewModel|Grid|Paging")
+    int32 GetVisibleGridPage() const { return VisibleGridPage; }
+
+    /** Whether a grid slot is on the visible page, always true when not paged. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ViewModel|Grid|Paging")
+    bool IsGridSlotVisible(int32 SlotIndex) const;
+
+    /** Grid slots holding items that match the filters, in slot order. Filters are evaluated once per item type, not per slot.
+     * @param CategoryQuery Matched against the item categories, an empty query matches everything.
+     * @param NameFilter Case insensitive part of the item name, empty matches everything. */
+    UFUNCTION(BlueprintCallable, Category="ViewModel|Grid|Paging", meta = (AutoCreateRefTerm = "CategoryQuery"))
+    TArray<int32> FilterGridSlots(const FGameplayTagQuery& CategoryQuery, const FString& NameFilter) const;
+
+    /** Lowest grid slot holding the item, -1 if none. Kept per item type so no slots are scanned. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ViewModel|Grid|Paging")
+    int32 FindFirstGridSlotWithItem(const FGameplayTag& ItemId) const;
+
+    /** Bundles of the slots on the visible page, only that page is built. Every slot when not paged. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ViewModel|Grid|Paging")
+    TArray<FItemBundle> GetVisibleGridPageItems() const;
+
+    /** Slots per grid page, 0 if the grid is not paged. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="ViewModel|Grid|Paging")
+    int32 GridPageSize = 0;
+
     // --- State & Properties ---
 
-    /** Checks if the view model has reconciled all expected operations from the linked component. */
+    /** Checks if the view model has reconciled all expected operations from the linked component.
+     * Cheap enough to call every frame while settled, the full comparison only runs when the checksums disagree. */
     UFUNCTION(BlueprintCallable, Category="ViewModel|State")
 	virtual bool AssertViewModelSettled() const;
 
@@ -143,6 +234,11 @@ public:
     UPROPERTY(BlueprintAssignable, Category="ViewModel|Grid")
     FOnGridSlotUpdated OnGridSlotUpdated;
 
+    /** Delegate broadcast when another grid page becomes visible, its slots should be refreshed. */
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGridPageShown, int32, PageIndex);
+    UPROPERTY(BlueprintAssignable, Category="ViewModel|Grid|Paging")
+    FOnGridPageShown OnGridPageShown;
+
     /** Delegate broadcast when a tagged slot's visual representation is updated (Inventory only). */
     DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnTaggedSlotUpdated, const FGameplayTag&, SlotTag, const TArray<UItemInstanceData*>&, OldInstances);
     UPROPERTY(BlueprintAssignable, Category="ViewModel|Tagged")
@@ -184,14 +280,78 @@ protected:
     UFUNCTION(BlueprintNativeEvent, Category = "ViewModel")
     void ForceFullUpdate();
 
-    /** Array representing the visual state of the grid slots. */
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="ViewModel|Internal")
-    TArray<FItemBundle> ViewableGridSlots;
+    /** Visual state of the grid slots, the item ids are behind GridItemIds */
+    TArray<FRISGridSlotRecord> GridSlotRecords;
+
+    /** Instance data of the grid slots, unused lists are empty and listed in FreeGridInstanceLists */
+    UPROPERTY()
+    TArray<FRISGridSlotInstances> GridInstanceLists;
+    TArray<int32> FreeGridInstanceLists;
+
+    /** Builds the bundle shown in a grid slot, empty for invalid indices */
+    FItemBundle BuildGridItem(int32 SlotIndex) const;
+
+    /** Instance data shown in a grid slot, empty if it holds none */
+    const TArray<UItemInstanceData*>& GetGridSlotInstances(int32 SlotIndex) const;
+
+    /** Replaces the content of a grid slot and updates its index */
+    void SetGridItem(int32 SlotIndex, const FItemBundle& Item);
+
+    /** Clears the record if its quantity ran out, releases its instance list if empty, then updates the slot index */
+    void CommitGridSlot(int32 SlotIndex, const FRISGridSlotRecord& OldRecord);
+
+    TArray<UItemInstanceData*>& GetOrAddGridInstanceList(FRISGridSlotRecord& Record);
+    void ReleaseGridInstanceList(FRISGridSlotRecord& Record);
+
+    /** Bundles built by BuildGridItem so far, a measure of how much of the grid was copied out */
+    mutable int32 NumGridItemsBuilt = 0;
 
     /** Map representing the visual state of the tagged slots (Inventory only). */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="ViewModel|Internal")
     TMap<FGameplayTag, FItemBundle> ViewableTaggedSlots;
 
+    /** Updates the placement index for one grid slot. Must follow every change to GridSlotRecords, OldHandle and OldQuantity are what the index last saw */
+    void UpdateGridSlotIndex(int32 SlotIndex, int32 OldHandle, int32 OldQuantity);
+
+    /** Rebuilds the placement index from GridSlotRecords */
+    void RebuildGridSlotIndex();
+
+    /** Set bit means the grid slot is empty, FindGridSlotIndexForItem takes the first set bit */
+    TBitArray<> FreeGridSlots;
+
+    /** Ascending grid slot indices of non-full stacks per stackable item */
+    TMap<FGameplayTag, TArray<int32>> PartialGridStacks;
+
+    /** Displayed jigsaw layout, kept in line with GridSlotRecords by UpdateGridSlotIndex. Empty outside jigsaw mode */
+    FRISJigsawGrid JigsawLayout;
+
+    /** Whether an item could be put into an empty grid slot without overlapping, ignoring the items in the given slots */
+    bool CanJigsawItemFitAtSlot(const FGameplayTag& ItemId, int32 SlotIndex, TConstArrayView<int32> IgnoredSlots = {}) const;
+    FIntPoint SlotIndexToJigsawCell(int32 SlotIndex) const;
+
+    /** Per grid slot, the item whose PartialGridStacks list the slot is in. Empty tag if none */
+    TArray<FGameplayTag> IndexedPartialStackItems;
+
+    /** Broadcasts OnGridSlotUpdated unless the slot is on a page that is not visible */
+    void BroadcastGridSlotUpdated(int32 SlotIndex, const TArray<UItemInstanceData*>& OldInstances);
+
+    /** Item of each handle used in GridSlotRecords, handles are never released */
+    TArray<FGameplayTag> GridItemIds;
+    TMap<FGameplayTag, int32> GridItemHandles;
+    int32 GetGridItemHandle(const FGameplayTag& ItemId);
+
+    /** Per item handle, the lowest grid slot whose record has the handle. INDEX_NONE if none */
+    TArray<int32> FirstGridSlots;
+
+    int32 VisibleGridPage = 0;
+
+    /** Sum of the FRISItemChecksum contributions of the grid slots, kept by UpdateGridSlotIndex */
+    uint64 GridItemsChecksum = 0;
+
+    /** O(1) in the grid size comparison of the view model and component checksums. A mismatch does not prove
+     * a desync on its own, AssertViewModelSettled falls back to the full comparison to find out */
+    bool ChecksumsMatchLinkedComponent() const;
+
     /** Tracks pending operations expected from the linked component updates. */
     UPROPERTY(VisibleAnywhere, Category="ViewModel|Internal")
     TArray<FRISExpectedOperation> OperationsToConfirm;
@@ -0,0 +1,56 @@
+﻿// Copyright Rancorous Games, 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+
+// Counts game thread heap allocations while in scope by wrapping GMalloc, everything is forwarded to the wrapped allocator
+class FScopedAllocationCounter : public FMalloc
+{
+public:
+	FScopedAllocationCounter()
+		: InnerMalloc(GMalloc)
+	{
+		GMalloc = this;
+	}
+
+	virtual ~FScopedAllocationCounter() override
+	{
+		GMalloc = InnerMalloc;
+	}
+
+	int32 GetNumAllocations() const { return NumAllocations; }
+	void Reset() { NumAllocations = 0; }
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		CountAllocation();
+		return InnerMalloc->Malloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Count > 0)
+			CountAllocation();
+		return InnerMalloc->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+	virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+	virtual const TCHAR* GetDescriptiveName() override { return TEXT("RIS allocation counter"); }
+
+private:
+	void CountAllocation()
+	{
+		// Other threads keep allocating while a test runs, only the code under test is counted
+		if (IsInGameThread())
+			++NumAllocations;
+	}
+
+	FMalloc* InnerMalloc;
+	int32 NumAllocations = 0;
+};
@@ -12,9 +12,17 @@ class UTestDelegateForwardHelper : public UObject
 public:
 	TFunction<void()> CallFn;
 	TFunction<int(const FGameplayTag&, int32, const FGameplayTag&)> CallFuncItemToInt;
+	TFunction<void(int32, const TArray<UItemInstanceData*>&)> CallFuncGridSlot;
+	TFunction<void(AActor*, const FHitResult&)> CallFuncActorHit;
 	UFUNCTION()
 	void Dispatch() { CallFn(); }
 
 	UFUNCTION()
 	int32 DispatchItemToInt(const FGameplayTag& ItemId, int32 Quantity, const FGameplayTag& Slot) { return CallFuncItemToInt(ItemId, Quantity, Slot); }
+
+	UFUNCTION()
+	void DispatchGridSlot(int32 SlotIndex, const TArray<UItemInstanceData*>& OldInstances) { CallFuncGridSlot(SlotIndex, OldInstances); }
+
+	UFUNCTION()
+	void DispatchActorHit(AActor* HitActor, FHitResult HitResult) { CallFuncActorHit(HitActor, HitResult); }
 };
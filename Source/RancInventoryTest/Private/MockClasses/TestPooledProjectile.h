@@ -0,0 +1,33 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "TestPooledProjectile.generated.h"
+
+// Flies sideways relative to its spawn rotation, so pooled activation has to honor the template velocity direction
+UCLASS()
+class ATestPooledProjectile : public AActor
+{
+	GENERATED_BODY()
+public:
+
+	ATestPooledProjectile()
+	{
+		Collision = CreateDefaultSubobject<USphereComponent>(TEXT("Collision"));
+		Collision->InitSphereRadius(5.f);
+		RootComponent = Collision;
+
+		Movement = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("Movement"));
+		Movement->Velocity = FVector(0.f, 1.f, 0.f);
+		Movement->InitialSpeed = 1000.f;
+		Movement->bInitialVelocityInLocalSpace = true;
+		Movement->ProjectileGravityScale = 0.f;
+	}
+
+	UPROPERTY()
+	USphereComponent* Collision;
+
+	UPROPERTY()
+	UProjectileMovementComponent* Movement;
+};
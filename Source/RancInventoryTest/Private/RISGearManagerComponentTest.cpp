@@ -1,13 +1,24 @@
 // Copyright Rancorous Games, 2024
 
 #include "GearManagerComponent.h"
+#include "AttackReplaySubsystem.h"
+#include "LagCompensationSubsystem.h"
+#include "ProjectilePoolSubsystem.h"
+#include "ProjectileSimulationSubsystem.h"
+#include "RangedWeaponFiringComponent.h"
 #include "NativeGameplayTags.h"
 #include "Components/InventoryComponent.h"
 #include "Misc/AutomationTest.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
 #include "RISInventoryTestSetup.cpp" // Include for test item and tag definitions
 #include "WeaponActor.h"
 #include "Framework/DebugTestResult.h"
+#include "Framework/TestDelegateForwardHelper.h"
 #include "MockClasses/ItemHoldingCharacter.h"
+#include "MockClasses/TestPooledProjectile.h"
+#include "RecordingSystem/WeaponAttackRecorderComponent.h"
+#include "RecordingSystem/WeaponAttackRecorderDataTypes.h"
 
 #if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
 
@@ -684,6 +695,705 @@ public:
 		*/
 		return Res;
 	} 
+
+	bool TestAttackReplayScheduler()
+	{
+		GearManagerComponentTestContext Context(100, 9);
+		FDebugTestResult Res = true;
+
+		UAttackReplaySubsystem* ReplaySubsystem = Context.World->GetSubsystem<UAttackReplaySubsystem>();
+		Res &= Test->TestNotNull(TEXT("Game worlds should have an attack replay subsystem"), ReplaySubsystem);
+		if (!ReplaySubsystem)
+			return Res;
+
+		// Half a second of two sockets recorded at 60 fps
+		UWeaponAttackData* AttackData = NewObject<UWeaponAttackData>();
+		constexpr int32 NumKeyframes = 31;
+		for (int32 i = 0; i < NumKeyframes; ++i)
+		{
+			FWeaponAttackTimestamp& Keyframe = AttackData->AttackSequence.AddDefaulted_GetRef();
+			Keyframe.Timestamp = i / 60.f;
+			Keyframe.SocketPositions = { FVector(50.f, i * 5.f, 100.f), FVector(100.f, i * 5.f, 100.f) };
+		}
+		AttackData->PackAttackSequence();
+
+		constexpr int32 NumAttacks = 500;
+		TArray<UGearManagerComponent*> Attackers;
+		for (int32 i = 0; i < NumAttacks; ++i)
+		{
+			UGearManagerComponent* Attacker = NewObject<UGearManagerComponent>(Context.TempActor);
+			Attacker->Owner = Cast<ACharacter>(Context.TempActor);
+			Attackers.Add(Attacker);
+		}
+
+		for (UGearManagerComponent* Attacker : Attackers)
+		{
+			ReplaySubsystem->StartReplay(Attacker, AttackData);
+		}
+		ReplaySubsystem->StartReplay(Attackers[0], AttackData); // Restarting should not add a second replay
+		Res &= Test->TestEqual(TEXT("Every attack should be replaying"), ReplaySubsystem->GetNumActiveReplays(), NumAttacks);
+
+		// Ticks at 30 fps cross two keyframes each
+		const double StartTime = FPlatformTime::Seconds();
+		int32 NumTicks = 0;
+		for (; NumTicks < 14; ++NumTicks)
+		{
+			ReplaySubsystem->Tick(1.f / 30.f);
+		}
+		Res &= Test->TestEqual(TEXT("No attack should finish before its last keyframe"), ReplaySubsystem->GetNumActiveReplays(), NumAttacks);
+
+		ReplaySubsystem->StopReplay(Attackers[0]);
+		Res &= Test->TestEqual(TEXT("Stopped attacks should no longer be replaying"), ReplaySubsystem->GetNumActiveReplays(), NumAttacks - 1);
+
+		for (; NumTicks < 16; ++NumTicks)
+		{
+			ReplaySubsystem->Tick(1.f / 30.f);
+		}
+		const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		Res &= Test->TestEqual(TEXT("All attacks should finish after their last keyframe"), ReplaySubsystem->GetNumActiveReplays(), 0);
+		Res &= Test->TestFalse(TEXT("Finished attacks should be removed from the scheduler"), ReplaySubsystem->IsTickable());
+		Test->AddInfo(FString::Printf(TEXT("Replayed %d concurrent attacks in %d ticks, %.3f ms per tick"), NumAttacks, NumTicks, ElapsedMs / NumTicks));
+
+		return Res;
+	}
+
+	bool TestReplayCapsuleSweeps()
+	{
+		FDebugTestResult Res = true;
+		TArray<FAttackReplayCapsuleSweep, TInlineAllocator<8>> Sweeps;
+
+		// A blade moving without turning is covered by a single sweep
+		UGearManagerComponent::BuildReplayCapsuleSweeps(FVector(0.f, 0.f, 0.f), FVector(100.f, 0.f, 0.f), FVector(0.f, 50.f, 0.f), FVector(100.f, 50.f, 0.f), 10.f, 15.f, Sweeps);
+		Res &= Test->TestEqual(TEXT("A blade that does not turn should be swept once"), Sweeps.Num(), 1);
+		Res &= Test->TestTrue(TEXT("The sweep should move the blade center"), Sweeps[0].Start.Equals(FVector(50.f, 0.f, 0.f)) && Sweeps[0].End.Equals(FVector(50.f, 50.f, 0.f)));
+		Res &= Test->TestTrue(TEXT("The capsule should be aligned to the blade"), FMath::Abs(Sweeps[0].Rotation.GetUpVector().X) > 0.999f);
+		Res &= Test->TestTrue(TEXT("The capsule should span both sockets and the radius"), FMath::IsNearlyEqual(Sweeps[0].HalfHeight, 60.f));
+
+		// A blade turning a quarter circle around its hilt is a fan that one averaged capsule would not cover
+		const FVector Hilt(0.f, 0.f, 0.f);
+		const FVector StartTip(100.f, 0.f, 0.f);
+		const FVector EndTip(0.f, 100.f, 0.f);
+		Sweeps.Reset();
+		UGearManagerComponent::BuildReplayCapsuleSweeps(Hilt, StartTip, Hilt, EndTip, 10.f, 15.f, Sweeps);
+		Res &= Test->TestEqual(TEXT("A 90 degree turn should be split into 15 degree sweeps"), Sweeps.Num(), 6);
+		Res &= Test->TestTrue(TEXT("The sweeps should start at the start of the blade"), Sweeps[0].Start.Equals(0.5f * (Hilt + StartTip)));
+		Res &= Test->TestTrue(TEXT("The sweeps should end at the end of the blade"), Sweeps.Last().End.Equals(0.5f * (Hilt + EndTip)) && Sweeps.Last().EndB.Equals(EndTip));
+
+		bool bContiguous = true;
+		bool bWithinAngle = true;
+		bool bCoversSockets = true;
+		bool bKeepsLength = true;
+		FVector PreviousEndA = Hilt;
+		FVector PreviousEndB = StartTip;
+		for (const FAttackReplayCapsuleSweep& Sweep : Sweeps)
+		{
+			bContiguous &= Sweep.Start.Equals(0.5f * (PreviousEndA + PreviousEndB));
+			const FVector StartAxis = (PreviousEndB - PreviousEndA).GetSafeNormal();
+			const FVector EndAxis = (Sweep.EndB - Sweep.EndA).GetSafeNormal();
+			bWithinAngle &= FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(FVector::DotProduct(StartAxis, EndAxis), -1.0, 1.0))) <= 15.f + 0.01f;
+			bCoversSockets &= Sweep.HalfHeight >= 0.5f * FMath::Max(FVector::Dist(PreviousEndA, PreviousEndB), FVector::Dist(Sweep.EndA, Sweep.EndB)) + 10.f - 0.01f;
+			bKeepsLength &= FMath::IsNearlyEqual(FVector::Dist(Sweep.EndA, Sweep.EndB), 100.f, 0.01f);
+			PreviousEndA = Sweep.EndA;
+			PreviousEndB = Sweep.EndB;
+		}
+		Res &= Test->TestTrue(TEXT("Each sweep should start where the previous one ended"), bContiguous);
+		Res &= Test->TestTrue(TEXT("No sweep should turn the blade more than the maximum angle"), bWithinAngle);
+		Res &= Test->TestTrue(TEXT("Each capsule should span the sockets at both ends of its sweep"), bCoversSockets);
+		Res &= Test->TestTrue(TEXT("The blade should keep its length while turning instead of cutting across the fan"), bKeepsLength);
+
+		Sweeps.Reset();
+		UGearManagerComponent::BuildReplayCapsuleSweeps(Hilt, StartTip, Hilt, EndTip, 10.f, 180.f, Sweeps);
+		Res &= Test->TestEqual(TEXT("Turns within the maximum angle should not be split"), Sweeps.Num(), 1);
+
+		return Res;
+	}
+
+	bool TestReplayHitReporting()
+	{
+		GearManagerComponentTestContext Context(100, 9);
+		FDebugTestResult Res = true;
+
+		UWeaponAttackData* AttackData = NewObject<UWeaponAttackData>();
+		for (int32 i = 0; i < 2; ++i)
+		{
+			FWeaponAttackTimestamp& Keyframe = AttackData->AttackSequence.AddDefaulted_GetRef();
+			Keyframe.Timestamp = i / 60.f;
+			Keyframe.SocketPositions = { FVector(50.f, i * 5.f, 100.f) };
+		}
+		AttackData->PackAttackSequence();
+
+		TArray<AActor*> ReportedActors;
+		UTestDelegateForwardHelper* DelegateHelper = NewObject<UTestDelegateForwardHelper>();
+		DelegateHelper->CallFuncActorHit = [&ReportedActors](AActor* HitActor, const FHitResult& HitResult) { ReportedActors.Add(HitActor); };
+		Context.GearManager->OnHitDetected.AddDynamic(DelegateHelper, &UTestDelegateForwardHelper::DispatchActorHit);
+
+		AActor* Target = Context.World->SpawnActor<AItemHoldingCharacter>();
+		AActor* OtherTarget = Context.World->SpawnActor<AItemHoldingCharacter>();
+		const FHitResult Hit(Target, nullptr, FVector::ZeroVector, FVector::ZeroVector);
+		const FHitResult OtherHit(OtherTarget, nullptr, FVector::ZeroVector, FVector::ZeroVector);
+
+		Res &= Test->TestFalse(TEXT("Every hit should be reported by default"), Context.GearManager->bReportEachActorOncePerAttack);
+		Context.GearManager->PlayRecordedAttackSequence(AttackData);
+		Context.GearManager->ReportReplayHit(Target, Hit);
+		Context.GearManager->ReportReplayHit(Target, Hit);
+		Res &= Test->TestEqual(TEXT("Each segment hitting an actor should be reported without deduplication"), ReportedActors.Num(), 2);
+
+		ReportedActors.Reset();
+		Context.GearManager->bReportEachActorOncePerAttack = true;
+		Context.GearManager->PlayRecordedAttackSequence(AttackData);
+		Context.GearManager->ReportReplayHit(Target, Hit);
+		Context.GearManager->ReportReplayHit(Target, Hit);
+		Context.GearManager->ReportReplayHit(OtherTarget, OtherHit);
+		Context.GearManager->ReportReplayHit(OtherTarget, OtherHit);
+		Res &= Test->TestTrue(TEXT("Each actor should be reported once per attack"), ReportedActors.Num() == 2 && ReportedActors[0] == Target && ReportedActors[1] == OtherTarget);
+
+		Context.GearManager->PlayRecordedAttackSequence(AttackData);
+		Context.GearManager->ReportReplayHit(Target, Hit);
+		Res &= Test->TestEqual(TEXT("A new attack should report actors hit by the previous one again"), ReportedActors.Num(), 3);
+
+		Context.GearManager->OnHitDetected.RemoveAll(DelegateHelper);
+		Target->Destroy();
+		OtherTarget->Destroy();
+
+		return Res;
+	}
+
+	bool TestAttackDataPacking()
+	{
+		FDebugTestResult Res = true;
+
+		// A sword swing arc with three sockets along the blade, sampled at 60 fps
+		UWeaponAttackData* AttackData = NewObject<UWeaponAttackData>();
+		constexpr int32 NumKeyframes = 40;
+		constexpr int32 NumSockets = 3;
+		for (int32 i = 0; i < NumKeyframes; ++i)
+		{
+			FWeaponAttackTimestamp& Keyframe = AttackData->AttackSequence.AddDefaulted_GetRef();
+			Keyframe.Timestamp = i / 60.f;
+			const float Angle = FMath::DegreesToRadians(-90.f + i * 4.5f);
+			for (int32 Socket = 0; Socket < NumSockets; ++Socket)
+			{
+				const float Reach = 60.f + Socket * 35.f;
+				Keyframe.SocketPositions.Add(FVector(FMath::Cos(Angle) * Reach, FMath::Sin(Angle) * Reach, 120.f - i * 2.f));
+			}
+		}
+		AttackData->PackAttackSequence();
+
+		Res &= Test->TestEqual(TEXT("Every keyframe should be packed"), AttackData->GetNumKeyframes(), NumKeyframes);
+		Res &= Test->TestEqual(TEXT("Every socket should be packed"), AttackData->GetNumSockets(), NumSockets);
+
+		float MaxError = 0.f;
+		for (int32 i = 0; i < NumKeyframes; ++i)
+		{
+			Res &= Test->TestEqual(TEXT("Keyframe times should be kept exactly"), AttackData->GetKeyframeTime(i), AttackData->AttackSequence[i].Timestamp);
+			const TConstArrayView<FVector3f> Positions = AttackData->GetSocketPositions(i);
+			for (int32 Socket = 0; Socket < NumSockets; ++Socket)
+			{
+				MaxError = FMath::Max(MaxError, static_cast<float>(FVector::Dist(FVector(Positions[Socket]), AttackData->AttackSequence[i].SocketPositions[Socket])));
+			}
+		}
+		// The swing spans about 260 units, 16 bit steps are well below a hundredth of a unit
+		Res &= Test->TestTrue(TEXT("Quantized positions should stay within the quantization step"), MaxError < 0.01f);
+
+		const int64 UnpackedSize = AttackData->GetUnpackedSize();
+		const int64 PackedSize = AttackData->GetPackedSize();
+		Res &= Test->TestTrue(TEXT("The packed format should be smaller"), PackedSize * 3 < UnpackedSize);
+		Test->AddInfo(FString::Printf(TEXT("Attack of %d keyframes and %d sockets: %lld bytes unpacked, %lld bytes packed"), NumKeyframes, NumSockets, UnpackedSize, PackedSize));
+
+		// Keyframes with fewer sockets limit the socket count
+		AttackData->AttackSequence[5].SocketPositions.Pop();
+		AttackData->PackAttackSequence();
+		Res &= Test->TestEqual(TEXT("Mismatched socket counts should pack the common sockets"), AttackData->GetNumSockets(), NumSockets - 1);
+
+		return Res;
+	}
+
+	bool TestKeyframeReduction()
+	{
+		FDebugTestResult Res = true;
+
+		// A dense recording at 120 fps of a three socket blade, an arc that ends in a sharp hook
+		TArray<FWeaponAttackTimestamp> Recording;
+		constexpr int32 NumFrames = 120;
+		constexpr int32 NumSockets = 3;
+		for (int32 i = 0; i < NumFrames; ++i)
+		{
+			FWeaponAttackTimestamp& Frame = Recording.AddDefaulted_GetRef();
+			Frame.Timestamp = i / 120.f;
+			Frame.OriginalIndex = i;
+			const float Angle = FMath::DegreesToRadians(i < 90 ? -90.f + i * 2.f : 90.f - (i - 90) * 4.f);
+			for (int32 Socket = 0; Socket < NumSockets; ++Socket)
+			{
+				const float Reach = 60.f + Socket * 35.f;
+				Frame.SocketPositions.Add(FVector(FMath::Cos(Angle) * Reach, FMath::Sin(Angle) * Reach, 120.f - i * 0.5f));
+			}
+		}
+
+		constexpr float MaxDeviation = 1.f;
+		const TArray<int32> Keyframes = UWeaponAttackRecorderComponent::ReduceToKeyframes(Recording, MaxDeviation);
+		Res &= Test->TestTrue(TEXT("The first and last frames should be kept"), Keyframes.Num() >= 2 && Keyframes[0] == 0 && Keyframes.Last() == NumFrames - 1);
+		Res &= Test->TestTrue(TEXT("The recording should be reduced to far fewer keyframes"), Keyframes.Num() < NumFrames / 3);
+		Res &= Test->TestTrue(TEXT("The hook should keep a keyframe near its turning point"), Keyframes.ContainsByPredicate([](int32 Frame) { return FMath::Abs(Frame - 90) <= 2; }));
+
+		// Where replay puts a socket at the time of a recorded frame
+		auto GetReplayedPosition = [&Recording, &Keyframes](int32 Frame, int32 Socket)
+		{
+			int32 Span = 0;
+			while (Keyframes[Span + 1] < Frame)
+				++Span;
+			const FWeaponAttackTimestamp& First = Recording[Keyframes[Span]];
+			const FWeaponAttackTimestamp& Last = Recording[Keyframes[Span + 1]];
+			const float Alpha = (Recording[Frame].Timestamp - First.Timestamp) / (Last.Timestamp - First.Timestamp);
+			return FMath::Lerp(First.SocketPositions[Socket], Last.SocketPositions[Socket], Alpha);
+		};
+
+		float WorstDeviation = 0.f;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (int32 Socket = 0; Socket < NumSockets; ++Socket)
+			{
+				WorstDeviation = FMath::Max(WorstDeviation, static_cast<float>(FVector::Dist(GetReplayedPosition(Frame, Socket), Recording[Frame].SocketPositions[Socket])));
+			}
+		}
+		Res &= Test->TestTrue(TEXT("Every socket of every frame should stay within the maximum deviation"), WorstDeviation <= MaxDeviation + KINDA_SMALL_NUMBER);
+
+		// Swept coverage, targets the dense traces hit within a radius must be hit by the reduced traces within the radius plus the deviation
+		auto GetDistanceToTraces = [&Recording](const TArray<int32>& Frames, const FVector& Point)
+		{
+			float Distance = TNumericLimits<float>::Max();
+			for (int32 i = 0; i + 1 < Frames.Num(); ++i)
+			{
+				for (int32 Socket = 0; Socket < NumSockets; ++Socket)
+				{
+					const FVector& Start = Recording[Frames[i]].SocketPositions[Socket];
+					const FVector& End = Recording[Frames[i + 1]].SocketPositions[Socket];
+					Distance = FMath::Min(Distance, static_cast<float>(FMath::PointDistToSegment(Point, Start, End)));
+				}
+			}
+			return Distance;
+		};
+
+		TArray<int32> AllFrames;
+		for (int32 i = 0; i < NumFrames; ++i)
+			AllFrames.Add(i);
+
+		constexpr float HitRadius = 10.f;
+		int32 NumCovered = 0;
+		int32 NumMissed = 0;
+		for (float X = -140.f; X <= 140.f; X += 7.f)
+		{
+			for (float Y = -140.f; Y <= 140.f; Y += 7.f)
+			{
+				for (float Z = 60.f; Z <= 120.f; Z += 15.f)
+				{
+					const FVector Target(X, Y, Z);
+					if (GetDistanceToTraces(AllFrames, Target) > HitRadius)
+						continue;
+
+					++NumCovered;
+					if (GetDistanceToTraces(Keyframes, Target) > HitRadius + MaxDeviation)
+						++NumMissed;
+				}
+			}
+		}
+		Res &= Test->TestTrue(TEXT("The dense recording should cover some targets"), NumCovered > 0);
+		Res &= Test->TestEqual(TEXT("The reduced recording should cover every target the dense one covers"), NumMissed, 0);
+		Test->AddInfo(FString::Printf(TEXT("Reduced %d frames to %d keyframes, worst deviation %.3f, %d covered targets"), NumFrames, Keyframes.Num(), WorstDeviation, NumCovered));
+
+		return Res;
+	}
+
+	bool TestProjectilePool()
+	{
+		GearManagerComponentTestContext Context(100, 9);
+		FDebugTestResult Res = true;
+
+		UProjectilePoolSubsystem* ProjectilePool = Context.World->GetSubsystem<UProjectilePoolSubsystem>();
+		Res &= Test->TestNotNull(TEXT("Game worlds should have a projectile pool"), ProjectilePool);
+		if (!ProjectilePool)
+			return Res;
+
+		ProjectilePool->DefaultProjectileLifetime = 1.f;
+		const TSubclassOf<AActor> ProjectileClass = AActor::StaticClass();
+
+		ProjectilePool->PrewarmPool(ProjectileClass, 10);
+		Res &= Test->TestEqual(TEXT("Prewarming should fill the pool"), ProjectilePool->GetNumPooledProjectiles(ProjectileClass), 10);
+
+		AActor* Projectile = ProjectilePool->AcquireProjectile(ProjectileClass, FTransform(FVector(100.f, 0.f, 0.f)), Context.TempActor, nullptr);
+		Res &= Test->TestEqual(TEXT("Acquiring should reuse a prewarmed projectile"), ProjectilePool->GetNumSpawnedProjectiles(), 10);
+		Res &= Test->TestFalse(TEXT("Acquired projectiles should be visible"), Projectile->IsHidden());
+		Res &= Test->TestEqual(TEXT("Acquired projectiles should be owned by the shooter"), Projectile->GetOwner(), static_cast<AActor*>(Context.TempActor));
+
+		ProjectilePool->ReturnProjectile(Projectile);
+		Res &= Test->TestTrue(TEXT("Returned projectiles should be hidden"), Projectile->IsHidden());
+		Res &= Test->TestEqual(TEXT("Returned projectiles should be back in the pool"), ProjectilePool->GetNumPooledProjectiles(ProjectileClass), 10);
+
+		Projectile = ProjectilePool->AcquireProjectile(ProjectileClass, FTransform::Identity, nullptr, nullptr);
+		Projectile->Destroy();
+		Res &= Test->TestEqual(TEXT("Destroyed projectiles should leave the pool"), ProjectilePool->GetNumActiveProjectiles(), 0);
+
+		// Reused projectiles start like freshly spawned ones, with the template velocity in local space and its homing settings
+		const FTransform FacingY(FRotator(0.f, 90.f, 0.f), FVector::ZeroVector);
+		ATestPooledProjectile* MovingProjectile = Cast<ATestPooledProjectile>(ProjectilePool->AcquireProjectile(ATestPooledProjectile::StaticClass(), FacingY, nullptr, nullptr));
+		Res &= Test->TestTrue(TEXT("The template velocity should be rotated by the spawn rotation"), MovingProjectile && MovingProjectile->Movement->Velocity.Equals(FVector(-1000.f, 0.f, 0.f), 0.1f));
+		if (MovingProjectile)
+		{
+			MovingProjectile->Movement->bIsHomingProjectile = true;
+			MovingProjectile->Movement->bShouldBounce = true;
+			ProjectilePool->ReturnProjectile(MovingProjectile);
+			ATestPooledProjectile* ReusedProjectile = Cast<ATestPooledProjectile>(ProjectilePool->AcquireProjectile(ATestPooledProjectile::StaticClass(), FacingY, nullptr, nullptr));
+			Res &= Test->TestEqual(TEXT("The stopped projectile should be reused"), ReusedProjectile, MovingProjectile);
+			Res &= Test->TestTrue(TEXT("A reused projectile should get the template velocity again"), ReusedProjectile->Movement->Velocity.Equals(FVector(-1000.f, 0.f, 0.f), 0.1f));
+			Res &= Test->TestFalse(TEXT("Homing set during the previous shot should be reset"), ReusedProjectile->Movement->bIsHomingProjectile);
+			Res &= Test->TestFalse(TEXT("Bouncing set during the previous shot should be reset"), ReusedProjectile->Movement->bShouldBounce);
+			ReusedProjectile->Destroy();
+		}
+
+		// Sustained automatic fire, 50 shooters firing 10 shots per second for 5 seconds at 60 fps, projectiles live for 1 second
+		constexpr int32 NumShooters = 50;
+		constexpr int32 NumFrames = 300;
+		constexpr int32 FramesPerShot = 6;
+		constexpr int32 LifetimeFrames = 60;
+		const int32 SpawnedBefore = ProjectilePool->GetNumSpawnedProjectiles();
+
+		double StartTime = FPlatformTime::Seconds();
+		int32 PeakActive = 0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			if (Frame % FramesPerShot == 0)
+			{
+				for (int32 Shooter = 0; Shooter < NumShooters; ++Shooter)
+				{
+					ProjectilePool->AcquireProjectile(ProjectileClass, FTransform(FVector(Shooter * 100.f, 0.f, 0.f)), Context.TempActor, nullptr);
+				}
+			}
+			PeakActive = FMath::Max(PeakActive, ProjectilePool->GetNumActiveProjectiles());
+			ProjectilePool->Tick(1.f / 60.f);
+		}
+		const double PooledMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		const int32 NumFired = NumShooters * NumFrames / FramesPerShot;
+		const int32 NumSpawned = ProjectilePool->GetNumSpawnedProjectiles() - SpawnedBefore;
+		Res &= Test->TestTrue(TEXT("The pool should only spawn as many projectiles as are alive at once"), NumSpawned <= PeakActive);
+		Res &= Test->TestTrue(TEXT("Sustained fire should reuse most projectiles"), NumSpawned < NumFired / 4);
+
+		for (int32 Frame = 0; Frame <= LifetimeFrames; ++Frame)
+		{
+			ProjectilePool->Tick(1.f / 60.f);
+		}
+		Res &= Test->TestEqual(TEXT("Projectiles should return to the pool at the end of their lifetime"), ProjectilePool->GetNumActiveProjectiles(), 0);
+
+		// The same fire spawning and destroying one actor per shot
+		TArray<TPair<AActor*, int32>> SpawnedProjectiles;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			if (Frame % FramesPerShot == 0)
+			{
+				for (int32 Shooter = 0; Shooter < NumShooters; ++Shooter)
+				{
+					SpawnedProjectiles.Emplace(Context.World->SpawnActor<AActor>(ProjectileClass, FTransform(FVector(Shooter * 100.f, 0.f, 0.f))), Frame);
+				}
+			}
+			while (SpawnedProjectiles.Num() > 0 && Frame - SpawnedProjectiles[0].Value >= LifetimeFrames)
+			{
+				SpawnedProjectiles[0].Key->Destroy();
+				SpawnedProjectiles.RemoveAt(0, 1, EAllowShrinking::No);
+			}
+		}
+		const double SpawnedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		for (const TPair<AActor*, int32>& Spawned : SpawnedProjectiles)
+		{
+			Spawned.Key->Destroy();
+		}
+
+		Test->AddInfo(FString::Printf(TEXT("%d shots from %d shooters: pooled %.2f ms with %d spawns, spawning %.2f ms"), NumFired, NumShooters, PooledMs, NumSpawned, SpawnedMs));
+
+		return Res;
+	}
+
+	bool TestProjectileSimulation()
+	{
+		GearManagerComponentTestContext Context(100, 9);
+		FDebugTestResult Res = true;
+
+		UProjectileSimulationSubsystem* ProjectileSimulation = Context.World->GetSubsystem<UProjectileSimulationSubsystem>();
+		Res &= Test->TestNotNull(TEXT("Game worlds should have a projectile simulation"), ProjectileSimulation);
+		if (!ProjectileSimulation)
+			return Res;
+
+		FSimulatedProjectileParams Params;
+		Params.Speed = 3000.f;
+
+		// The simulation is opt-in
+		ProjectileSimulation->bEnableSimulation = false;
+		Res &= Test->TestEqual(TEXT("A disabled simulation should not fire projectiles"), ProjectileSimulation->FireProjectile(Params, FVector::ZeroVector, FVector::ForwardVector, Context.TempActor, nullptr, FOnSimulatedProjectileHit()), 0u);
+		Res &= Test->TestEqual(TEXT("A disabled simulation should not hold projectiles"), ProjectileSimulation->GetNumProjectiles(), 0);
+		ProjectileSimulation->bEnableSimulation = true;
+		Params.Lifetime = 1.f;
+
+		// Fired upwards from far above the test level so nothing is hit
+		constexpr int32 NumProjectiles = 1000;
+		const FVector Origin(0.f, 0.f, 100000.f);
+		TArray<uint32> ProjectileIds;
+		for (int32 i = 0; i < NumProjectiles; ++i)
+		{
+			const FVector Direction = FRotator(45.f, i * 360.f / NumProjectiles, 0.f).Vector();
+			ProjectileIds.Add(ProjectileSimulation->FireProjectile(Params, Origin, Direction, Context.TempActor, nullptr, FOnSimulatedProjectileHit()));
+		}
+		Res &= Test->TestEqual(TEXT("Every fired projectile should be simulated"), ProjectileSimulation->GetNumProjectiles(), NumProjectiles);
+
+		constexpr int32 NumTicks = 30;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Tick = 0; Tick < NumTicks; ++Tick)
+		{
+			ProjectileSimulation->Tick(1.f / 60.f);
+		}
+		const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		// Constant gravity is integrated exactly, the path should match the closed form after any number of steps
+		const float Time = NumTicks / 60.f;
+		const FVector InitialVelocity = FRotator(45.f, 0.f, 0.f).Vector() * Params.Speed;
+		const FVector Expected = Origin + InitialVelocity * Time + FVector(0.f, 0.f, 0.5f * Context.World->GetGravityZ() * Time * Time);
+		FVector Location;
+		Res &= Test->TestTrue(TEXT("Projectiles should still be in flight"), ProjectileSimulation->GetProjectileLocation(ProjectileIds[0], Location));
+		Res &= Test->TestTrue(TEXT("Projectiles should follow a ballistic path"), Location.Equals(Expected, 1.f));
+
+		for (int32 Tick = 0; Tick < NumTicks + 1; ++Tick)
+		{
+			ProjectileSimulation->Tick(1.f / 60.f);
+		}
+		Res &= Test->TestEqual(TEXT("Projectiles should be removed at the end of their lifetime"), ProjectileSimulation->GetNumProjectiles(), 0);
+		Res &= Test->TestFalse(TEXT("Removed projectiles should not be found"), ProjectileSimulation->GetProjectileLocation(ProjectileIds[0], Location));
+
+		// A wall far away from the test level, hits are delivered when the world runs the async trace delegates
+		const FVector WallLocation(1000.f, 0.f, 200000.f);
+		AActor* Wall = Context.World->SpawnActor<AActor>();
+		UBoxComponent* WallBox = NewObject<UBoxComponent>(Wall);
+		WallBox->SetBoxExtent(FVector(50.f, 500.f, 500.f));
+		WallBox->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Wall->SetRootComponent(WallBox);
+		WallBox->RegisterComponent();
+		WallBox->SetWorldLocation(WallLocation);
+
+		auto TickWithTraceResults = [&Context, ProjectileSimulation](int32 NumTraceTicks)
+		{
+			for (int32 Tick = 0; Tick < NumTraceTicks; ++Tick)
+			{
+				ProjectileSimulation->Tick(1.f / 60.f);
+				Context.World->FinishAsyncTrace();
+				Context.World->ResetAsyncTrace();
+			}
+		};
+		TickWithTraceResults(1);
+
+		TArray<AActor*> HitActors;
+		const FOnSimulatedProjectileHit OnHit = FOnSimulatedProjectileHit::CreateLambda([&HitActors](const FHitResult& Hit) { HitActors.Add(Hit.GetActor()); });
+		const uint32 WallProjectileId = ProjectileSimulation->FireProjectile(Params, FVector(0.f, 0.f, WallLocation.Z), FVector::ForwardVector, Context.TempActor, nullptr, OnHit);
+		TickWithTraceResults(30);
+		Res &= Test->TestTrue(TEXT("A projectile fired at a wall should report the hit"), HitActors.Num() == 1 && HitActors[0] == Wall);
+		Res &= Test->TestFalse(TEXT("A projectile that hit something should be removed"), ProjectileSimulation->GetProjectileLocation(WallProjectileId, Location));
+
+		// Expiring on the step that reaches the wall, the last step is still traced and reported
+		FSimulatedProjectileParams ExpiringParams = Params;
+		ExpiringParams.Lifetime = 0.01f;
+		HitActors.Reset();
+		ProjectileSimulation->FireProjectile(ExpiringParams, WallLocation - FVector(80.f, 0.f, 0.f), FVector::ForwardVector, Context.TempActor, nullptr, OnHit);
+		TickWithTraceResults(1);
+		Res &= Test->TestEqual(TEXT("An expired projectile should be removed right away"), ProjectileSimulation->GetNumProjectiles(), 0);
+		Res &= Test->TestTrue(TEXT("The last step of an expired projectile should still report its hit"), HitActors.Num() == 1 && HitActors[0] == Wall);
+
+		Wall->Destroy();
+
+		Test->AddInfo(FString::Printf(TEXT("Stepped and traced %d projectiles in %.3f ms per tick"), NumProjectiles, ElapsedMs / NumTicks));
+
+		return Res;
+	}
+
+	bool TestFirePatternEvent()
+	{
+		GearManagerComponentTestContext Context(100, 9);
+		FDebugTestResult Res = true;
+
+		URangedWeaponFiringComponent* FiringComponent = NewObject<URangedWeaponFiringComponent>(Context.TempActor);
+		FiringComponent->FiringData.ProjectilesPerShot = 7;
+		FiringComponent->FiringData.BulletSpacingForNonSpreadPattern = 50.f;
+
+		FFirePatternEvent FireEvent;
+		FireEvent.Origin = FVector(100.f, 200.f, 300.f);
+		FireEvent.Yaw = FRotator::CompressAxisToShort(90.f);
+		FireEvent.Seed = 1234;
+
+		TArray<FTransform> Shots;
+		FiringComponent->GenerateFirePattern(FireEvent, Shots);
+		Res &= Test->TestEqual(TEXT("A fire event should generate every shot of the pattern"), Shots.Num(), 7);
+		Res &= Test->TestTrue(TEXT("Line shots should be spaced along the right vector of the event rotation"),
+			Shots[0].GetLocation().Equals(FVector(50.f, 200.f, 300.f), 1.f) && Shots[1].GetLocation().Equals(FVector(150.f, 200.f, 300.f), 1.f));
+		Res &= Test->TestTrue(TEXT("The middle shot of odd counts should be fired from the origin"), Shots.Last().GetLocation().Equals(FireEvent.Origin, 1.f));
+
+		FireEvent.Pattern = EFirePattern::Spread;
+		FiringComponent->GenerateFirePattern(FireEvent, Shots);
+		TArray<FTransform> RegeneratedShots;
+		FiringComponent->GenerateFirePattern(FireEvent, RegeneratedShots);
+		bool bSameShots = Shots.Num() == RegeneratedShots.Num();
+		bool bWithinSpread = true;
+		for (int32 i = 0; bSameShots && i < Shots.Num(); ++i)
+		{
+			bSameShots &= Shots[i].Equals(RegeneratedShots[i]);
+			const float PitchOffset = FMath::Abs(FRotator::NormalizeAxis(Shots[i].Rotator().Pitch));
+			bWithinSpread &= PitchOffset <= FiringComponent->FiringData.MaxRandomDegreeSpread + 0.1f;
+		}
+		Res &= Test->TestTrue(TEXT("The same seed should regenerate the same spread"), bSameShots);
+		Res &= Test->TestTrue(TEXT("Spread shots should stay within the random spread"), bWithinSpread);
+
+		FireEvent.Seed = 4321;
+		FiringComponent->GenerateFirePattern(FireEvent, RegeneratedShots);
+		Res &= Test->TestFalse(TEXT("Different seeds should generate different spreads"), Shots[0].Equals(RegeneratedShots[0]));
+
+		// Client requests only contribute origin and aim, the server picks the pattern and seed and enforces the cooldown
+		FiringComponent->Cooldown = 1.f;
+		FiringComponent->FiringData.Pattern = EFirePattern::Spread;
+		FFireRequest ClientRequest;
+		ClientRequest.Origin = FiringComponent->GetComponentLocation();
+		ClientRequest.Pitch = FireEvent.Pitch;
+		ClientRequest.Yaw = FireEvent.Yaw;
+		FFirePatternEvent ServerEvent;
+		TSet<uint16> ServerSeeds;
+		Res &= Test->TestTrue(TEXT("The first client fire request should be accepted"), FiringComponent->ValidateFireEvent_ServerImpl(ClientRequest, ServerEvent));
+		Res &= Test->TestTrue(TEXT("The server should use the pattern of its own FiringData"), ServerEvent.Pattern == EFirePattern::Spread);
+		Res &= Test->TestTrue(TEXT("The server event should keep the client's aim"), ServerEvent.Pitch == ClientRequest.Pitch && ServerEvent.Yaw == ClientRequest.Yaw);
+		ServerSeeds.Add(ServerEvent.Seed);
+		Res &= Test->TestFalse(TEXT("A fire request during the cooldown should be rejected"), FiringComponent->ValidateFireEvent_ServerImpl(ClientRequest, ServerEvent));
+		for (int32 i = 0; i < 8; ++i)
+		{
+			FiringComponent->WorldTimeLastFired = -1.f;
+			FiringComponent->ValidateFireEvent_ServerImpl(ClientRequest, ServerEvent);
+			ServerSeeds.Add(ServerEvent.Seed);
+		}
+		Res &= Test->TestTrue(TEXT("The server should draw a new seed for every event"), ServerSeeds.Num() > 1);
+
+		return Res;
+	}
+
+	bool TestLagCompensation()
+	{
+		GearManagerComponentTestContext Context(100, 9);
+		FDebugTestResult Res = true;
+
+		ULagCompensationSubsystem* LagCompensation = Context.World->GetSubsystem<ULagCompensationSubsystem>();
+		Res &= Test->TestNotNull(TEXT("Game worlds should have a lag compensation subsystem"), LagCompensation);
+		if (!LagCompensation)
+			return Res;
+
+		// A target walking along Y at 600 units per second, sampled at 60 fps for one second
+		AActor* Target = Context.World->SpawnActor<AItemHoldingCharacter>();
+		LagCompensation->RegisterTarget(Target, 40.f, 90.f);
+		for (int32 Frame = 0; Frame <= 60; ++Frame)
+		{
+			Target->SetActorLocation(FVector(200.f, Frame * 10.f, 0.f));
+			LagCompensation->SampleTargets(Frame / 60.0);
+		}
+
+		FVector RewoundLocation;
+		Res &= Test->TestTrue(TEXT("Registered targets should have a history"), LagCompensation->GetRewoundLocation(Target, 0.5, RewoundLocation));
+		Res &= Test->TestTrue(TEXT("Rewinding should return the sampled location"), RewoundLocation.Equals(FVector(200.f, 300.f, 0.f), 0.01f));
+		LagCompensation->GetRewoundLocation(Target, 0.5 + 0.5 / 60.0, RewoundLocation);
+		Res &= Test->TestTrue(TEXT("Rewinding between samples should interpolate"), RewoundLocation.Equals(FVector(200.f, 305.f, 0.f), 0.01f));
+		LagCompensation->GetRewoundLocation(Target, -10.0, RewoundLocation);
+		Res &= Test->TestTrue(TEXT("Rewinding past the history should clamp to the oldest sample"), RewoundLocation.Equals(FVector(200.f, 0.f, 0.f), 0.01f));
+
+		// A swing across X at Y = 300 hits where the target was half a second ago, but not where it is now
+		TArray<FLagCompensatedHit> Hits;
+		LagCompensation->FindRewoundHits(0.5, FVector(100.f, 300.f, 50.f), FVector(300.f, 300.f, 50.f), 0.f, nullptr, Hits);
+		Res &= Test->TestTrue(TEXT("The rewound target should be hit"), Hits.Num() == 1 && Hits[0].Actor == Target);
+		Hits.Reset();
+		LagCompensation->FindRewoundHits(1.0, FVector(100.f, 300.f, 50.f), FVector(300.f, 300.f, 50.f), 0.f, nullptr, Hits);
+		Res &= Test->TestEqual(TEXT("The current target should be missed"), Hits.Num(), 0);
+		LagCompensation->FindRewoundHits(0.5, FVector(100.f, 300.f, 50.f), FVector(300.f, 300.f, 50.f), 0.f, Target, Hits);
+		Res &= Test->TestEqual(TEXT("The ignored actor should not be hit"), Hits.Num(), 0);
+
+		// Benchmark the rewind cost of a two socket, 30 keyframe attack against a crowd of 80 targets
+		TArray<AActor*> Crowd;
+		for (int32 i = 0; i < 80; ++i)
+		{
+			AActor* CrowdMember = Context.World->SpawnActor<AItemHoldingCharacter>(FVector(300.f + (i % 10) * 100.f, (i / 10) * 100.f, 0.f), FRotator::ZeroRotator);
+			LagCompensation->RegisterTarget(CrowdMember, 40.f, 90.f);
+			Crowd.Add(CrowdMember);
+		}
+		for (int32 Frame = 61; Frame < 125; ++Frame)
+		{
+			LagCompensation->SampleTargets(Frame / 60.0);
+		}
+		Res &= Test->TestEqual(TEXT("All targets should be registered"), LagCompensation->GetNumTargets(), 81);
+
+		constexpr int32 NumAttacks = 200;
+		int32 NumHits = 0;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Attack = 0; Attack < NumAttacks; ++Attack)
+		{
+			const double AttackTime = 1.5 + (Attack % 20) / 60.0;
+			for (int32 Keyframe = 0; Keyframe < 30; ++Keyframe)
+			{
+				for (int32 Socket = 0; Socket < 2; ++Socket)
+				{
+					const FVector Start(250.f + Keyframe * 20.f, Socket * 50.f, 50.f);
+					Hits.Reset();
+					LagCompensation->FindRewoundHits(AttackTime - Keyframe / 60.0, Start, Start + FVector(20.f, 100.f, 0.f), 0.f, nullptr, Hits);
+					NumHits += Hits.Num();
+				}
+			}
+		}
+		const double ElapsedUs = (FPlatformTime::Seconds() - StartTime) * 1000000.0;
+		Res &= Test->TestTrue(TEXT("The benchmark swings should hit the crowd"), NumHits > 0);
+		Test->AddInfo(FString::Printf(TEXT("Rewound %d attacks against %d targets, %.2f us per attack"), NumAttacks, LagCompensation->GetNumTargets(), ElapsedUs / NumAttacks));
+
+		LagCompensation->UnregisterTarget(Target);
+		Res &= Test->TestFalse(TEXT("Unregistered targets should have no history"), LagCompensation->GetRewoundLocation(Target, 0.5, RewoundLocation));
+
+		Target->Destroy();
+		for (AActor* CrowdMember : Crowd)
+		{
+			CrowdMember->Destroy();
+		}
+		LagCompensation->SampleTargets(3.0);
+		Res &= Test->TestEqual(TEXT("Destroyed targets should be unregistered"), LagCompensation->GetNumTargets(), 0);
+
+		// Servers ticking at 240 Hz still keep the whole requested history
+		AActor* FastTarget = Context.World->SpawnActor<AItemHoldingCharacter>();
+		LagCompensation->RegisterTarget(FastTarget, 40.f, 90.f);
+		LagCompensation->ExtendHistory(2.f);
+		LagCompensation->ExtendHistory(0.4f);
+		Res &= Test->TestEqual(TEXT("The history should keep the longest requested span"), LagCompensation->GetHistorySeconds(), 2.f);
+		for (int32 Frame = 0; Frame <= 720; ++Frame)
+		{
+			FastTarget->SetActorLocation(FVector(200.f, Frame, 0.f));
+			LagCompensation->SampleTargets(4.0 + Frame / 240.0);
+		}
+		LagCompensation->GetRewoundLocation(FastTarget, 5.0, RewoundLocation);
+		Res &= Test->TestTrue(TEXT("Rewinding the full history at a high tick rate should not clamp"), RewoundLocation.Equals(FVector(200.f, 240.f, 0.f), 0.01f));
+		LagCompensation->GetRewoundLocation(FastTarget, 4.0, RewoundLocation);
+		Res &= Test->TestTrue(TEXT("Samples older than the history should be dropped"), RewoundLocation.Y > 0.f);
+		Res &= Test->TestTrue(TEXT("The ring should not grow far beyond the history"), LagCompensation->GetSampleCapacity() <= 2 * (2 * 240 + 2));
+
+		// Gear managers register their owner when play begins and unregister it when play ends
+		AItemHoldingCharacter* GearOwner = Context.World->SpawnActor<AItemHoldingCharacter>();
+		UInventoryComponent* GearOwnerInventory = NewObject<UInventoryComponent>(GearOwner);
+		GearOwner->AddInstanceComponent(GearOwnerInventory);
+		GearOwnerInventory->RegisterComponent();
+		UGearManagerComponent* GearManager = NewObject<UGearManagerComponent>(GearOwner);
+		GearManager->bUseLagCompensation = true;
+		GearOwner->AddInstanceComponent(GearManager);
+		GearManager->RegisterComponent();
+		UActorComponent* GearManagerComponent = GearManager;
+		GearManagerComponent->BeginPlay();
+		Res &= Test->TestTrue(TEXT("Beginning play should register the owner"), LagCompensation->IsTargetRegistered(GearOwner));
+		Res &= Test->TestEqual(TEXT("The history should cover the longest rewind of the owner"), LagCompensation->GetHistorySeconds(), 2.f);
+		GearManagerComponent->EndPlay(EEndPlayReason::Destroyed);
+		Res &= Test->TestFalse(TEXT("Ending play should unregister the owner"), LagCompensation->IsTargetRegistered(GearOwner));
+		GearOwner->Destroy();
+		FastTarget->Destroy();
+
+		return Res;
+	}
 };
 
 bool FRancGearManagerComponentTest::RunTest(const FString& Parameters)
@@ -697,6 +1407,15 @@ bool FRancGearManagerComponentTest::RunTest(const FString& Parameters)
 	Res &= TestScenarios.TestWeaponSelectionDeselectSequences();
 	Res &= TestScenarios.TestUnequippingPartially();
 	Res &= TestScenarios.TestSelectableWeaponsLifecycle();
+	Res &= TestScenarios.TestAttackReplayScheduler();
+	Res &= TestScenarios.TestReplayCapsuleSweeps();
+	Res &= TestScenarios.TestReplayHitReporting();
+	Res &= TestScenarios.TestAttackDataPacking();
+	Res &= TestScenarios.TestKeyframeReduction();
+	Res &= TestScenarios.TestLagCompensation();
+	Res &= TestScenarios.TestProjectilePool();
+	Res &= TestScenarios.TestProjectileSimulation();
+	Res &= TestScenarios.TestFirePatternEvent();
 
 	return Res;
 }
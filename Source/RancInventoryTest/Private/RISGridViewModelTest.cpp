@@ -11,6 +11,7 @@
 #include "Core/RISSubsystem.h"
 #include "Framework/DebugTestResult.h"
 #include "MockClasses/ItemHoldingCharacter.h"
+#include "Framework/TestDelegateForwardHelper.h"
 
 #if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
 
@@ -54,6 +55,12 @@ public:
 	AActor* TempActor;
 	UInventoryComponent* InventoryComponent;
 	UInventoryGridViewModel* ViewModel;
+
+	// Direct access for tests that need to put the view model out of sync with its component
+	void SetGridSlot(int32 SlotIndex, const FItemBundle& Item) { ViewModel->SetGridItem(SlotIndex, Item); }
+	int32 GetNumGridItemsBuilt() const { return ViewModel->NumGridItemsBuilt; }
+	void ForceFullUpdate() { ViewModel->ForceFullUpdate(); }
+	bool ChecksumsMatch() const { return ViewModel->ChecksumsMatchLinkedComponent(); }
 };
 
 // Helper to compare instance data arrays (by pointer)
@@ -2316,6 +2323,284 @@ public:
         
         return Res;
     }
+
+	bool TestIncrementalFullUpdate()
+	{
+		GridViewModelTestContext Context(100, 9, false);
+		auto* InventoryComponent = Context.InventoryComponent;
+		auto* ViewModel = Context.ViewModel;
+		auto* Subsystem = Context.TestFixture.GetSubsystem();
+
+		FDebugTestResult Res = true;
+
+		InventoryComponent->AddItemToAnySlot(Subsystem, FiveRocks);
+		InventoryComponent->AddItemToAnySlot(Subsystem, ThreeSticks);
+		InventoryComponent->AddItemToTaggedSlot_IfServer(Subsystem, HelmetSlot, OneHelmet);
+		Res &= ViewModel->AssertViewModelSettled();
+
+		TArray<int32> UpdatedSlots;
+		auto* DelegateHelper = NewObject<UTestDelegateForwardHelper>();
+		DelegateHelper->CallFuncGridSlot = [&UpdatedSlots](int32 SlotIndex, const TArray<UItemInstanceData*>&) { UpdatedSlots.Add(SlotIndex); };
+		ViewModel->OnGridSlotUpdated.AddDynamic(DelegateHelper, &UTestDelegateForwardHelper::DispatchGridSlot);
+
+		// A resync without any desync should not touch a single slot
+		Context.ForceFullUpdate();
+		Res &= Test->TestEqual(TEXT("Resync of a matching grid should not broadcast"), UpdatedSlots.Num(), 0);
+		Res &= Test->TestTrue(TEXT("Helmet in the tagged slot should not be shown in the grid"), ViewModel->GetGridItem(2).ItemId != ItemIdHelmet);
+		Res &= ViewModel->AssertViewModelSettled();
+
+		// Desync the grid: sticks shown in another slot and rocks missing a few
+		Context.SetGridSlot(4, ViewModel->GetGridItem(1));
+		Context.SetGridSlot(1, FItemBundle::EmptyItemInstance);
+		FItemBundle Rocks = ViewModel->GetGridItem(0);
+		Rocks.Quantity = 2;
+		Context.SetGridSlot(0, Rocks);
+		Context.ForceFullUpdate();
+
+		Res &= Test->TestEqual(TEXT("Only the rock slot should be broadcast"), UpdatedSlots.Num(), 1);
+		Res &= Test->TestTrue(TEXT("Rock slot should be the one broadcast"), UpdatedSlots.Num() == 1 && UpdatedSlots[0] == 0);
+		Res &= Test->TestEqual(TEXT("Rocks should be restored in place"), ViewModel->GetGridItem(0).Quantity, 5);
+		Res &= Test->TestTrue(TEXT("Sticks should keep their visual position"), ViewModel->GetGridItem(4).ItemId == ItemIdSticks && ViewModel->GetGridItem(4).Quantity == 3);
+		Res &= Test->TestTrue(TEXT("Previous sticks slot should stay empty"), ViewModel->IsGridSlotEmpty(1));
+		Res &= ViewModel->AssertViewModelSettled();
+
+		// Items the component no longer has are cleared
+		UpdatedSlots.Reset();
+		Context.SetGridSlot(6, FItemBundle(ItemIdRock, 4));
+		Context.ForceFullUpdate();
+		Res &= Test->TestTrue(TEXT("Unbacked slot should be cleared and broadcast"), ViewModel->IsGridSlotEmpty(6) && UpdatedSlots.Num() == 1 && UpdatedSlots[0] == 6);
+		Res &= ViewModel->AssertViewModelSettled();
+
+		return Res;
+	}
+
+	bool TestSortAndCompact()
+	{
+		GridViewModelTestContext Context(100, 9, false);
+		auto* InventoryComponent = Context.InventoryComponent;
+		auto* ViewModel = Context.ViewModel;
+		auto* Subsystem = Context.TestFixture.GetSubsystem();
+
+		FDebugTestResult Res = true;
+
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdHelmet, 1);
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdRock, 8);
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdSticks, 3);
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdSpear, 1);
+		Res &= ViewModel->AssertViewModelSettled();
+
+		// Scatter the grid the way a player would, leaving partial stacks apart
+		const int32 RockPartialSlot = ViewModel->GetGridItem(2).ItemId == ItemIdRock ? 2 : 1;
+		ViewModel->MoveItem(FGameplayTag(), RockPartialSlot, FGameplayTag(), 7);
+		const int32 SticksSlot = ViewModel->GetGridItem(3).ItemId == ItemIdSticks ? 3 : 2;
+		ViewModel->SplitItem(FGameplayTag(), SticksSlot, FGameplayTag(), 8, 1);
+		Res &= ViewModel->AssertViewModelSettled();
+
+		Res &= Test->TestTrue(TEXT("Grid should sort"), ViewModel->SortAndCompactGrid());
+		Res &= Test->TestTrue(TEXT("Slot 0 should hold a full rock stack"), ViewModel->GetGridItem(0).ItemId == ItemIdRock && ViewModel->GetGridItem(0).Quantity == 5);
+		Res &= Test->TestTrue(TEXT("Slot 1 should hold the remaining rocks"), ViewModel->GetGridItem(1).ItemId == ItemIdRock && ViewModel->GetGridItem(1).Quantity == 3);
+		Res &= Test->TestTrue(TEXT("Sticks should be merged into slot 2"), ViewModel->GetGridItem(2).ItemId == ItemIdSticks && ViewModel->GetGridItem(2).Quantity == 3);
+		Res &= Test->TestTrue(TEXT("Spear should follow the resources"), ViewModel->GetGridItem(3).ItemId == ItemIdSpear);
+		Res &= Test->TestTrue(TEXT("Helmet should be last"), ViewModel->GetGridItem(4).ItemId == ItemIdHelmet);
+		for (int32 SlotIndex = 5; SlotIndex < 9; ++SlotIndex)
+		{
+			Res &= Test->TestTrue(FString::Printf(TEXT("Slot %d should be empty after compacting"), SlotIndex), ViewModel->IsGridSlotEmpty(SlotIndex));
+		}
+		Res &= ViewModel->AssertViewModelSettled();
+
+		// Sorting a sorted grid changes nothing and broadcasts nothing
+		TArray<int32> UpdatedSlots;
+		auto* DelegateHelper = NewObject<UTestDelegateForwardHelper>();
+		DelegateHelper->CallFuncGridSlot = [&UpdatedSlots](int32 SlotIndex, const TArray<UItemInstanceData*>&) { UpdatedSlots.Add(SlotIndex); };
+		ViewModel->OnGridSlotUpdated.AddDynamic(DelegateHelper, &UTestDelegateForwardHelper::DispatchGridSlot);
+		Res &= Test->TestTrue(TEXT("Sorted grid should sort again"), ViewModel->SortAndCompactGrid());
+		Res &= Test->TestEqual(TEXT("Sorting a sorted grid should not broadcast"), UpdatedSlots.Num(), 0);
+
+		// The placement index follows the sorted layout
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdRock, 2);
+		Res &= Test->TestEqual(TEXT("New rocks should top up the partial stack"), ViewModel->GetGridItem(1).Quantity, 5);
+		Res &= ViewModel->AssertViewModelSettled();
+
+		// The component sorts its own item order the same way
+		InventoryComponent->SortItems_IfServer();
+		const TArray<FItemBundle> Items = InventoryComponent->GetAllItems();
+		Res &= Test->TestTrue(TEXT("Component items should be in sort order"), Items.Num() == 4 && Items[0].ItemId == ItemIdRock &&
+			Items[1].ItemId == ItemIdSticks && Items[2].ItemId == ItemIdSpear && Items[3].ItemId == ItemIdHelmet);
+
+		return Res;
+	}
+
+	bool TestPagedGrid()
+	{
+		GridViewModelTestContext Context(10000, 2000, false);
+		auto* InventoryComponent = Context.InventoryComponent;
+		auto* ViewModel = Context.ViewModel;
+		auto* Subsystem = Context.TestFixture.GetSubsystem();
+
+		FDebugTestResult Res = true;
+
+		ViewModel->SetGridPageSize(100);
+		Res &= Test->TestEqual(TEXT("2000 slots should make 20 pages"), ViewModel->GetNumGridPages(), 20);
+
+		TArray<int32> UpdatedSlots;
+		auto* DelegateHelper = NewObject<UTestDelegateForwardHelper>();
+		DelegateHelper->CallFuncGridSlot = [&UpdatedSlots](int32 SlotIndex, const TArray<UItemInstanceData*>&) { UpdatedSlots.Add(SlotIndex); };
+		ViewModel->OnGridSlotUpdated.AddDynamic(DelegateHelper, &UTestDelegateForwardHelper::DispatchGridSlot);
+
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdRock, 5);
+		Res &= Test->TestEqual(TEXT("Slot on the visible page should be broadcast"), UpdatedSlots.Num(), 1);
+
+		// Slots on hidden pages are still updated, only the broadcast is skipped
+		ViewModel->SetVisibleGridPage(1);
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdSticks, 5);
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdHelmet, 1);
+		Res &= Test->TestEqual(TEXT("Slots on a hidden page should not be broadcast"), UpdatedSlots.Num(), 1);
+		Res &= Test->TestTrue(TEXT("Hidden slot should still hold the sticks"), ViewModel->GetGridItem(1).ItemId == ItemIdSticks && !ViewModel->IsGridSlotVisible(1));
+		Res &= ViewModel->AssertViewModelSettled();
+
+		ViewModel->SetVisibleGridPage(100);
+		Res &= Test->TestEqual(TEXT("Visible page should be clamped to the last page"), ViewModel->GetVisibleGridPage(), 19);
+
+		// Filtering
+		const TArray<int32> StickSlots = ViewModel->FilterGridSlots(FGameplayTagQuery(), TEXT("stick"));
+		Res &= Test->TestTrue(TEXT("Name filter should find the sticks"), StickSlots.Num() == 1 && StickSlots[0] == 1);
+		const TArray<int32> HelmetSlots = ViewModel->FilterGridSlots(FGameplayTagQuery::MakeQuery_MatchTag(HelmetSlot), FString());
+		Res &= Test->TestTrue(TEXT("Category filter should find the helmet"), HelmetSlots.Num() == 1 && HelmetSlots[0] == 2);
+		Res &= Test->TestEqual(TEXT("Empty filters should match every occupied slot"), ViewModel->FilterGridSlots(FGameplayTagQuery(), FString()).Num(), 3);
+
+		// First slot index
+		Res &= Test->TestEqual(TEXT("First rock slot should be indexed"), ViewModel->FindFirstGridSlotWithItem(ItemIdRock), 0);
+		Res &= Test->TestEqual(TEXT("First stick slot should be indexed"), ViewModel->FindFirstGridSlotWithItem(ItemIdSticks), 1);
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdRock, 5);
+		InventoryComponent->DestroyItem_IfServer(ItemIdRock, 5, {}, EItemChangeReason::Removed);
+		int32 ExpectedFirstRockSlot = INDEX_NONE;
+		for (int32 SlotIndex = 0; SlotIndex < 2000 && ExpectedFirstRockSlot == INDEX_NONE; ++SlotIndex)
+		{
+			if (ViewModel->GetGridItem(SlotIndex).ItemId == ItemIdRock)
+				ExpectedFirstRockSlot = SlotIndex;
+		}
+		Res &= Test->TestTrue(TEXT("First slot should move on when the first stack is removed"), ExpectedFirstRockSlot != INDEX_NONE && ViewModel->FindFirstGridSlotWithItem(ItemIdRock) == ExpectedFirstRockSlot);
+
+		InventoryComponent->DestroyItem_IfServer(ItemIdSticks, 5, {}, EItemChangeReason::Removed);
+		Res &= Test->TestEqual(TEXT("Removed items should no longer match"), ViewModel->FilterGridSlots(FGameplayTagQuery(), TEXT("stick")).Num(), 0);
+		Res &= Test->TestEqual(TEXT("Removed items should have no first slot"), ViewModel->FindFirstGridSlotWithItem(ItemIdSticks), -1);
+
+		// Only the visible page is copied out for widgets
+		Res &= Test->TestEqual(TEXT("The last page should be visible"), ViewModel->GetVisibleGridPageItems().Num(), 100);
+		ViewModel->SetVisibleGridPage(0);
+		const TArray<FItemBundle> FirstPageItems = ViewModel->GetVisibleGridPageItems();
+		Res &= Test->TestTrue(TEXT("The first page should start with the first slot"), FirstPageItems.Num() == 100 && FirstPageItems[2].ItemId == ItemIdHelmet);
+
+		// Bundles are only built for the slots that are read, container changes and hidden pages build none
+		ViewModel->MoveItem(FGameplayTag(), ViewModel->FindFirstGridSlotWithItem(ItemIdRock), FGameplayTag(), 150);
+		ViewModel->SetVisibleGridPage(1);
+		int32 BuiltBefore = Context.GetNumGridItemsBuilt();
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdSticks, 5);
+		InventoryComponent->DestroyItem_IfServer(ItemIdSticks, 5, {}, EItemChangeReason::Removed);
+		Res &= Test->TestEqual(TEXT("Container changes should not build grid bundles"), Context.GetNumGridItemsBuilt() - BuiltBefore, 0);
+
+		BuiltBefore = Context.GetNumGridItemsBuilt();
+		const TArray<FItemBundle> SecondPageItems = ViewModel->GetVisibleGridPageItems();
+		Res &= Test->TestTrue(TEXT("The second page should hold the moved rocks"), SecondPageItems.Num() == 100 && SecondPageItems[50].ItemId == ItemIdRock);
+		Res &= Test->TestEqual(TEXT("Only the occupied slot of the visible page should be built"), Context.GetNumGridItemsBuilt() - BuiltBefore, 1);
+		Res &= ViewModel->AssertViewModelSettled();
+
+		ViewModel->SetGridPageSize(0);
+		Res &= Test->TestTrue(TEXT("Every slot should be visible without paging"), ViewModel->GetNumGridPages() == 1 && ViewModel->IsGridSlotVisible(1999));
+
+		return Res;
+	}
+
+	bool TestSettledChecksum()
+	{
+		GridViewModelTestContext Context(1000, 500, false);
+		auto* InventoryComponent = Context.InventoryComponent;
+		auto* ViewModel = Context.ViewModel;
+		auto* Subsystem = Context.TestFixture.GetSubsystem();
+
+		FDebugTestResult Res = true;
+
+		Res &= Test->TestTrue(TEXT("Empty view model should match its component"), Context.ChecksumsMatch());
+
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdRock, 12);
+		InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdSticks, 3);
+		InventoryComponent->AddItemToTaggedSlot_IfServer(Subsystem, HelmetSlot, ItemIdHelmet, 1);
+		ViewModel->MoveItem(FGameplayTag(), 0, FGameplayTag(), 40);
+		ViewModel->SplitItem(FGameplayTag(), 1, FGameplayTag(), 41, 2);
+		InventoryComponent->DestroyItem_IfServer(ItemIdRock, 4, {}, EItemChangeReason::Removed);
+		Res &= Test->TestTrue(TEXT("Checksums should follow adds, moves, splits and removals"), Context.ChecksumsMatch());
+		Res &= ViewModel->AssertViewModelSettled();
+
+		// A desynced grid slot is caught without scanning the grid
+		const int32 RockSlot = ViewModel->FilterGridSlots(FGameplayTagQuery(), TEXT("Rock"))[0];
+		FItemBundle Rocks = ViewModel->GetGridItem(RockSlot);
+		Rocks.Quantity -= 1;
+		Context.SetGridSlot(RockSlot, Rocks);
+		Res &= Test->TestFalse(TEXT("Changed grid quantity should break the checksum"), Context.ChecksumsMatch());
+		Rocks.Quantity += 1;
+		Context.SetGridSlot(RockSlot, Rocks);
+		Res &= Test->TestTrue(TEXT("Restored grid quantity should match again"), Context.ChecksumsMatch());
+
+		// Same total but the helmet shown in the grid instead of its tagged slot
+		const int32 EmptySlot = 100;
+		Context.SetGridSlot(EmptySlot, ViewModel->GetItemForTaggedSlot(HelmetSlot));
+		const FItemBundle Helmet = ViewModel->GetMutableItemForTaggedSlot(HelmetSlot);
+		ViewModel->GetMutableItemForTaggedSlot(HelmetSlot) = FItemBundle::EmptyItemInstance;
+		Res &= Test->TestFalse(TEXT("Item moved out of its tagged slot should break the checksum"), Context.ChecksumsMatch());
+		ViewModel->GetMutableItemForTaggedSlot(HelmetSlot) = Helmet;
+		Context.SetGridSlot(EmptySlot, FItemBundle::EmptyItemInstance);
+		Res &= Test->TestTrue(TEXT("Restored tagged slot should match again"), Context.ChecksumsMatch());
+
+		const double StartTime = FPlatformTime::Seconds();
+		constexpr int32 Iterations = 10000;
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			Res &= ViewModel->AssertViewModelSettled();
+		}
+		Test->AddInfo(FString::Printf(TEXT("AssertViewModelSettled on %d slots: %.3f us per call"), ViewModel->NumberOfGridSlots, (FPlatformTime::Seconds() - StartTime) * 1e6 / Iterations));
+
+		return Res;
+	}
+
+	bool TestGridPlacementIndex()
+	{
+		FDebugTestResult Res = true;
+
+		for (const int32 NumSlots : { 50, 500, 5000 })
+		{
+			GridViewModelTestContext Context(NumSlots * 10, NumSlots, false);
+			auto* InventoryComponent = Context.InventoryComponent;
+			auto* ViewModel = Context.ViewModel;
+			auto* Subsystem = Context.TestFixture.GetSubsystem();
+
+			// One large pickup that fills every grid slot, placed as unpredicted adds through HandleItemAdded
+			double StartTime = FPlatformTime::Seconds();
+			InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdRock, NumSlots * 5, EPreferredSlotPolicy::PreferGenericInventory);
+			const double FillSeconds = FPlatformTime::Seconds() - StartTime;
+
+			Res &= Test->TestTrue(FString::Printf(TEXT("[%d slots] Every slot should hold a full stack"), NumSlots),
+				ViewModel->GetGridItem(0).Quantity == 5 && ViewModel->GetGridItem(NumSlots - 1).Quantity == 5);
+			Res &= ViewModel->AssertViewModelSettled();
+
+			StartTime = FPlatformTime::Seconds();
+			Context.ForceFullUpdate();
+			const double ResyncSeconds = FPlatformTime::Seconds() - StartTime;
+
+			Test->AddInfo(FString::Printf(TEXT("Grid placement benchmark [%d slots]: fill %.3f ms, resync %.3f ms"),
+				NumSlots, FillSeconds * 1000.0, ResyncSeconds * 1000.0));
+
+			// Freed slots and partial stacks are picked up by later adds
+			InventoryComponent->DestroyItem_IfServer(ItemIdRock, 5, FItemBundle::NoInstances, EItemChangeReason::Removed);
+			Res &= Test->TestTrue(FString::Printf(TEXT("[%d slots] First slot should be freed"), NumSlots), ViewModel->IsGridSlotEmpty(0));
+			InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdSticks, 3, EPreferredSlotPolicy::PreferGenericInventory);
+			InventoryComponent->AddItemToAnySlot(Subsystem, ItemIdSticks, 1, EPreferredSlotPolicy::PreferGenericInventory);
+			Res &= Test->TestTrue(FString::Printf(TEXT("[%d slots] Sticks should be stacked in the freed slot"), NumSlots),
+				ViewModel->GetGridItem(0).ItemId == ItemIdSticks && ViewModel->GetGridItem(0).Quantity == 4);
+			Res &= ViewModel->AssertViewModelSettled();
+		}
+
+		return Res;
+	}
 	
 };
 
@@ -2339,6 +2624,11 @@ bool FRISGridViewModelTest::RunTest(const FString& Parameters)
     Res &= TestScenarios.TestUseInstanceDataItems();
 	Res &= TestScenarios.TestMoveItemToOtherViewModel();
 	Res &= TestScenarios.TestRecursiveContainers();
+	Res &= TestScenarios.TestIncrementalFullUpdate();
+	Res &= TestScenarios.TestGridPlacementIndex();
+	Res &= TestScenarios.TestSortAndCompact();
+	Res &= TestScenarios.TestPagedGrid();
+	Res &= TestScenarios.TestSettledChecksum();
 
 	/* Things to test:
 	 * Container filled with 1/5 rocks -> add sticks
@@ -969,6 +969,243 @@ public:
 		return Res;
 	}
 
+	bool TestRecipeAvailabilityTracking()
+	{
+		InventoryComponentTestContext Context(100);
+		auto* InventoryComponent = Context.InventoryComponent;
+		auto* Subsystem = Context.TestFixture.GetSubsystem();
+
+		FDebugTestResult Res = true;
+
+		UItemRecipeData* SpearRecipe = NewObject<UItemRecipeData>();
+		SpearRecipe->ResultingItemId = ItemIdSpear;
+		SpearRecipe->Components.Add(FItemBundle(TwoRocks));
+		SpearRecipe->Components.Add(FItemBundle(ThreeSticks));
+		SpearRecipe->Tags.AddTag(RecipeTagItems);
+		Subsystem->HardcodeRecipe(ItemIdSpear, SpearRecipe);
+
+		const FPrimaryRISRecipeId SpearRecipeId(SpearRecipe->GetPrimaryAssetId().PrimaryAssetType, SpearRecipe->GetPrimaryAssetId().PrimaryAssetName);
+		Res &= Test->TestTrue(TEXT("Hardcoded recipe should resolve to a registry handle"), URISSubsystem::ResolveRecipeHandle(SpearRecipeId).IsValid());
+		Res &= Test->TestTrue(TEXT("Recipe registry should return the hardcoded recipe"), URISSubsystem::GetRecipeDataById(SpearRecipeId) == SpearRecipe);
+		Res &= Test->TestEqual(TEXT("Registry should flatten both ingredients"), URISSubsystem::GetRecipeIngredientIds(URISSubsystem::ResolveRecipeHandle(SpearRecipeId)).Num(), 2);
+
+		// Re-registering a recipe id reuses its ingredient range if the count matches, otherwise the range is removed and the ones behind it compacted
+		UItemRecipeData* PurseRecipe = NewObject<UItemRecipeData>();
+		PurseRecipe->ResultingItemId = ItemIdCoinPurse;
+		PurseRecipe->Components.Add(FItemBundle(TwoRocks));
+		PurseRecipe->Components.Add(FItemBundle(ThreeSticks));
+		Subsystem->HardcodeRecipe(ItemIdCoinPurse, PurseRecipe);
+		UItemRecipeData* BackpackRecipe = NewObject<UItemRecipeData>();
+		BackpackRecipe->ResultingItemId = ItemIdBackpack;
+		BackpackRecipe->Components.Add(FItemBundle(FiveSticks));
+		Subsystem->HardcodeRecipe(ItemIdBackpack, BackpackRecipe);
+		const FRISRecipeHandle PurseHandle = URISSubsystem::ResolveRecipeHandle(PurseRecipe->GetPrimaryAssetId());
+		const FRISRecipeHandle BackpackHandle = URISSubsystem::ResolveRecipeHandle(BackpackRecipe->GetPrimaryAssetId());
+		const FGameplayTag* PurseIngredients = URISSubsystem::GetRecipeIngredientIds(PurseHandle).GetData();
+		const FGameplayTag* BackpackIngredients = URISSubsystem::GetRecipeIngredientIds(BackpackHandle).GetData();
+
+		UItemRecipeData* SameSizePurseRecipe = NewObject<UItemRecipeData>();
+		SameSizePurseRecipe->ResultingItemId = ItemIdCoinPurse;
+		SameSizePurseRecipe->Components.Add(FItemBundle(ThreeRocks));
+		SameSizePurseRecipe->Components.Add(FItemBundle(OneStick));
+		Subsystem->HardcodeRecipe(ItemIdCoinPurse, SameSizePurseRecipe);
+		Res &= Test->TestTrue(TEXT("Replacing a recipe should keep its handle"), URISSubsystem::ResolveRecipeHandle(SameSizePurseRecipe->GetPrimaryAssetId()) == PurseHandle);
+		Res &= Test->TestTrue(TEXT("A replaced recipe with as many ingredients should reuse its range"), URISSubsystem::GetRecipeIngredientIds(PurseHandle).GetData() == PurseIngredients);
+		Res &= Test->TestEqual(TEXT("The reused range should hold the new quantities"), URISSubsystem::GetRecipeIngredientQuantities(PurseHandle)[0], 3);
+
+		UItemRecipeData* SmallerPurseRecipe = NewObject<UItemRecipeData>();
+		SmallerPurseRecipe->ResultingItemId = ItemIdCoinPurse;
+		SmallerPurseRecipe->Components.Add(FItemBundle(OneRock));
+		Subsystem->HardcodeRecipe(ItemIdCoinPurse, SmallerPurseRecipe);
+		const TConstArrayView<FGameplayTag> BackpackIngredientIds = URISSubsystem::GetRecipeIngredientIds(BackpackHandle);
+		Res &= Test->TestTrue(TEXT("Ranges behind a resized recipe should move down over its old range"), BackpackIngredientIds.GetData() == BackpackIngredients - 2);
+		Res &= Test->TestTrue(TEXT("Moved ranges should keep their ingredients"), BackpackIngredientIds.Num() == 1 && BackpackIngredientIds[0] == ItemIdSticks);
+		Res &= Test->TestTrue(TEXT("The resized recipe should be appended without leaving a gap"), URISSubsystem::GetRecipeIngredientIds(PurseHandle).GetData() == BackpackIngredientIds.GetData() + 1);
+		Res &= Test->TestEqual(TEXT("The resized recipe should hold its new ingredients"), URISSubsystem::GetRecipeIngredientQuantities(PurseHandle).Num(), 1);
+
+		InventoryComponent->RecipeTagFilters.AddTag(RecipeTagItems);
+		Res &= Test->TestFalse(TEXT("Recipe should not be unlocked initially"), InventoryComponent->IsRecipeUnlocked(SpearRecipeId));
+		InventoryComponent->SetRecipeLock_Server(SpearRecipeId, false);
+		Res &= Test->TestTrue(TEXT("Recipe should be unlocked"), InventoryComponent->IsRecipeUnlocked(SpearRecipeId));
+		Res &= Test->TestEqual(TEXT("Unlocked recipe without ingredients should not be available"), InventoryComponent->GetAvailableRecipes(RecipeTagItems).Num(), 0);
+
+		InventoryComponent->AddItem_IfServer(Subsystem, TwoRocks);
+		Res &= Test->TestEqual(TEXT("Recipe should not be available with only rocks"), InventoryComponent->GetAvailableRecipes(RecipeTagItems).Num(), 0);
+		InventoryComponent->AddItemToTaggedSlot_IfServer(Subsystem, LeftHandSlot, ThreeSticks, true);
+		Res &= Test->TestTrue(TEXT("Recipe should become available once all components are present"), InventoryComponent->GetAvailableRecipes(RecipeTagItems).Contains(SpearRecipe));
+
+		InventoryComponent->RemoveQuantityFromTaggedSlot_IfServer(LeftHandSlot, 1, FItemBundle::NoInstances, EItemChangeReason::Removed, true);
+		Res &= Test->TestEqual(TEXT("Recipe should become unavailable when a component drops below the required quantity"), InventoryComponent->GetAvailableRecipes(RecipeTagItems).Num(), 0);
+		InventoryComponent->AddItem_IfServer(Subsystem, OneStick);
+		Res &= Test->TestEqual(TEXT("Recipe should be listed once after becoming available again"), InventoryComponent->GetAvailableRecipes(RecipeTagItems).Num(), 1);
+
+		// Re-registering the unlocked recipe with fewer ingredients rebuilds the availability index of the component
+		UItemRecipeData* StickSpearRecipe = NewObject<UItemRecipeData>();
+		StickSpearRecipe->ResultingItemId = ItemIdSpear;
+		StickSpearRecipe->Components.Add(FItemBundle(FiveSticks));
+		StickSpearRecipe->Tags.AddTag(RecipeTagItems);
+		Subsystem->HardcodeRecipe(ItemIdSpear, StickSpearRecipe);
+		Res &= Test->TestEqual(TEXT("Re-registered recipe should be re-evaluated against its new ingredients"), InventoryComponent->GetAvailableRecipes(RecipeTagItems).Num(), 0);
+		InventoryComponent->AddItem_IfServer(Subsystem, OneRock);
+		Res &= Test->TestEqual(TEXT("Items dropped from the recipe should no longer affect it"), InventoryComponent->GetAvailableRecipes(RecipeTagItems).Num(), 0);
+		InventoryComponent->AddItem_IfServer(Subsystem, OneStick);
+		InventoryComponent->AddItem_IfServer(Subsystem, OneStick);
+		Res &= Test->TestTrue(TEXT("Re-registered recipe should become available from its new ingredients"), InventoryComponent->GetAvailableRecipes(RecipeTagItems).Contains(StickSpearRecipe));
+		InventoryComponent->RemoveQuantityFromTaggedSlot_IfServer(LeftHandSlot, 1, FItemBundle::NoInstances, EItemChangeReason::Removed, true);
+		Res &= Test->TestEqual(TEXT("Re-registered recipe should track its new required quantity"), InventoryComponent->GetAvailableRecipes(RecipeTagItems).Num(), 0);
+
+		InventoryComponent->SetRecipeLock_Server(SpearRecipeId, true);
+		Res &= Test->TestFalse(TEXT("Recipe should be locked again"), InventoryComponent->IsRecipeUnlocked(SpearRecipeId));
+		Res &= Test->TestEqual(TEXT("Locked recipe should not be available"), InventoryComponent->GetAvailableRecipes(RecipeTagItems).Num(), 0);
+
+		return Res;
+	}
+
+	bool TestBulkAndMultiStepCrafting()
+	{
+		InventoryComponentTestContext Context(100);
+		auto* InventoryComponent = Context.InventoryComponent;
+		auto* Subsystem = Context.TestFixture.GetSubsystem();
+
+		FDebugTestResult Res = true;
+
+		// Rock + stick -> spear, and rocks can be crafted from sticks as an intermediate
+		UItemRecipeData* SpearRecipe = NewObject<UItemRecipeData>();
+		SpearRecipe->ResultingItemId = ItemIdSpear;
+		SpearRecipe->Components.Add(FItemBundle(OneRock));
+		SpearRecipe->Components.Add(FItemBundle(OneStick));
+
+		UItemRecipeData* RockRecipe = NewObject<UItemRecipeData>();
+		RockRecipe->ResultingItemId = ItemIdRock;
+		RockRecipe->QuantityCreated = 2;
+		RockRecipe->Components.Add(FItemBundle(ItemIdSticks, 1));
+		Subsystem->HardcodeRecipe(ItemIdRock, RockRecipe);
+
+		InventoryComponent->AddItem_IfServer(Subsystem, ThreeRocks);
+		InventoryComponent->AddItem_IfServer(Subsystem, FiveSticks);
+		Res &= Test->TestEqual(TEXT("Max craftable should be limited by the scarcest component"), InventoryComponent->GetMaxCraftableCount(SpearRecipe), 3);
+
+		Res &= Test->TestEqual(TEXT("Non partial bulk craft beyond the max should craft nothing"), InventoryComponent->CraftRecipeQuantity_IfServer(SpearRecipe, 4, false), 0);
+		Res &= Test->TestEqual(TEXT("Failed bulk craft should not consume rocks"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdRock), 3);
+		Res &= Test->TestEqual(TEXT("Partial bulk craft should craft the max"), InventoryComponent->CraftRecipeQuantity_IfServer(SpearRecipe, 4, true), 3);
+		Res &= Test->TestEqual(TEXT("Bulk craft should consume all rocks"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdRock), 0);
+		Res &= Test->TestEqual(TEXT("Bulk craft should consume 3 sticks"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdSticks), 2);
+		Res &= Test->TestEqual(TEXT("Bulk craft should produce 3 spears"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdSpear), 3);
+
+		// Without the rock recipe unlocked there is no plan
+		TArray<FRISCraftStep> Steps;
+		Res &= Test->TestFalse(TEXT("Planner should not use locked intermediate recipes"), InventoryComponent->PlanCraft(SpearRecipe, 1, Steps));
+
+		const FPrimaryAssetId RockRecipeId = RockRecipe->GetPrimaryAssetId();
+		InventoryComponent->SetRecipeLock_Server(FPrimaryRISRecipeId(RockRecipeId.PrimaryAssetType, RockRecipeId.PrimaryAssetName), false);
+		Res &= Test->TestTrue(TEXT("Planner should find a plan through the unlocked rock recipe"), InventoryComponent->PlanCraft(SpearRecipe, 1, Steps));
+		Res &= Test->TestEqual(TEXT("Plan should have the intermediate step followed by the spear"), Steps.Num(), 2);
+
+		// Component quantities times a huge count must not wrap around and pass the stock check
+		UItemRecipeData* DoubleRockSpearRecipe = NewObject<UItemRecipeData>();
+		DoubleRockSpearRecipe->ResultingItemId = ItemIdSpear;
+		DoubleRockSpearRecipe->Components.Add(FItemBundle(TwoRocks));
+		Res &= Test->TestFalse(TEXT("Planner should reject counts whose quantities overflow"), InventoryComponent->PlanCraft(DoubleRockSpearRecipe, MAX_int32, Steps));
+		Res &= Test->TestFalse(TEXT("Overflowing multi-step craft should fail"), InventoryComponent->CraftRecipeWithIntermediates_IfServer(DoubleRockSpearRecipe, MAX_int32 / 2 + 1));
+		InventoryComponent->CraftRecipeIdQuantity_Server(FPrimaryRISRecipeId(RockRecipeId.PrimaryAssetType, RockRecipeId.PrimaryAssetName), -1, false);
+		InventoryComponent->CraftRecipeIdQuantity_Server(FPrimaryRISRecipeId(RockRecipeId.PrimaryAssetType, RockRecipeId.PrimaryAssetName), MIN_int32, true);
+		Res &= Test->TestEqual(TEXT("Negative craft counts should not touch the sticks"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdSticks), 2);
+		Res &= Test->TestEqual(TEXT("Negative craft counts should not create rocks"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdRock), 0);
+		Res &= Test->TestFalse(TEXT("Two sticks cannot make two spears even with intermediates"), InventoryComponent->CraftRecipeWithIntermediates_IfServer(SpearRecipe, 2));
+		Res &= Test->TestEqual(TEXT("Failed multi-step craft should not consume anything"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdSticks), 2);
+		Res &= Test->TestTrue(TEXT("Multi-step craft should succeed"), InventoryComponent->CraftRecipeWithIntermediates_IfServer(SpearRecipe, 1));
+		Res &= Test->TestEqual(TEXT("Multi-step craft should consume both sticks"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdSticks), 0);
+		Res &= Test->TestEqual(TEXT("Leftover intermediate rock should be added"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdRock), 1);
+		Res &= Test->TestEqual(TEXT("Multi-step craft should produce a spear"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdSpear), 4);
+
+		// Queued crafts reserve their components immediately and refund them when cancelled
+		SpearRecipe->CraftingTime = 10.f;
+		InventoryComponent->AddItem_IfServer(Subsystem, OneStick);
+		Res &= Test->TestEqual(TEXT("Queue should accept one craft"), InventoryComponent->QueueCraft_IfServer(SpearRecipe, 1), 1);
+		Res &= Test->TestEqual(TEXT("Queued craft should reserve the rock"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdRock), 0);
+		Res &= Test->TestEqual(TEXT("Queued craft should not produce before its crafting time"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdSpear), 4);
+		InventoryComponent->CancelCraftQueue_IfServer();
+		Res &= Test->TestEqual(TEXT("Cancelling should refund the rock"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdRock), 1);
+		Res &= Test->TestEqual(TEXT("Cancelling should refund the stick"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdSticks), 1);
+		Res &= Test->TestEqual(TEXT("Queue should be empty after cancel"), InventoryComponent->CraftQueue.Num(), 0);
+
+		// Cancelling hands back the consumed instances themselves, so their state survives the round trip
+		UItemRecipeData* ReforgeRecipe = NewObject<UItemRecipeData>();
+		ReforgeRecipe->ResultingItemId = ItemIdSpear;
+		ReforgeRecipe->CraftingTime = 10.f;
+		ReforgeRecipe->Components.Add(FItemBundle(ItemIdBrittleCopperKnife, 1));
+		InventoryComponent->AddItem_IfServer(Subsystem, ItemIdBrittleCopperKnife, 1);
+		TArray<UItemInstanceData*> KnifeInstances = InventoryComponent->GetItemInstanceData(ItemIdBrittleCopperKnife);
+		Res &= Test->TestEqual(TEXT("Knife should have instance data"), KnifeInstances.Num(), 1);
+		UItemDurabilityTestInstanceData* KnifeDurability = KnifeInstances.Num() > 0 ? Cast<UItemDurabilityTestInstanceData>(KnifeInstances[0]) : nullptr;
+		if (KnifeDurability) KnifeDurability->Durability = 42.f;
+		Res &= Test->TestEqual(TEXT("Queue should accept the reforge"), InventoryComponent->QueueCraft_IfServer(ReforgeRecipe, 1), 1);
+		Res &= Test->TestEqual(TEXT("Queued reforge should hold the knife"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdBrittleCopperKnife), 0);
+		InventoryComponent->CancelCraftQueue_IfServer();
+		KnifeInstances = InventoryComponent->GetItemInstanceData(ItemIdBrittleCopperKnife);
+		Res &= Test->TestEqual(TEXT("Cancelling should return the knife"), KnifeInstances.Num(), 1);
+		Res &= Test->TestTrue(TEXT("Returned knife should be the consumed instance"), KnifeInstances.Num() > 0 && KnifeInstances[0] == KnifeDurability);
+		Res &= Test->TestTrue(TEXT("Returned knife should keep its durability"), KnifeDurability && KnifeDurability->Durability == 42.f);
+
+		return Res;
+	}
+
+	bool TestCraftingFromMultipleSources()
+	{
+		InventoryComponentTestContext Context(100);
+		auto* InventoryComponent = Context.InventoryComponent;
+		auto* Subsystem = Context.TestFixture.GetSubsystem();
+
+		FDebugTestResult Res = true;
+
+		UItemContainerComponent* ChestA = NewObject<UItemContainerComponent>(Context.TempActor);
+		ChestA->MaxSlotCount = 9;
+		ChestA->MaxWeight = 100;
+		ChestA->RegisterComponent();
+		UItemContainerComponent* ChestB = NewObject<UItemContainerComponent>(Context.TempActor);
+		ChestB->MaxSlotCount = 9;
+		ChestB->MaxWeight = 100;
+		ChestB->RegisterComponent();
+		const TArray<TScriptInterface<IItemSource>> Chests = { ChestA, ChestB };
+
+		UItemRecipeData* SpearRecipe = NewObject<UItemRecipeData>();
+		SpearRecipe->ResultingItemId = ItemIdSpear;
+		SpearRecipe->Components.Add(FItemBundle(TwoRocks));
+		SpearRecipe->Components.Add(FItemBundle(OneStick));
+
+		InventoryComponent->AddItem_IfServer(Subsystem, TwoRocks);
+		ChestA->AddItem_IfServer(Subsystem, ThreeRocks);
+		ChestA->AddItem_IfServer(Subsystem, OneStick);
+		ChestB->AddItem_IfServer(Subsystem, ThreeSticks);
+		ChestB->AddItem_IfServer(Subsystem, OneRock);
+
+		Res &= Test->TestEqual(TEXT("Own inventory alone cannot craft"), InventoryComponent->GetMaxCraftableCount(SpearRecipe), 0);
+		Res &= Test->TestEqual(TEXT("Combined sources should allow three crafts"), InventoryComponent->GetMaxCraftableCountFromSources(SpearRecipe, Chests), 3);
+		Res &= Test->TestEqual(TEXT("Non partial craft beyond the combined max should craft nothing"),
+			InventoryComponent->CraftRecipeFromSources_IfServer(SpearRecipe, 4, Chests, ECraftingSourceOrder::OwnInventoryFirst, false), 0);
+		Res &= Test->TestEqual(TEXT("Failed craft should leave chest A untouched"), ChestA->GetQuantityTotal_Implementation(ItemIdRock), 3);
+
+		Res &= Test->TestEqual(TEXT("Should craft once from sources"),
+			InventoryComponent->CraftRecipeFromSources_IfServer(SpearRecipe, 1, Chests, ECraftingSourceOrder::OwnInventoryFirst), 1);
+		Res &= Test->TestEqual(TEXT("Own rocks should be consumed first"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdRock), 0);
+		Res &= Test->TestEqual(TEXT("Chest rocks should be untouched"), ChestA->GetQuantityTotal_Implementation(ItemIdRock), 3);
+		Res &= Test->TestEqual(TEXT("Stick should come from the first chest in order"), ChestA->GetQuantityTotal_Implementation(ItemIdSticks), 0);
+		Res &= Test->TestEqual(TEXT("Spear should be added to the crafting inventory"), InventoryComponent->GetQuantityTotal_Implementation(ItemIdSpear), 1);
+
+		Res &= Test->TestEqual(TEXT("Should craft once more preferring the largest source"),
+			InventoryComponent->CraftRecipeFromSources_IfServer(SpearRecipe, 1, Chests, ECraftingSourceOrder::LargestSourceFirst), 1);
+		Res &= Test->TestEqual(TEXT("Rocks should come from the chest holding the most"), ChestA->GetQuantityTotal_Implementation(ItemIdRock), 1);
+		Res &= Test->TestEqual(TEXT("Sticks should come from chest B"), ChestB->GetQuantityTotal_Implementation(ItemIdSticks), 2);
+
+		Res &= Test->TestEqual(TEXT("Last craft should span both chests"),
+			InventoryComponent->CraftRecipeFromSources_IfServer(SpearRecipe, 5, Chests, ECraftingSourceOrder::ExternalSourcesFirst), 1);
+		Res &= Test->TestEqual(TEXT("Chest A rocks should be used up"), ChestA->GetQuantityTotal_Implementation(ItemIdRock), 0);
+		Res &= Test->TestEqual(TEXT("Chest B rocks should be used up"), ChestB->GetQuantityTotal_Implementation(ItemIdRock), 0);
+		Res &= Test->TestEqual(TEXT("Chest A weight should be updated after the batched removal"), ChestA->CurrentWeight, 0.f);
+
+		return Res;
+	}
+
     bool TestCraftRecipe()
     {
         InventoryComponentTestContext Context(100);
@@ -1834,6 +2071,9 @@ bool FRancInventoryComponentTest::RunTest(const FString& Parameters)
 	Res &= TestScenarios.TestEventBroadcasting();
 	Res &= TestScenarios.TestIndirectOperations();
 	Res &= TestScenarios.TestCanCraftRecipe();
+	Res &= TestScenarios.TestRecipeAvailabilityTracking();
+	Res &= TestScenarios.TestBulkAndMultiStepCrafting();
+	Res &= TestScenarios.TestCraftingFromMultipleSources();
 	Res &= TestScenarios.TestInventoryMaxCapacity();
 	Res &= TestScenarios.TestReceivableQuantity();
 
@@ -34,6 +34,8 @@ UE_DEFINE_GAMEPLAY_TAG(ItemTypeMakeshiftWeapon, "Test.Gameplay.Items.Types.Makes
 UE_DEFINE_GAMEPLAY_TAG(ItemTypeRangedWeapon, "Test.Gameplay.Items.Types.RangedWeapon");
 UE_DEFINE_GAMEPLAY_TAG(ItemTypeContainer, "Test.Gameplay.Items.Types.Container");
 
+UE_DEFINE_GAMEPLAY_TAG(RecipeTagItems, "Test.Gameplay.Recipes.Items");
+
 UE_DEFINE_GAMEPLAY_TAG(ItemIdRock, "Test.Items.IDs.Rock");
 UE_DEFINE_GAMEPLAY_TAG(ItemIdSticks, "Test.Items.IDs.Sticks");
 UE_DEFINE_GAMEPLAY_TAG(ItemIdSpear, "Test.Items.IDs.StoneSpear");
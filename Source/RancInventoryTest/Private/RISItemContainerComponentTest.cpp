@@ -8,6 +8,7 @@
 #include "Misc/AutomationTest.h"
 #include "RISInventoryTestSetup.cpp"
 #include "Components/ItemContainerComponent.h"
+#include "Framework/AllocationCounter.h"
 #include "Framework/DebugTestResult.h"
 #include "Framework/TestDelegateForwardHelper.h"
 #include "MockClasses/ItemHoldingCharacter.h"
@@ -718,6 +719,459 @@ public:
 		return Res;
 	}
 
+	static bool TestLootTables(FRancItemContainerComponentTest* Test)
+	{
+		FItemContainerTestContext Context(20, 1000);
+		auto* Subsystem = Context.TestFixture.GetSubsystem();
+
+		FDebugTestResult Res = true;
+
+		FRandomItemPool Pool;
+		Pool.Description = FName("TestPool");
+		FRandomItemSelection RockSelection;
+		RockSelection.ItemData = URISSubsystem::GetItemDataById(ItemIdRock);
+		RockSelection.DiceCount = 2;
+		RockSelection.DiceSides = 3;
+		FRandomItemSelection StickSelection;
+		StickSelection.ItemData = URISSubsystem::GetItemDataById(ItemIdSticks);
+		FRandomItemSelection HelmetSelection;
+		HelmetSelection.ItemData = URISSubsystem::GetItemDataById(ItemIdHelmet);
+		Pool.Items = { RockSelection, StickSelection, HelmetSelection };
+		Pool.ItemWeights = { 3.f, 1.f, 0.f };
+
+		const FRISCompiledLootTable Table = URISSubsystem::CompileLootTable(Pool);
+		Res &= Test->TestEqual(TEXT("Zero weight selections should be dropped when compiling"), Table.Selections.Num(), 2);
+
+		// Same seed, same loot
+		FRandomStream StreamA(1234), StreamB(1234);
+		TArray<FItemBundle> LootA, LootB;
+		URISSubsystem::RollLootTable(Table, 50, StreamA, LootA);
+		URISSubsystem::RollLootTable(Table, 50, StreamB, LootB);
+		Res &= Test->TestEqual(TEXT("Seeded rolls should produce the same number of bundles"), LootA.Num(), LootB.Num());
+		for (int32 i = 0; i < FMath::Min(LootA.Num(), LootB.Num()); ++i)
+		{
+			Res &= Test->TestTrue(TEXT("Seeded rolls should produce identical loot"), LootA[i].ItemId == LootB[i].ItemId && LootA[i].Quantity == LootB[i].Quantity);
+		}
+
+		// Picks should follow the 3:1 weights, rocks roll 2d3 (mean 4) and sticks 1d1
+		const int32 Rolls = 40000;
+		FRandomStream Stream(42);
+		TArray<FItemBundle> Loot;
+		URISSubsystem::RollLootTable(Table, Rolls, Stream, Loot);
+		int32 RockQuantity = 0, StickQuantity = 0;
+		for (const FItemBundle& Bundle : Loot)
+		{
+			if (Bundle.ItemId == ItemIdRock) RockQuantity = Bundle.Quantity;
+			else if (Bundle.ItemId == ItemIdSticks) StickQuantity = Bundle.Quantity;
+			else Res &= Test->TestTrue(TEXT("Only rocks and sticks should be rolled"), false);
+		}
+		const float StickPickRate = static_cast<float>(StickQuantity) / Rolls;
+		Res &= Test->TestTrue(TEXT("Sticks should be picked about a quarter of the time"), FMath::IsNearlyEqual(StickPickRate, 0.25f, 0.02f));
+		const float AverageRockRoll = static_cast<float>(RockQuantity) / (Rolls - StickQuantity);
+		Res &= Test->TestTrue(TEXT("Rock quantity should average the 2d3 dice roll"), FMath::IsNearlyEqual(AverageRockRoll, 4.f, 0.1f));
+
+		// Batched add into a container
+		const int32 Added = Subsystem->GenerateLootIntoContainer_IfServer(Table, 5, Context.ItemContainerComponent, 7);
+		int32 ContainedTotal = Context.ItemContainerComponent->GetQuantityTotal_Implementation(ItemIdRock) + Context.ItemContainerComponent->GetQuantityTotal_Implementation(ItemIdSticks);
+		Res &= Test->TestTrue(TEXT("Loot should be added to the container"), Added > 0);
+		Res &= Test->TestEqual(TEXT("Reported quantity should match the container contents"), ContainedTotal, Added);
+		const float ExpectedWeight = Context.ItemContainerComponent->GetQuantityTotal_Implementation(ItemIdRock) * URISSubsystem::GetItemDataById(ItemIdRock)->ItemWeight +
+			Context.ItemContainerComponent->GetQuantityTotal_Implementation(ItemIdSticks) * URISSubsystem::GetItemDataById(ItemIdSticks)->ItemWeight;
+		Res &= Test->TestTrue(TEXT("The batched add should leave weight up to date"), FMath::IsNearlyEqual(Context.ItemContainerComponent->CurrentWeight, ExpectedWeight));
+
+		// Throughput
+		const int32 BenchmarkRolls = 1000000;
+		const double StartTime = FPlatformTime::Seconds();
+		URISSubsystem::RollLootTable(Table, BenchmarkRolls, Stream, Loot);
+		const double Elapsed = FMath::Max(FPlatformTime::Seconds() - StartTime, 1e-9);
+		Test->AddInfo(FString::Printf(TEXT("Loot table benchmark: %d rolls in %.3f ms, %.1f million rolls/sec"),
+			BenchmarkRolls, Elapsed * 1000.0, BenchmarkRolls / Elapsed / 1e6));
+
+		return Res;
+	}
+
+	static bool TestJigsawPlacement(FRancItemContainerComponentTest* Test)
+	{
+		FDebugTestResult Res = true;
+
+		// Fit search and rotation on a 4x3 grid
+		FRISJigsawGrid Grid;
+		Grid.Init(4, 3);
+		Res &= Test->TestTrue(TEXT("2x2 item should be placed top left"), Grid.PlaceAnywhere(ItemIdSpear, FIntPoint(2, 2), false) == 0 && Grid.GetPlacements()[0].Position == FIntPoint(0, 0));
+		FIntPoint Position;
+		bool Rotated;
+		Res &= Test->TestTrue(TEXT("3x1 item should only fit in the bottom row unrotated"), Grid.FindFit(FIntPoint(3, 1), false, Position, Rotated) && Position == FIntPoint(0, 2) && !Rotated);
+		Res &= Test->TestTrue(TEXT("3x1 item should fit earlier when rotated"), Grid.FindFit(FIntPoint(3, 1), true, Position, Rotated) && Position == FIntPoint(2, 0) && Rotated);
+		Res &= Test->TestEqual(TEXT("Eight 1x1 items should still fit"), Grid.CountFits(FIntPoint(1, 1), false), 8);
+		Res &= Test->TestEqual(TEXT("Only one more 2x2 item should fit"), Grid.CountFits(FIntPoint(2, 2), false), 1);
+
+		// Fragmented grid where auto arrange makes room
+		Grid.Init(4, 2);
+		Grid.Place(ItemIdRock, FIntPoint(1, 0), FIntPoint(1, 1), false);
+		Grid.Place(ItemIdRock, FIntPoint(2, 1), FIntPoint(1, 1), false);
+		Res &= Test->TestEqual(TEXT("Fragmented grid should not fit a 2x2 item"), Grid.CountFits(FIntPoint(2, 2), false), 0);
+		Res &= Test->TestTrue(TEXT("Auto arrange should succeed"), Grid.AutoArrange(false));
+		Res &= Test->TestEqual(TEXT("Arranged grid should fit a 2x2 item"), Grid.CountFits(FIntPoint(2, 2), false), 1);
+
+		// Containers reject items that don't physically fit even if enough cells are free
+		{
+			FItemContainerTestContext Context(12, 100);
+			auto* Subsystem = Context.TestFixture.GetSubsystem();
+			UItemStaticData* SpearData = URISSubsystem::GetItemDataById(ItemIdSpear);
+			const FIntPoint OriginalSpearSize(SpearData->JigsawSizeX, SpearData->JigsawSizeY);
+			SpearData->JigsawSizeX = 2;
+			SpearData->JigsawSizeY = 2;
+			Context.ItemContainerComponent->JigsawMode = true;
+			Context.ItemContainerComponent->JigsawGridWidth = 4;
+
+			Res &= Test->TestEqual(TEXT("First spear should be added"), Context.ItemContainerComponent->AddItem_IfServer(Subsystem, ItemIdSpear, 1, false), 1);
+			Res &= Test->TestEqual(TEXT("Only one more 2x2 spear fits into a 4x3 grid"), Context.ItemContainerComponent->AddItem_IfServer(Subsystem, ItemIdSpear, 2, true), 1);
+			Res &= Test->TestEqual(TEXT("The bottom row should take 4 stacks of rocks"),
+				Context.ItemContainerComponent->GetQuantityContainerCanReceiveBySlots(URISSubsystem::GetItemDataById(ItemIdRock)), 20);
+
+			SpearData->JigsawSizeX = OriginalSpearSize.X;
+			SpearData->JigsawSizeY = OriginalSpearSize.Y;
+		}
+
+		// Slot counts that don't fill the last row block the rest of it
+		Grid.Init(4, 3, 10);
+		Res &= Test->TestEqual(TEXT("Cells past the cell count should not be free"), Grid.GetNumFreeCells(), 10);
+		Res &= Test->TestTrue(TEXT("Cells past the cell count should be occupied"), Grid.IsCellOccupied(FIntPoint(2, 2)) && Grid.IsCellOccupied(FIntPoint(3, 2)) && !Grid.IsCellOccupied(FIntPoint(1, 2)));
+		Res &= Test->TestEqual(TEXT("Ten 1x1 items should fit"), Grid.CountFits(FIntPoint(1, 1), false), 10);
+		Res &= Test->TestTrue(TEXT("Auto arrange should keep the blocked cells"), Grid.AutoArrange(false) && Grid.GetNumFreeCells() == 10);
+
+		{
+			FItemContainerTestContext Context(10, 100);
+			auto* Subsystem = Context.TestFixture.GetSubsystem();
+			UItemContainerComponent* Container = Context.ItemContainerComponent;
+			const UItemStaticData* RockData = URISSubsystem::GetItemDataById(ItemIdRock);
+			Container->JigsawMode = true;
+			Container->JigsawGridWidth = 4;
+
+			Container->AddItem_IfServer(Subsystem, ItemIdRock, 1, false);
+			Res &= Test->TestEqual(TEXT("A partial last row should still count its slots"), Container->GetQuantityContainerCanReceiveBySlots(RockData), 49);
+			Res &= Test->TestEqual(TEXT("All ten slots should take rocks"), Container->AddItem_IfServer(Subsystem, ItemIdRock, 49, false), 49);
+			Res &= Test->TestEqual(TEXT("The full grid should not take more rocks"), Container->GetQuantityContainerCanReceiveBySlots(RockData), 0);
+
+			// Removing stacks frees their cells without repacking the other stacks
+			Container->DestroyItem_IfServer(ItemIdRock, 10, FItemBundle::NoInstances, EItemChangeReason::Removed);
+			Res &= Test->TestEqual(TEXT("Removed stacks should free their cells"), Container->GetQuantityContainerCanReceiveBySlots(RockData), 10);
+		}
+
+		// Diablo-like grid sizes filled with mixed item sizes
+		const FIntPoint ItemSizes[] = { FIntPoint(1, 1), FIntPoint(1, 2), FIntPoint(2, 2), FIntPoint(2, 3), FIntPoint(1, 3) };
+		for (const FIntPoint GridSize : { FIntPoint(10, 6), FIntPoint(15, 10), FIntPoint(20, 15) })
+		{
+			constexpr int32 Iterations = 200;
+			FRandomStream Stream(GridSize.X * GridSize.Y);
+			int32 Placed = 0;
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				Grid.Init(GridSize.X, GridSize.Y);
+				while (Grid.PlaceAnywhere(ItemIdRock, ItemSizes[Stream.RandRange(0, UE_ARRAY_COUNT(ItemSizes) - 1)], true) != INDEX_NONE)
+					++Placed;
+				Grid.CountFits(FIntPoint(1, 1), true);
+				Grid.AutoArrange(true);
+			}
+			const double Elapsed = FPlatformTime::Seconds() - StartTime;
+			Res &= Test->TestTrue(FString::Printf(TEXT("[%dx%d] Grid should be filled"), GridSize.X, GridSize.Y), Placed > 0);
+			Test->AddInfo(FString::Printf(TEXT("Jigsaw benchmark [%dx%d]: %.2f us per placement, %.3f ms per fill, count and arrange"),
+				GridSize.X, GridSize.Y, Elapsed * 1e6 / FMath::Max(Placed, 1), Elapsed * 1000.0 / Iterations));
+		}
+
+		return Res;
+	}
+
+	static bool TestTransferBetweenContainers(FRancItemContainerComponentTest* Test)
+	{
+		FItemContainerTestContext Context(20, 100);
+		auto* Subsystem = Context.TestFixture.GetSubsystem();
+		FDebugTestResult Res = true;
+
+		// The target lives on another actor so moved instances have to be re-registered
+		AActor* OtherActor = Context.TestFixture.GetWorld()->SpawnActor<AItemHoldingCharacter>();
+		UItemContainerComponent* Target = NewObject<UItemContainerComponent>(OtherActor);
+		Target->MaxSlotCount = 3;
+		Target->MaxWeight = 100;
+		Target->RegisterComponent();
+
+		UItemContainerComponent* Source = Context.ItemContainerComponent;
+		Source->AddItem_IfServer(Subsystem, ItemIdRock, 8, false);
+		Source->AddItem_IfServer(Subsystem, ItemIdBrittleEgg, 3, false);
+		Source->AddItem_IfServer(Subsystem, ItemIdSpear, 1, false);
+		const TArray<UItemInstanceData*> Eggs = Source->GetItemInstanceData(ItemIdBrittleEgg);
+
+		// 8 rocks take two slots and the eggs the third, the spear has no room left
+		Res &= Test->TestEqual(TEXT("Rocks and eggs should be transferred"), Source->TransferAllItemsTo_IfServer(Target), 11);
+		Res &= Test->TestEqual(TEXT("Target should hold 8 rocks"), Target->GetQuantityTotal_Implementation(ItemIdRock), 8);
+		Res &= Test->TestEqual(TEXT("Source should only keep the spear"), Source->GetAllItems().Num(), 1);
+		Res &= Test->TestTrue(TEXT("Egg instances should be handed over"), Target->GetItemInstanceData(ItemIdBrittleEgg) == Eggs);
+		Res &= Test->TestTrue(TEXT("Egg instances should be registered with the target actor"), OtherActor->IsReplicatedSubObjectRegistered(Eggs[0]));
+		Res &= Test->TestFalse(TEXT("Egg instances should be unregistered from the source actor"), Context.TempActor->IsReplicatedSubObjectRegistered(Eggs[0]));
+		Res &= Test->TestEqual(TEXT("Target weight should be updated"), Target->CurrentWeight, 11.f);
+		Res &= Test->TestEqual(TEXT("Source weight should be updated"), Source->CurrentWeight, 3.f);
+		Res &= Test->TestEqual(TEXT("Target slots should be updated"), Target->UsedContainerSlotCount, 3);
+
+		// Moving back a single instance and a partial stack
+		Res &= Test->TestEqual(TEXT("The requested egg should be moved back"), Target->TransferItemTo_ServerImpl(Source, ItemIdBrittleEgg, 1, { Eggs[1] }), 1);
+		Res &= Test->TestTrue(TEXT("Only the requested egg should be moved back"), Source->GetItemInstanceData(ItemIdBrittleEgg) == TArray<UItemInstanceData*>{ Eggs[1] });
+		Res &= Test->TestEqual(TEXT("3 rocks should be moved back"), Target->TransferItemTo_ServerImpl(Source, ItemIdRock, 3, UItemContainerComponent::NoInstances), 3);
+		Res &= Test->TestEqual(TEXT("Source should hold 3 rocks"), Source->GetQuantityTotal_Implementation(ItemIdRock), 3);
+		Res &= Test->TestEqual(TEXT("Source weight should match the fast path move"), Source->CurrentWeight, 7.f);
+		Res &= Test->TestEqual(TEXT("Target weight should match the fast path move"), Target->CurrentWeight, 7.f);
+		Res &= Test->TestEqual(TEXT("Checksums should stay in sync"), Source->GetItemsChecksum() + Target->GetItemsChecksum(),
+			FRISItemChecksum::Contribution(ItemIdRock, 3) + FRISItemChecksum::Contribution(ItemIdRock, 5) + FRISItemChecksum::Contribution(ItemIdSpear, 1) +
+			FRISItemChecksum::Contribution(ItemIdBrittleEgg, 1) + FRISItemChecksum::Contribution(ItemIdBrittleEgg, 2));
+
+		// Round trips of every non-recursive test item, compared to moving each item through extract and receive
+		Source->Clear_IfServer();
+		Target->Clear_IfServer();
+		Target->MaxSlotCount = 20;
+		const FGameplayTag BenchmarkItems[] = { ItemIdRock, ItemIdSticks, ItemIdSpear, ItemIdHelmet, ItemIdSpecialHelmet, ItemIdChestArmor, ItemIdBrittleEgg, ItemIdBrittleCopperKnife };
+		for (const FGameplayTag& ItemId : BenchmarkItems)
+		{
+			Source->AddItem_IfServer(Subsystem, ItemId, 1, false);
+		}
+
+		constexpr int32 RoundTrips = 500;
+		double StartTime = FPlatformTime::Seconds();
+		int32 Moved = 0;
+		for (int32 i = 0; i < RoundTrips; ++i)
+		{
+			Moved += Source->TransferAllItemsTo_IfServer(Target);
+			Moved += Target->TransferAllItemsTo_IfServer(Source);
+		}
+		const double TransferTime = FPlatformTime::Seconds() - StartTime;
+		Res &= Test->TestEqual(TEXT("Every round trip should move all items"), Moved, RoundTrips * 2 * UE_ARRAY_COUNT(BenchmarkItems));
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < RoundTrips; ++i)
+		{
+			for (const FGameplayTag& ItemId : BenchmarkItems)
+			{
+				Target->AddItem_IfServer(Source, ItemId, 1, true);
+			}
+			for (const FGameplayTag& ItemId : BenchmarkItems)
+			{
+				Source->AddItem_IfServer(Target, ItemId, 1, true);
+			}
+		}
+		const double ExtractReceiveTime = FPlatformTime::Seconds() - StartTime;
+		Res &= Test->TestEqual(TEXT("Source should hold all items after the round trips"), Source->GetAllItems().Num(), static_cast<int32>(UE_ARRAY_COUNT(BenchmarkItems)));
+		Test->AddInfo(FString::Printf(TEXT("Transfer all benchmark (%d types): %.2f us per round trip, extract and receive: %.2f us"),
+			static_cast<int32>(UE_ARRAY_COUNT(BenchmarkItems)), TransferTime * 1e6 / RoundTrips, ExtractReceiveTime * 1e6 / RoundTrips));
+
+		OtherActor->Destroy();
+		return Res;
+	}
+
+	static bool TestMoveBetweenSlots(FRancItemContainerComponentTest* Test)
+	{
+		FItemContainerTestContext Context(10, 100);
+		FDebugTestResult Res = true;
+
+		// Grid bundle to tagged bundle, the generic wrapper writes straight through to both
+		FItemBundle GridBundle(ItemIdBrittleEgg, 3, { NewObject<UItemDurabilityTestInstanceData>(), NewObject<UItemDurabilityTestInstanceData>(), NewObject<UItemDurabilityTestInstanceData>() });
+		const TArray<UItemInstanceData*> Eggs = GridBundle.InstanceData;
+		FTaggedItemBundle TaggedBundle(RightHandSlot, FGameplayTag());
+		FGenericItemBundle Source(&GridBundle);
+		FGenericItemBundle Target(&TaggedBundle);
+
+		FRISMoveResult Result = URISFunctions::MoveBetweenSlots(Source, Target, false, 2, {}, true);
+		Res &= Test->TestEqual(TEXT("Two eggs should be moved"), Result.QuantityMoved, 2);
+		Res &= Test->TestTrue(TEXT("The eggs should be taken from the end"), TaggedBundle.InstanceData == TArray<UItemInstanceData*>{ Eggs[2], Eggs[1] } && Result.InstancesMoved == TaggedBundle.InstanceData);
+		Res &= Test->TestTrue(TEXT("The tagged bundle should take the item id"), TaggedBundle.ItemId == ItemIdBrittleEgg && TaggedBundle.Quantity == 2);
+		Res &= Test->TestTrue(TEXT("Specific instances should be contained"), Target.Contains(1, { Eggs[1] }) && !Target.Contains(1, { Eggs[0] }));
+
+		Result = URISFunctions::MoveBetweenSlots(Source, Target, false, 1, { Eggs[0] }, true);
+		Res &= Test->TestTrue(TEXT("The last egg should be moved and the grid bundle emptied"), Result.QuantityMoved == 1 && !GridBundle.IsValid() && GridBundle.InstanceData.IsEmpty());
+
+		FItemBundle RockBundle(ItemIdRock, 4);
+		FGenericItemBundle RockSource(&RockBundle);
+		Result = URISFunctions::MoveBetweenSlots(Target, RockSource, false, 3, {}, false);
+		Res &= Test->TestTrue(TEXT("Different items should be swapped"), Result.WereItemsSwapped && RockBundle.ItemId == ItemIdBrittleEgg && TaggedBundle.ItemId == ItemIdRock);
+		Res &= Test->TestTrue(TEXT("Instances should follow the swap"), RockBundle.InstanceData.Num() == 3 && TaggedBundle.InstanceData.IsEmpty() && TaggedBundle.Quantity == 4);
+
+		// Splitting and restacking a stack of instanced items between two slots
+		constexpr int32 Iterations = 100000;
+		FGenericItemBundle EggSlot(&RockBundle);
+		FItemBundle OtherBundle;
+		FGenericItemBundle OtherSlot(&OtherBundle);
+		int32 Moved = 0;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			Moved += URISFunctions::MoveBetweenSlots(EggSlot, OtherSlot, false, 1, {}, true).QuantityMoved;
+			Moved += URISFunctions::MoveBetweenSlots(OtherSlot, EggSlot, false, 1, {}, true).QuantityMoved;
+		}
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+		Res &= Test->TestEqual(TEXT("Every move should succeed"), Moved, Iterations * 2);
+		Res &= Test->TestTrue(TEXT("The eggs should end up back in one stack"), RockBundle.Quantity == 3 && RockBundle.InstanceData.Num() == 3 && !OtherBundle.IsValid());
+		Test->AddInfo(FString::Printf(TEXT("MoveBetweenSlots benchmark: %.1f ns per move"), Elapsed * 1e9 / (Iterations * 2)));
+
+		return Res;
+	}
+
+	static bool TestMoveBetweenSlotsAllocations(FRancItemContainerComponentTest* Test)
+	{
+		FItemContainerTestContext Context(10, 100);
+		FDebugTestResult Res = true;
+
+		FTaggedItemBundle LeftHand(LeftHandSlot, ItemIdBrittleEgg, 3, { NewObject<UItemDurabilityTestInstanceData>(), NewObject<UItemDurabilityTestInstanceData>(), NewObject<UItemDurabilityTestInstanceData>() });
+		FTaggedItemBundle RightHand(RightHandSlot, FGameplayTag());
+		FItemBundle Rocks(ItemIdRock, 5);
+		FItemBundle OtherRocks;
+		FGenericItemBundle LeftSlot(&LeftHand);
+		FGenericItemBundle RightSlot(&RightHand);
+		FGenericItemBundle RockSlot(&Rocks);
+		FGenericItemBundle OtherRockSlot(&OtherRocks);
+
+		// Partial instanced moves into a slot with room in its instance array
+		FTaggedItemBundle Eggs(LeftHandSlot, ItemIdBrittleEgg, 3, { NewObject<UItemDurabilityTestInstanceData>(), NewObject<UItemDurabilityTestInstanceData>(), NewObject<UItemDurabilityTestInstanceData>() });
+		FTaggedItemBundle SplitEggs(RightHandSlot, FGameplayTag());
+		SplitEggs.InstanceData.Reserve(3);
+		FGenericItemBundle EggSlot(&Eggs);
+		FGenericItemBundle SplitEggSlot(&SplitEggs);
+		const TArray<UItemInstanceData*> EggToMove = { Eggs.InstanceData[0] };
+
+		bool Swapped = false;
+		TArrayView<UItemInstanceData* const> MovedInstances;
+		int32 Moved = 0;
+		{
+			FScopedAllocationCounter Allocations;
+
+			// Positive control, the counter has to see allocations for the zero counts below to mean anything
+			TArray<int32> ControlArray;
+			ControlArray.Add(1);
+			Res &= Test->TestTrue(TEXT("The allocation counter should count allocations"), Allocations.GetNumAllocations() > 0);
+			ControlArray.Empty();
+			Allocations.Reset();
+
+			Moved += URISFunctions::MoveBetweenSlots(LeftSlot, RightSlot, false, 3, FItemBundle::NoInstances, false, true, Swapped, MovedInstances);
+			Res &= Test->TestEqual(TEXT("Moving a whole instanced stack should not allocate"), Allocations.GetNumAllocations(), 0);
+
+			Moved += URISFunctions::MoveBetweenSlots(RightSlot, RockSlot, false, 3, FItemBundle::NoInstances, false, true, Swapped, MovedInstances);
+			Res &= Test->TestEqual(TEXT("Swapping slots should not allocate"), Allocations.GetNumAllocations(), 0);
+
+			Moved += URISFunctions::MoveBetweenSlots(EggSlot, SplitEggSlot, false, 1, FItemBundle::NoInstances, true, true, Swapped, MovedInstances);
+			Moved += URISFunctions::MoveBetweenSlots(EggSlot, SplitEggSlot, false, 1, EggToMove, true, true, Swapped, MovedInstances);
+			Res &= Test->TestEqual(TEXT("Partial instanced moves should not allocate"), Allocations.GetNumAllocations(), 0);
+
+			Moved += URISFunctions::MoveBetweenSlots(RightSlot, OtherRockSlot, false, 2, FItemBundle::NoInstances, true, true, Swapped, MovedInstances);
+			Moved += URISFunctions::MoveBetweenSlots(OtherRockSlot, RightSlot, false, 2, FItemBundle::NoInstances, true, true, Swapped, MovedInstances);
+			Res &= Test->TestEqual(TEXT("Splitting and restacking should not allocate"), Allocations.GetNumAllocations(), 0);
+		}
+
+		Res &= Test->TestTrue(TEXT("Partial instanced moves should split the eggs"), Eggs.Quantity == 1 && Eggs.InstanceData.Num() == 1 && SplitEggs.ItemId == ItemIdBrittleEgg && SplitEggs.Quantity == 2 && SplitEggs.InstanceData.Num() == 2);
+		Res &= Test->TestTrue(TEXT("The requested instance should be moved"), SplitEggs.InstanceData.Contains(EggToMove[0]) && !Eggs.InstanceData.Contains(EggToMove[0]));
+
+		Res &= Test->TestEqual(TEXT("Every move should succeed"), Moved, 12);
+		Res &= Test->TestTrue(TEXT("The eggs should have been swapped into the rock slot"), Rocks.ItemId == ItemIdBrittleEgg && Rocks.InstanceData.Num() == 3);
+		Res &= Test->TestTrue(TEXT("The rocks should be back in one stack"), RightHand.ItemId == ItemIdRock && RightHand.Quantity == 5 && !OtherRocks.IsValid());
+		Res &= Test->TestTrue(TEXT("The last swap should not report moved instances"), MovedInstances.IsEmpty());
+
+		return Res;
+	}
+
+	static bool TestDropAllItems(FRancItemContainerComponentTest* Test)
+	{
+		FItemContainerTestContext Context(20, 100);
+		auto* Subsystem = Context.TestFixture.GetSubsystem();
+		UWorld* World = Context.TestFixture.GetWorld();
+		UItemContainerComponent* Container = Context.ItemContainerComponent;
+		FDebugTestResult Res = true;
+
+		auto GetWorldItems = [World]()
+		{
+			TArray<AWorldItem*> WorldItems;
+			for (TActorIterator<AWorldItem> It(World); It; ++It)
+				WorldItems.Add(*It);
+			return WorldItems;
+		};
+		for (AWorldItem* WorldItem : GetWorldItems())
+			WorldItem->Destroy();
+
+		// By default every MaxStackSize stack is dropped as its own world item
+		Container->AddItem_IfServer(Subsystem, ItemIdRock, 12, false);
+		Container->AddItem_IfServer(Subsystem, ItemIdSpear, 2, false);
+		Container->AddItem_IfServer(Subsystem, ItemIdBrittleEgg, 3, false);
+		Res &= Test->TestEqual(TEXT("One world item per stack should be dropped"), Container->DropAllItems_IfServer(), 6);
+		Res &= Test->TestTrue(TEXT("Container should be empty"), Container->IsEmpty() && Container->CurrentWeight == 0.f);
+
+		TArray<AWorldItem*> WorldItems = GetWorldItems();
+		Res &= Test->TestEqual(TEXT("Without a frame budget all world items should spawn right away"), WorldItems.Num(), 6);
+		int32 NumRockStacks = 0;
+		int32 NumDroppedRocks = 0;
+		for (const AWorldItem* WorldItem : WorldItems)
+		{
+			if (WorldItem->RepresentedItem.ItemId != ItemIdRock)
+				continue;
+			NumRockStacks++;
+			NumDroppedRocks += WorldItem->RepresentedItem.Quantity;
+			Res &= Test->TestTrue(TEXT("Rock stacks should not exceed MaxStackSize"), WorldItem->RepresentedItem.Quantity <= 5);
+		}
+		Res &= Test->TestTrue(TEXT("Rocks should be dropped as three stacks"), NumRockStacks == 3 && NumDroppedRocks == 12);
+
+		for (int32 i = 0; i < WorldItems.Num(); ++i)
+		{
+			for (int32 j = i + 1; j < WorldItems.Num(); ++j)
+			{
+				const float Distance = FVector::Dist2D(WorldItems[i]->GetActorLocation(), WorldItems[j]->GetActorLocation());
+				Res &= Test->TestTrue(TEXT("Dropped items should not overlap"), Distance >= Container->DropAllItemsSpacing - 1.f);
+			}
+		}
+		for (AWorldItem* WorldItem : WorldItems)
+			WorldItem->Destroy();
+
+		// Merging drops everything of one type as a single world item
+		Container->bDropAllItemsMergesStacks = true;
+		Container->AddItem_IfServer(Subsystem, ItemIdRock, 12, false);
+		Container->AddItem_IfServer(Subsystem, ItemIdSpear, 2, false);
+		Container->AddItem_IfServer(Subsystem, ItemIdBrittleEgg, 3, false);
+		Res &= Test->TestEqual(TEXT("One world item per item type should be dropped when merging"), Container->DropAllItems_IfServer(), 3);
+		Res &= Test->TestTrue(TEXT("Container should be empty after a merged drop"), Container->IsEmpty() && Container->CurrentWeight == 0.f);
+		Container->bDropAllItemsMergesStacks = false;
+
+		WorldItems = GetWorldItems();
+		Res &= Test->TestEqual(TEXT("Merged drops should spawn right away"), WorldItems.Num(), 3);
+		const AWorldItem* const* DroppedRocks = WorldItems.FindByPredicate([](const AWorldItem* WorldItem) { return WorldItem->RepresentedItem.ItemId == ItemIdRock; });
+		Res &= Test->TestTrue(TEXT("Rocks should be dropped as one stack when merging"), DroppedRocks && (*DroppedRocks)->RepresentedItem.Quantity == 12);
+
+		for (int32 i = 0; i < WorldItems.Num(); ++i)
+		{
+			for (int32 j = i + 1; j < WorldItems.Num(); ++j)
+			{
+				const float Distance = FVector::Dist2D(WorldItems[i]->GetActorLocation(), WorldItems[j]->GetActorLocation());
+				Res &= Test->TestTrue(TEXT("Dropped items should not overlap"), Distance >= Container->DropAllItemsSpacing - 1.f);
+			}
+		}
+		for (AWorldItem* WorldItem : WorldItems)
+			WorldItem->Destroy();
+
+		// A tiny budget spreads the spawns over frames while the container empties right away
+		const FGameplayTag DropItems[] = { ItemIdRock, ItemIdSticks, ItemIdSpear, ItemIdHelmet, ItemIdSpecialHelmet, ItemIdChestArmor, ItemIdBrittleEgg, ItemIdBrittleCopperKnife };
+		for (const FGameplayTag& ItemId : DropItems)
+		{
+			Container->AddItem_IfServer(Subsystem, ItemId, 1, false);
+		}
+		Container->DropAllItemsFrameBudgetMs = UE_SMALL_NUMBER;
+		Container->DropAllItems_IfServer();
+		Res &= Test->TestTrue(TEXT("Container should be empty before the drops are spawned"), Container->IsEmpty());
+		Res &= Test->TestTrue(TEXT("Some drops should wait for the next frames"), Container->GetNumPendingWorldDrops() > 0 && GetWorldItems().Num() >= 1);
+
+		for (int32 Frame = 0; Frame < UE_ARRAY_COUNT(DropItems) && Container->GetNumPendingWorldDrops() > 0; ++Frame)
+		{
+			GFrameCounter++;
+			World->GetTimerManager().Tick(0.016f);
+		}
+		Res &= Test->TestEqual(TEXT("All drops should be spawned over the following frames"), GetWorldItems().Num(), static_cast<int32>(UE_ARRAY_COUNT(DropItems)));
+
+		for (AWorldItem* WorldItem : GetWorldItems())
+			WorldItem->Destroy();
+		return Res;
+	}
+
 	    static bool TestRecursiveContainerLifecycle(FRancItemContainerComponentTest* Test)
     {
         // --- Setup ---
@@ -1067,6 +1521,12 @@ bool FRancItemContainerComponentTest::RunTest(const FString& Parameters)
 	Res &= FItemContainerTestScenarios::TestInstanceDataTransferBetweenContainers(this);
 	Res &= FItemContainerTestScenarios::TestInstanceDataDropPickupAndDestruction(this);
     Res &= FItemContainerTestScenarios::TestRecursiveContainerLifecycle(this);
+	Res &= FItemContainerTestScenarios::TestLootTables(this);
+	Res &= FItemContainerTestScenarios::TestJigsawPlacement(this);
+	Res &= FItemContainerTestScenarios::TestTransferBetweenContainers(this);
+	Res &= FItemContainerTestScenarios::TestMoveBetweenSlots(this);
+	Res &= FItemContainerTestScenarios::TestMoveBetweenSlotsAllocations(this);
+	Res &= FItemContainerTestScenarios::TestDropAllItems(this);
 	return Res;
 }
 
@@ -0,0 +1,102 @@
+// Copyright Rancorous Games, 2024
+
+#include "AttackReplaySubsystem.h"
+
+#include "GearManagerComponent.h"
+#include "RecordingSystem/WeaponAttackRecorderDataTypes.h"
+
+void UAttackReplaySubsystem::StartReplay(UGearManagerComponent* GearManager, const UWeaponAttackData* AttackData)
+{
+	if (!IsValid(GearManager) || !IsValid(AttackData) || AttackData->GetNumKeyframes() == 0)
+		return;
+
+	int32 ReplayIndex = ActiveReplays.IndexOfByPredicate([GearManager](const FActiveAttackReplay& Replay) { return Replay.GearManager == GearManager; });
+	if (ReplayIndex == INDEX_NONE)
+		ReplayIndex = ActiveReplays.AddDefaulted();
+
+	FActiveAttackReplay& Replay = ActiveReplays[ReplayIndex];
+	Replay.GearManager = GearManager;
+	Replay.AttackData = AttackData;
+	Replay.NextKeyframe = 0;
+	Replay.ElapsedTime = 0.f;
+	AdvanceReplay(ReplayIndex);
+}
+
+void UAttackReplaySubsystem::StopReplay(const UGearManagerComponent* GearManager)
+{
+	for (FActiveAttackReplay& Replay : ActiveReplays)
+	{
+		if (Replay.GearManager == GearManager)
+		{
+			Replay.GearManager.Reset();
+			Replay.AttackData = nullptr;
+		}
+	}
+}
+
+int32 UAttackReplaySubsystem::GetNumActiveReplays() const
+{
+	int32 NumActive = 0;
+	for (const FActiveAttackReplay& Replay : ActiveReplays)
+	{
+		if (Replay.GearManager.IsValid())
+			++NumActive;
+	}
+	return NumActive;
+}
+
+void UAttackReplaySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Replays started by callbacks during this tick have already processed their first keyframe
+	const int32 NumReplays = ActiveReplays.Num();
+	for (int32 i = 0; i < NumReplays; ++i)
+	{
+		ActiveReplays[i].ElapsedTime += DeltaTime;
+		AdvanceReplay(i);
+	}
+
+	ActiveReplays.RemoveAllSwap([](const FActiveAttackReplay& Replay) { return !Replay.GearManager.IsValid(); });
+}
+
+void UAttackReplaySubsystem::AdvanceReplay(int32 ReplayIndex)
+{
+	// The gear manager callbacks may start or stop replays, so the entry is looked up again after each of them
+	while (true)
+	{
+		FActiveAttackReplay& Replay = ActiveReplays[ReplayIndex];
+		UGearManagerComponent* GearManager = Replay.GearManager.Get();
+		if (!GearManager || !Replay.AttackData)
+			return;
+
+		const UWeaponAttackData& AttackData = *Replay.AttackData;
+		const int32 NumKeyframes = AttackData.GetNumKeyframes();
+		const int32 Keyframe = Replay.NextKeyframe;
+		if (Keyframe >= NumKeyframes || AttackData.GetKeyframeTime(Keyframe) - AttackData.GetKeyframeTime(0) > Replay.ElapsedTime)
+			return;
+
+		++Replay.NextKeyframe;
+		if (Keyframe < NumKeyframes - 1)
+		{
+			GearManager->TraceAttackReplaySegment(AttackData, Keyframe);
+		}
+		else
+		{
+			// The last keyframe only marks the end of the attack
+			Replay.GearManager.Reset();
+			Replay.AttackData = nullptr;
+			GearManager->StopAttackReplay();
+		}
+	}
+}
+
+TStatId UAttackReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAttackReplaySubsystem, STATGROUP_Tickables);
+}
+
+bool UAttackReplaySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
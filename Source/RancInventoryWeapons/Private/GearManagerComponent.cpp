@@ -3,14 +3,23 @@
 
 #include "GearManagerComponent.h"
 
+#include "AttackReplaySubsystem.h"
 #include "LogRancInventorySystem.h"
 #include "WeaponActor.h"
 #include "Engine/EngineTypes.h"
 #include "GameFramework/Character.h"
+#include "GameFramework/PlayerState.h"
+#include "Components/CapsuleComponent.h"
+#include "LagCompensationSubsystem.h"
 #include "Net/UnrealNetwork.h"
 #include "RecordingSystem/WeaponAttackRecorderComponent.h"
 #include "RecordingSystem/WeaponAttackRecorderDataTypes.h"
 
+DECLARE_STATS_GROUP(TEXT("RancInventoryWeapons"), STATGROUP_RancInventoryWeapons, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attack Replay Traces"), STAT_RISAttackReplayTraces, STATGROUP_RancInventoryWeapons);
+DECLARE_CYCLE_STAT(TEXT("Attack Replay Trace Submit"), STAT_RISAttackReplayTraceSubmit, STATGROUP_RancInventoryWeapons);
+DECLARE_CYCLE_STAT(TEXT("Attack Replay Trace Results"), STAT_RISAttackReplayTraceResults, STATGROUP_RancInventoryWeapons);
+
 template <typename T>
 static FString PrintArrayContents(const TArray<T>& Array, bool bReverse = false)
 {
@@ -71,6 +80,8 @@ UGearManagerComponent::UGearManagerComponent()
 	PrimaryComponentTick.bCanEverTick = false;
 	bWantsInitializeComponent = true;
 	SetIsReplicatedByDefault(true);	
+
+	ReplayTraceDelegate.BindUObject(this, &UGearManagerComponent::OnReplayTraceCompleted);
 }
 
 void UGearManagerComponent::InitializeComponent()
@@ -101,6 +112,17 @@ void UGearManagerComponent::BeginPlay()
 	Initialize();
 }
 
+void UGearManagerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Registered targets would otherwise be sampled until the actor is garbage collected
+	if (bUseLagCompensation && GetOwner())
+	{
+		if (ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>())
+			LagCompensation->UnregisterTarget(GetOwner());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
 
 void UGearManagerComponent::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const
 {
@@ -169,6 +191,16 @@ void UGearManagerComponent::Initialize()
 		{
 			AddAndSetSelectedWeapon_IfServer(DefaultUnarmedWeaponData);
 		}
+
+		if (bUseLagCompensation)
+		{
+			ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>();
+			if (LagCompensation && Owner->GetCapsuleComponent())
+			{
+				LagCompensation->ExtendHistory(MaxLagCompensationSeconds);
+				LagCompensation->RegisterTarget(Owner, Owner->GetCapsuleComponent()->GetScaledCapsuleRadius(), Owner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+			}
+		}
 	}
 }
 
@@ -972,6 +1004,13 @@ FAttackAimParams UGearManagerComponent::GetAttackTraceAimParams_Implementation()
 	return FAttackAimParams{AimYaw, AimPitch};
 }
 
+float UGearManagerComponent::GetLagCompensationRewindSeconds_Implementation()
+{
+	const APlayerState* PlayerState = Owner ? Owner->GetPlayerState() : nullptr;
+	const float RoundTripSeconds = PlayerState ? PlayerState->GetPingInMilliseconds() * 0.001f : 0.f;
+	return RoundTripSeconds + LagCompensationInterpolationDelay;
+}
+
 //////////////////////// BEHAVIOR ////////////////////////
 
 
@@ -1043,15 +1082,19 @@ void UGearManagerComponent::UpdateRotation()
 
 void UGearManagerComponent::PlayRecordedAttackSequence(const UWeaponAttackData* AttackData)
 {
-    if (!IsValid(AttackData) || AttackData->AttackSequence.Num() == 0)
+    if (!IsValid(AttackData) || AttackData->GetNumKeyframes() == 0)
     {
         UE_LOG(LogTemp, Warning, TEXT("Invalid attack data or empty attack sequence."));
         return;
     }
 
-    // Initialize replay session
-    ReplayCurrentIndex = 0;
+    // Initialize replay session, a replay of the previous attack that is still running is dropped
+    if (auto* ReplaySubsystem = GetWorld()->GetSubsystem<UAttackReplaySubsystem>())
+    	ReplaySubsystem->StopReplay(this);
     ReplayedAttackData = AttackData;
+	ReplayTraceParams = FCollisionQueryParams(SCENE_QUERY_STAT(RISAttackReplayTrace), false, GetOwner());
+	++ReplayAttackSerial;
+	ReplayHitActors.Reset();
 
 	AttackStartTime = GetWorld()->GetTimeSeconds();
 }
@@ -1069,7 +1112,7 @@ void UGearManagerComponent::SendAttackTraceAimRPC_Client()
 		ReceivedReplayAttackAimParams = GetAttackTraceAimParams();
 		SetAimInformationRPC_Server(ReceivedReplayAttackAimParams, true);
 		// We also want to trace on client
-		ContinueAttackReplay();
+		StartAttackReplay();
 	}
 	else
 	{
@@ -1094,19 +1137,31 @@ void UGearManagerComponent::SetAimInformationRPC_Server_Implementation(FAttackAi
 			return;
 		}
 		
-		ContinueAttackReplay();
+		StartAttackReplay();
 	}
 }
 
-void UGearManagerComponent::ContinueAttackReplay()
+void UGearManagerComponent::StartAttackReplay()
 {
-    if (!IsValid(ReplayedAttackData) || ReplayedAttackData->AttackSequence.Num() == 0)
+    if (!IsValid(ReplayedAttackData) || ReplayedAttackData->GetNumKeyframes() == 0)
     {
         StopAttackReplay();
         return;
     }
 
+	if (auto* ReplaySubsystem = GetWorld()->GetSubsystem<UAttackReplaySubsystem>())
+	{
+		ReplaySubsystem->StartReplay(this, ReplayedAttackData);
+	}
+	else
+	{
+		UE_LOG(LogRancInventorySystem, Warning, TEXT("No attack replay subsystem in this world, attack traces are not replayed."));
+		StopAttackReplay();
+	}
+}
 
+void UGearManagerComponent::TraceAttackReplaySegment(const UWeaponAttackData& AttackData, int32 KeyframeIndex)
+{
 	FTransform PivotOffsetTransform;
 	PivotOffsetTransform.SetRotation(FQuat(Owner->GetActorRotation()));
     ReplayOwnerAttackOrigin.SetLocation(Owner->GetActorLocation() + PivotOffsetTransform.TransformPosition(ReplayAttackPivotLocationOffset));
@@ -1118,53 +1173,179 @@ void UGearManagerComponent::ContinueAttackReplay()
     }
     else
 		ReplayOwnerAttackOrigin.SetRotation(FQuat(Owner->GetActorRotation()));
-	
-    // Stop if we reached the end of the attack sequence
-    if (ReplayCurrentIndex >= ReplayedAttackData->AttackSequence.Num() - 1)
-    {
-        StopAttackReplay();
-        return;
-    }
 
-    // Get current and next timestamps in the sequence
-    const FWeaponAttackTimestamp& CurrentTimestamp = ReplayedAttackData->AttackSequence[ReplayCurrentIndex];
-    const FWeaponAttackTimestamp& NextTimestamp = ReplayedAttackData->AttackSequence[ReplayCurrentIndex + 1];
+    // Get current and next socket positions in the sequence
+    const TConstArrayView<FVector3f> CurrentPositions = AttackData.GetSocketPositions(KeyframeIndex);
+    const TConstArrayView<FVector3f> NextPositions = AttackData.GetSocketPositions(KeyframeIndex + 1);
     
-    // Calculate time delta between timestamps for proper replay timing
-    float TimeDelta = NextTimestamp.Timestamp - CurrentTimestamp.Timestamp;
+    // Only used to keep the debug lines visible until the next segment
+    float TimeDelta = AttackData.GetKeyframeTime(KeyframeIndex + 1) - AttackData.GetKeyframeTime(KeyframeIndex);
 
-    // Perform line traces between the recorded socket positions
-    for (int32 SocketIndex = 0; SocketIndex < CurrentTimestamp.SocketPositions.Num(); ++SocketIndex)
+    // Submit the traces between the recorded socket positions as one async batch, the hits are broadcast next frame
     {
-    	FVector StartPosition = ReplayOwnerAttackOrigin.TransformPosition(CurrentTimestamp.SocketPositions[SocketIndex]);
-    	FVector EndPosition = ReplayOwnerAttackOrigin.TransformPosition(NextTimestamp.SocketPositions[SocketIndex]);
-    	
-        FHitResult HitResult;
-        FCollisionQueryParams QueryParams;
-        QueryParams.AddIgnoredActor(GetOwner());
-
-	    if (bool bHit = GetWorld()->LineTraceSingleByChannel(HitResult, StartPosition, EndPosition, TraceChannel, QueryParams))
-        {
-	        if (AActor* HitActor = HitResult.GetActor())
-            {
-                // Broadcast an event when a hit is detected
-                OnHitDetected.Broadcast(HitActor, HitResult);
-            }
-        }
-
-        #if WITH_EDITOR
-        DrawDebugLine(GetWorld(), StartPosition, EndPosition, FColor::Red, false, TimeDelta, 0, 2.0f);
-        #endif
+	    SCOPE_CYCLE_COUNTER(STAT_RISAttackReplayTraceSubmit);
+	    UWorld* World = GetWorld();
+
+	    // Attacks of remote players are tested against lag compensation targets where the attacker saw them, right away
+	    ULagCompensationSubsystem* LagCompensation = nullptr;
+	    double RewindTime = 0.0;
+	    if (bUseLagCompensation && Owner->HasAuthority() && Owner->IsPlayerControlled() && !Owner->IsLocallyControlled())
+	    {
+	    	LagCompensation = World->GetSubsystem<ULagCompensationSubsystem>();
+	    	RewindTime = World->GetTimeSeconds() - FMath::Clamp(GetLagCompensationRewindSeconds(), 0.f, MaxLagCompensationSeconds);
+	    }
+	    bReplayIsLagCompensated = LagCompensation != nullptr;
+	    TArray<FLagCompensatedHit> RewoundHits;
+	    const int32 NumSockets = AttackData.GetNumSockets();
+	    int32 NumTraces = 0;
+	    if (ReplayTraceShape == EAttackReplayTraceShape::SweptCapsules && NumSockets > 0)
+	    {
+	    	// Each capsule spans two adjacent sockets and is swept from their midpoint in this keyframe to their midpoint in the next
+	    	TArray<FAttackReplayCapsuleSweep, TInlineAllocator<8>> CapsuleSweeps;
+	    	const int32 NumPairs = FMath::Max(NumSockets - 1, 1);
+	    	for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+	    	{
+	    		const int32 OtherIndex = FMath::Min(PairIndex + 1, NumSockets - 1);
+	    		const FVector StartA = ReplayOwnerAttackOrigin.TransformPosition(FVector(CurrentPositions[PairIndex]));
+	    		const FVector StartB = ReplayOwnerAttackOrigin.TransformPosition(FVector(CurrentPositions[OtherIndex]));
+	    		const FVector EndA = ReplayOwnerAttackOrigin.TransformPosition(FVector(NextPositions[PairIndex]));
+	    		const FVector EndB = ReplayOwnerAttackOrigin.TransformPosition(FVector(NextPositions[OtherIndex]));
+
+	    		CapsuleSweeps.Reset();
+	    		BuildReplayCapsuleSweeps(StartA, StartB, EndA, EndB, ReplayTraceRadius, MaxReplayCapsuleSweepAngle, CapsuleSweeps);
+	    		for (const FAttackReplayCapsuleSweep& Sweep : CapsuleSweeps)
+	    		{
+	    			const FCollisionShape Shape = FCollisionShape::MakeCapsule(ReplayTraceRadius, Sweep.HalfHeight);
+	    			World->AsyncSweepByChannel(EAsyncTraceType::Single, Sweep.Start, Sweep.End, Sweep.Rotation, TraceChannel, Shape, ReplayTraceParams,
+	    			                           FCollisionResponseParams::DefaultResponseParam, &ReplayTraceDelegate, ReplayAttackSerial);
+	    			++NumTraces;
+
+	    			if (LagCompensation)
+	    			{
+	    				// The path of the capsule center and the capsule at its end position
+	    				LagCompensation->FindRewoundHits(RewindTime, Sweep.Start, Sweep.End, ReplayTraceRadius, Owner, RewoundHits);
+	    				LagCompensation->FindRewoundHits(RewindTime, Sweep.EndA, Sweep.EndB, ReplayTraceRadius, Owner, RewoundHits);
+	    			}
+
+	    			#if WITH_EDITOR
+	    			DrawDebugCapsule(World, Sweep.End, Sweep.HalfHeight, ReplayTraceRadius, Sweep.Rotation, FColor::Red, false, TimeDelta);
+	    			#endif
+	    		}
+	    	}
+	    }
+	    else
+	    {
+	    	for (int32 SocketIndex = 0; SocketIndex < NumSockets; ++SocketIndex)
+	    	{
+	    		FVector StartPosition = ReplayOwnerAttackOrigin.TransformPosition(FVector(CurrentPositions[SocketIndex]));
+	    		FVector EndPosition = ReplayOwnerAttackOrigin.TransformPosition(FVector(NextPositions[SocketIndex]));
+
+	    		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, StartPosition, EndPosition, TraceChannel, ReplayTraceParams,
+	    		                               FCollisionResponseParams::DefaultResponseParam, &ReplayTraceDelegate, ReplayAttackSerial);
+	    		++NumTraces;
+
+	    		if (LagCompensation)
+	    			LagCompensation->FindRewoundHits(RewindTime, StartPosition, EndPosition, 0.f, Owner, RewoundHits);
+
+	    		#if WITH_EDITOR
+	    		DrawDebugLine(World, StartPosition, EndPosition, FColor::Red, false, TimeDelta, 0, 2.0f);
+	    		#endif
+	    	}
+	    }
+	    INC_DWORD_STAT_BY(STAT_RISAttackReplayTraces, NumTraces);
+
+	    for (const FLagCompensatedHit& RewoundHit : RewoundHits)
+	    {
+	    	FHitResult HitResult(RewoundHit.Actor, nullptr, RewoundHit.ImpactPoint, FVector::ZeroVector);
+	    	HitResult.bBlockingHit = true;
+	    	ReportReplayHit(RewoundHit.Actor, HitResult);
+	    }
     }
+}
+
+void UGearManagerComponent::BuildReplayCapsuleSweeps(const FVector& StartA, const FVector& StartB, const FVector& EndA, const FVector& EndB, float Radius,
+                                                     float MaxAngleDegrees, TArray<FAttackReplayCapsuleSweep, TInlineAllocator<8>>& OutSweeps)
+{
+	// A single sweep keeps one orientation, a blade turning like a fan would only be covered along the average of both
+	const FVector StartAxis = (StartB - StartA).GetSafeNormal();
+	const FVector EndAxis = (EndB - EndA).GetSafeNormal();
+	const float AngleDegrees = StartAxis.IsZero() || EndAxis.IsZero() ? 0.f : FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(FVector::DotProduct(StartAxis, EndAxis), -1.0, 1.0)));
+	const int32 NumSteps = FMath::Max(FMath::CeilToInt(AngleDegrees / FMath::Max(MaxAngleDegrees, 1.f) - UE_KINDA_SMALL_NUMBER), 1);
+
+	// The blade center and length are interpolated linearly and its direction spherically, so every step turns by the same angle
+	const FQuat Turn = FQuat::FindBetweenNormals(StartAxis, EndAxis);
+	const FVector StartCenter = 0.5f * (StartA + StartB);
+	const FVector EndCenter = 0.5f * (EndA + EndB);
+	const float StartLength = FVector::Dist(StartA, StartB);
+	const float EndLength = FVector::Dist(EndA, EndB);
+
+	FVector StepStartA = StartA;
+	FVector StepStartB = StartB;
+	for (int32 Step = 1; Step <= NumSteps; ++Step)
+	{
+		FVector StepEndA = EndA;
+		FVector StepEndB = EndB;
+		if (Step < NumSteps)
+		{
+			const float Alpha = static_cast<float>(Step) / NumSteps;
+			const FVector Center = FMath::Lerp(StartCenter, EndCenter, Alpha);
+			const FVector HalfBlade = FQuat::Slerp(FQuat::Identity, Turn, Alpha).RotateVector(StartAxis) * (0.5f * FMath::Lerp(StartLength, EndLength, Alpha));
+			StepEndA = Center - HalfBlade;
+			StepEndB = Center + HalfBlade;
+		}
+
+		FAttackReplayCapsuleSweep& Sweep = OutSweeps.AddDefaulted_GetRef();
+		const FVector Axis = (StepStartB - StepStartA) + (StepEndB - StepEndA);
+		Sweep.Rotation = Axis.IsNearlyZero() ? FQuat::Identity : FRotationMatrix::MakeFromZ(Axis).ToQuat();
+		Sweep.HalfHeight = 0.5f * FMath::Max(FVector::Dist(StepStartA, StepStartB), FVector::Dist(StepEndA, StepEndB)) + Radius;
+		Sweep.Start = 0.5f * (StepStartA + StepStartB);
+		Sweep.End = 0.5f * (StepEndA + StepEndB);
+		Sweep.EndA = StepEndA;
+		Sweep.EndB = StepEndB;
+
+		StepStartA = StepEndA;
+		StepStartB = StepEndB;
+	}
+}
+
+void UGearManagerComponent::OnReplayTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RISAttackReplayTraceResults);
+	if (TraceDatum.UserData != ReplayAttackSerial)
+		return;
+
+	const ULagCompensationSubsystem* LagCompensation = bReplayIsLagCompensated ? GetWorld()->GetSubsystem<ULagCompensationSubsystem>() : nullptr;
+	for (const FHitResult& HitResult : TraceDatum.OutHits)
+	{
+		if (!HitResult.bBlockingHit)
+			continue;
+
+		AActor* HitActor = HitResult.GetActor();
+		// Lag compensation targets were already tested where the attacker saw them
+		if (HitActor && !(LagCompensation && LagCompensation->IsTargetRegistered(HitActor)))
+		{
+			ReportReplayHit(HitActor, HitResult);
+		}
+	}
+}
+
+void UGearManagerComponent::ReportReplayHit(AActor* HitActor, const FHitResult& HitResult)
+{
+	if (bReportEachActorOncePerAttack)
+	{
+		if (ReplayHitActors.Contains(HitActor))
+			return;
+		ReplayHitActors.Add(HitActor);
+	}
 
-    // Schedule the next trace step
-    ReplayCurrentIndex++;
-    GetWorld()->GetTimerManager().SetTimer(AttackTrace_TimerHandle, this, &UGearManagerComponent::ContinueAttackReplay, TimeDelta, false);
+	// Broadcast an event when a hit is detected
+	OnHitDetected.Broadcast(HitActor, HitResult);
 }
 
 void UGearManagerComponent::StopAttackReplay()
 {
-    GetWorld()->GetTimerManager().ClearTimer(AttackTrace_TimerHandle);
+    if (auto* ReplaySubsystem = GetWorld()->GetSubsystem<UAttackReplaySubsystem>())
+    	ReplaySubsystem->StopReplay(this);
     ReplayedAttackData = nullptr;
 	OnAttackAnimNotifyEndEvent.Broadcast();
 }
\ No newline at end of file
@@ -0,0 +1,239 @@
+// Copyright Rancorous Games, 2024
+
+#include "LagCompensationSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+void ULagCompensationSubsystem::RegisterTarget(AActor* Target, float CapsuleRadius, float CapsuleHalfHeight)
+{
+	if (!IsValid(Target))
+		return;
+
+	int32 Slot;
+	if (const int32* ExistingSlot = TargetSlots.Find(Target))
+	{
+		Slot = *ExistingSlot;
+	}
+	else
+	{
+		Slot = FreeSlots.Num() > 0 ? FreeSlots.Pop(EAllowShrinking::No) : Targets.AddDefaulted();
+		TargetSlots.Add(Target, Slot);
+		Targets[Slot] = FTarget();
+		Targets[Slot].Actor = Target;
+		if (Targets.Num() > SlotStride)
+			SetSlotStride(FMath::Max(Targets.Num(), SlotStride * 2));
+	}
+
+	Targets[Slot].Radius = CapsuleRadius;
+	Targets[Slot].HalfHeight = FMath::Max(CapsuleHalfHeight, CapsuleRadius);
+}
+
+void ULagCompensationSubsystem::UnregisterTarget(const AActor* Target)
+{
+	int32 Slot;
+	if (TargetSlots.RemoveAndCopyValue(Target, Slot))
+	{
+		Targets[Slot] = FTarget();
+		FreeSlots.Add(Slot);
+	}
+}
+
+void ULagCompensationSubsystem::SetSlotStride(int32 NewStride)
+{
+	const int32 Capacity = SampleTimes.Num();
+	TArray<FVector3f> NewLocations;
+	NewLocations.SetNumZeroed(Capacity * NewStride);
+	for (int32 Sample = 0; Sample < Capacity && SlotStride > 0; ++Sample)
+	{
+		FMemory::Memcpy(&NewLocations[Sample * NewStride], &SampleLocations[Sample * SlotStride], SlotStride * sizeof(FVector3f));
+	}
+	SampleLocations = MoveTemp(NewLocations);
+	SlotStride = NewStride;
+}
+
+void ULagCompensationSubsystem::SetSampleCapacity(int32 NewCapacity)
+{
+	TArray<double> NewTimes;
+	NewTimes.SetNumZeroed(NewCapacity);
+	TArray<FVector3f> NewLocations;
+	NewLocations.SetNumZeroed(NewCapacity * SlotStride);
+	for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+	{
+		const int32 OldIndex = GetRingIndex(NumSamples - 1 - Sample);
+		NewTimes[Sample] = SampleTimes[OldIndex];
+		if (SlotStride > 0)
+			FMemory::Memcpy(&NewLocations[Sample * SlotStride], &SampleLocations[OldIndex * SlotStride], SlotStride * sizeof(FVector3f));
+	}
+	SampleTimes = MoveTemp(NewTimes);
+	SampleLocations = MoveTemp(NewLocations);
+	NewestSample = NumSamples - 1;
+}
+
+void ULagCompensationSubsystem::SampleTargets(double Time)
+{
+	// A full ring only overwrites its oldest sample once the next oldest one is at least HistorySeconds old, so the history
+	// spans HistorySeconds at any tick rate. It is first sized for 60 Hz and doubles when the server ticks faster
+	const int32 Capacity = SampleTimes.Num();
+	if (NumSamples == Capacity && Capacity < MaxSamples && (NumSamples < 2 || SampleTimes[GetRingIndex(NumSamples - 2)] > Time - HistorySeconds))
+		SetSampleCapacity(FMath::Min(FMath::Max(Capacity * 2, FMath::CeilToInt32(HistorySeconds * 60.f) + 2), MaxSamples));
+
+	NewestSample = (NewestSample + 1) % SampleTimes.Num();
+	NumSamples = FMath::Min(NumSamples + 1, SampleTimes.Num());
+	SampleTimes[NewestSample] = Time;
+
+	FVector3f* Locations = SampleLocations.GetData() + NewestSample * SlotStride;
+	for (int32 Slot = 0; Slot < Targets.Num(); ++Slot)
+	{
+		FTarget& Target = Targets[Slot];
+		if (Target.Actor.IsExplicitlyNull())
+			continue;
+
+		const AActor* Actor = Target.Actor.Get();
+		if (!Actor)
+		{
+			// Destroyed targets free their slot
+			for (auto It = TargetSlots.CreateIterator(); It; ++It)
+			{
+				if (It.Value() == Slot)
+					It.RemoveCurrent();
+			}
+			Target = FTarget();
+			FreeSlots.Add(Slot);
+			continue;
+		}
+
+		Locations[Slot] = FVector3f(Actor->GetActorLocation());
+		if (Target.FirstSampleTime > Time)
+			Target.FirstSampleTime = Time;
+	}
+}
+
+void ULagCompensationSubsystem::FindSamples(double Time, int32& OutOlderIndex, int32& OutNewerIndex, float& OutAlpha) const
+{
+	// Binary search over the sample ages, age 0 is the newest sample
+	int32 NewerAge = 0;
+	int32 OlderAge = NumSamples - 1;
+	if (Time >= SampleTimes[GetRingIndex(NewerAge)])
+	{
+		OutOlderIndex = OutNewerIndex = GetRingIndex(NewerAge);
+		OutAlpha = 0.f;
+		return;
+	}
+	if (Time <= SampleTimes[GetRingIndex(OlderAge)])
+	{
+		OutOlderIndex = OutNewerIndex = GetRingIndex(OlderAge);
+		OutAlpha = 0.f;
+		return;
+	}
+
+	while (OlderAge - NewerAge > 1)
+	{
+		const int32 MidAge = (NewerAge + OlderAge) / 2;
+		if (SampleTimes[GetRingIndex(MidAge)] > Time)
+			NewerAge = MidAge;
+		else
+			OlderAge = MidAge;
+	}
+
+	OutOlderIndex = GetRingIndex(OlderAge);
+	OutNewerIndex = GetRingIndex(NewerAge);
+	const double OlderTime = SampleTimes[OutOlderIndex];
+	const double NewerTime = SampleTimes[OutNewerIndex];
+	OutAlpha = NewerTime > OlderTime ? static_cast<float>((Time - OlderTime) / (NewerTime - OlderTime)) : 0.f;
+}
+
+FVector ULagCompensationSubsystem::GetSampleLocation(int32 Slot, int32 OlderIndex, int32 NewerIndex, float Alpha) const
+{
+	const FVector3f& Older = SampleLocations[OlderIndex * SlotStride + Slot];
+	const FVector3f& Newer = SampleLocations[NewerIndex * SlotStride + Slot];
+	return FVector(FMath::Lerp(Older, Newer, Alpha));
+}
+
+bool ULagCompensationSubsystem::GetRewoundLocation(const AActor* Target, double Time, FVector& OutLocation) const
+{
+	const int32* Slot = TargetSlots.Find(Target);
+	if (!Slot || NumSamples == 0 || Targets[*Slot].FirstSampleTime > SampleTimes[NewestSample])
+		return false;
+
+	int32 OlderIndex, NewerIndex;
+	float Alpha;
+	FindSamples(FMath::Max(Time, Targets[*Slot].FirstSampleTime), OlderIndex, NewerIndex, Alpha);
+	OutLocation = GetSampleLocation(*Slot, OlderIndex, NewerIndex, Alpha);
+	return true;
+}
+
+void ULagCompensationSubsystem::FindRewoundHits(double Time, const FVector& Start, const FVector& End, float TraceRadius, const AActor* IgnoredActor, TArray<FLagCompensatedHit>& OutHits) const
+{
+	if (NumSamples == 0)
+		return;
+
+	int32 OlderIndex, NewerIndex;
+	float Alpha;
+	FindSamples(Time, OlderIndex, NewerIndex, Alpha);
+
+	const FVector SegmentCenter = 0.5f * (Start + End);
+	const float SegmentHalfLength = 0.5f * FVector::Dist(Start, End);
+	for (int32 Slot = 0; Slot < Targets.Num(); ++Slot)
+	{
+		const FTarget& Target = Targets[Slot];
+		if (Target.FirstSampleTime > SampleTimes[NewestSample])
+			continue; // Free slot or not sampled yet
+
+		FVector Location;
+		if (Time >= Target.FirstSampleTime)
+		{
+			Location = GetSampleLocation(Slot, OlderIndex, NewerIndex, Alpha);
+		}
+		else
+		{
+			// Rewinding past the first sample of a late registered target
+			int32 TargetOlderIndex, TargetNewerIndex;
+			float TargetAlpha;
+			FindSamples(Target.FirstSampleTime, TargetOlderIndex, TargetNewerIndex, TargetAlpha);
+			Location = GetSampleLocation(Slot, TargetOlderIndex, TargetNewerIndex, TargetAlpha);
+		}
+
+		// Bounding sphere rejection before the exact segment to segment distance
+		const float HitDistance = Target.Radius + TraceRadius;
+		if (FVector::DistSquared(Location, SegmentCenter) > FMath::Square(SegmentHalfLength + Target.HalfHeight + TraceRadius))
+			continue;
+
+		const FVector AxisOffset(0.f, 0.f, Target.HalfHeight - Target.Radius);
+		FVector ClosestOnSegment, ClosestOnAxis;
+		FMath::SegmentDistToSegmentSafe(Start, End, Location - AxisOffset, Location + AxisOffset, ClosestOnSegment, ClosestOnAxis);
+		if (FVector::DistSquared(ClosestOnSegment, ClosestOnAxis) > FMath::Square(HitDistance))
+			continue;
+
+		AActor* Actor = Target.Actor.Get();
+		if (!Actor || Actor == IgnoredActor)
+			continue;
+
+		FLagCompensatedHit& Hit = OutHits.AddDefaulted_GetRef();
+		Hit.Actor = Actor;
+		Hit.ImpactPoint = ClosestOnSegment;
+	}
+}
+
+void ULagCompensationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SampleTargets(GetWorld()->GetTimeSeconds());
+}
+
+bool ULagCompensationSubsystem::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return TargetSlots.Num() > 0 && World && World->GetNetMode() != NM_Client;
+}
+
+TStatId ULagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+bool ULagCompensationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,275 @@
+// Copyright Rancorous Games, 2024
+
+#include "ProjectilePoolSubsystem.h"
+
+#include "LogRancInventorySystem.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+
+AActor* UProjectilePoolSubsystem::SpawnProjectile(UWorld* World, TSubclassOf<AActor> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator)
+{
+	if (!World || !ProjectileClass)
+		return nullptr;
+
+	if (UProjectilePoolSubsystem* Pool = World->GetSubsystem<UProjectilePoolSubsystem>())
+		return Pool->AcquireProjectile(ProjectileClass, SpawnTransform, Owner, Instigator);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = Owner;
+	SpawnParams.Instigator = Instigator;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return World->SpawnActor<AActor>(ProjectileClass, SpawnTransform, SpawnParams);
+}
+
+AActor* UProjectilePoolSubsystem::AcquireProjectile(TSubclassOf<AActor> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator)
+{
+	if (!ProjectileClass)
+		return nullptr;
+
+	AActor* Projectile = nullptr;
+	if (FPooledProjectileList* Pool = InactiveProjectiles.Find(ProjectileClass.Get()))
+	{
+		// Pooled projectiles may have been destroyed by other code while inactive
+		while (!Projectile && Pool->Projectiles.Num() > 0)
+		{
+			Projectile = Pool->Projectiles.Pop(EAllowShrinking::No);
+			if (!IsValid(Projectile))
+				Projectile = nullptr;
+		}
+	}
+
+	if (!Projectile)
+	{
+		Projectile = SpawnPooledActor(ProjectileClass, SpawnTransform, Owner, Instigator);
+		if (!Projectile)
+			return nullptr;
+	}
+
+	ActivateProjectile(Projectile, SpawnTransform, Owner, Instigator);
+	return Projectile;
+}
+
+void UProjectilePoolSubsystem::ReturnProjectile(AActor* Projectile)
+{
+	if (!IsValid(Projectile))
+		return;
+
+	if (const int32* ActiveIndex = ActiveIndices.Find(Projectile))
+	{
+		RemoveActiveAt(*ActiveIndex);
+	}
+	else
+	{
+		UE_LOG(LogRancInventorySystem, Verbose, TEXT("UProjectilePoolSubsystem::ReturnProjectile: %s is not an active pooled projectile, destroying it."), *Projectile->GetName());
+		Projectile->Destroy();
+		return;
+	}
+
+	const FPooledProjectileList* Pool = InactiveProjectiles.Find(Projectile->GetClass());
+	if (Pool && Pool->Projectiles.Num() >= MaxPooledPerClass)
+	{
+		Projectile->OnDestroyed.RemoveDynamic(this, &UProjectilePoolSubsystem::OnProjectileDestroyed);
+		Projectile->Destroy();
+		return;
+	}
+
+	// The deactivation hook may acquire projectiles, the pool is looked up again afterwards
+	DeactivateProjectile(Projectile);
+	InactiveProjectiles.FindOrAdd(Projectile->GetClass()).Projectiles.Add(Projectile);
+}
+
+void UProjectilePoolSubsystem::PrewarmPool(TSubclassOf<AActor> ProjectileClass, int32 Count)
+{
+	if (!ProjectileClass)
+		return;
+
+	InactiveProjectiles.FindOrAdd(ProjectileClass.Get()).Projectiles.RemoveAllSwap([](const AActor* Projectile) { return !IsValid(Projectile); });
+
+	const int32 TargetCount = FMath::Min(Count, MaxPooledPerClass);
+	while (InactiveProjectiles.FindChecked(ProjectileClass.Get()).Projectiles.Num() < TargetCount)
+	{
+		AActor* Projectile = SpawnPooledActor(ProjectileClass, FTransform::Identity);
+		if (!Projectile)
+			return;
+
+		DeactivateProjectile(Projectile);
+		InactiveProjectiles.FindChecked(ProjectileClass.Get()).Projectiles.Add(Projectile);
+	}
+}
+
+int32 UProjectilePoolSubsystem::GetNumPooledProjectiles(TSubclassOf<AActor> ProjectileClass) const
+{
+	const FPooledProjectileList* Pool = InactiveProjectiles.Find(ProjectileClass.Get());
+	return Pool ? Pool->Projectiles.Num() : 0;
+}
+
+void UProjectilePoolSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	PoolTime += DeltaTime;
+
+	// Returning swaps the last entry into the returned slot, iterating backwards visits every entry once
+	for (int32 i = ActiveProjectiles.Num() - 1; i >= 0; --i)
+	{
+		if (i >= ActiveProjectiles.Num())
+			continue;
+
+		AActor* Projectile = ActiveProjectiles[i].Projectile;
+		if (!IsValid(Projectile))
+		{
+			RemoveActiveAt(i);
+		}
+		else if (ActiveProjectiles[i].ReturnTime <= PoolTime)
+		{
+			ReturnProjectile(Projectile);
+		}
+	}
+}
+
+AActor* UProjectilePoolSubsystem::SpawnPooledActor(UClass* ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+		return nullptr;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = Owner;
+	SpawnParams.Instigator = Instigator;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AActor* Projectile = World->SpawnActor<AActor>(ProjectileClass, SpawnTransform, SpawnParams);
+	if (!Projectile)
+	{
+		UE_LOG(LogRancInventorySystem, Warning, TEXT("UProjectilePoolSubsystem: Failed to spawn projectile of class %s."), *GetNameSafe(ProjectileClass));
+		return nullptr;
+	}
+	++NumSpawned;
+
+	// The pool returns projectiles at the end of their life span instead of the actor destroying itself
+	Projectile->SetLifeSpan(0.f);
+	Projectile->OnDestroyed.AddUniqueDynamic(this, &UProjectilePoolSubsystem::OnProjectileDestroyed);
+	if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Projectile->GetRootComponent()))
+	{
+		Primitive->OnComponentHit.AddUniqueDynamic(this, &UProjectilePoolSubsystem::OnProjectileHit);
+	}
+	return Projectile;
+}
+
+void UProjectilePoolSubsystem::ActivateProjectile(AActor* Projectile, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator)
+{
+	Projectile->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+	Projectile->SetOwner(Owner);
+	Projectile->SetInstigator(Instigator);
+	Projectile->SetActorHiddenInGame(false);
+	Projectile->SetActorEnableCollision(true);
+	Projectile->SetActorTickEnabled(true);
+
+	if (UProjectileMovementComponent* Movement = Projectile->FindComponentByClass<UProjectileMovementComponent>())
+	{
+		// Stopped projectiles have lost their updated component and velocity, and the previous shot may have changed its
+		// homing or bouncing. Both are taken from the template again before the velocity is rebuilt like InitializeComponent does
+		Movement->SetUpdatedComponent(Projectile->GetRootComponent());
+		Movement->ClearPendingForce(true);
+		if (const UProjectileMovementComponent* DefaultMovement = Cast<UProjectileMovementComponent>(Movement->GetArchetype()))
+		{
+			Movement->Velocity = DefaultMovement->Velocity;
+			Movement->bIsHomingProjectile = DefaultMovement->bIsHomingProjectile;
+			Movement->HomingTargetComponent = DefaultMovement->HomingTargetComponent;
+			Movement->HomingAccelerationMagnitude = DefaultMovement->HomingAccelerationMagnitude;
+			Movement->bShouldBounce = DefaultMovement->bShouldBounce;
+			Movement->Bounciness = DefaultMovement->Bounciness;
+			Movement->Friction = DefaultMovement->Friction;
+			Movement->bSimulationEnabled = DefaultMovement->bSimulationEnabled;
+		}
+
+		if (Movement->InitialSpeed > 0.f)
+			Movement->Velocity = Movement->Velocity.GetSafeNormal() * Movement->InitialSpeed;
+		if (Movement->bInitialVelocityInLocalSpace)
+			Movement->SetVelocityInLocalSpace(Movement->Velocity);
+		if (Movement->bRotationFollowsVelocity && Movement->UpdatedComponent && !Movement->Velocity.IsNearlyZero())
+		{
+			FRotator DesiredRotation = Movement->Velocity.Rotation();
+			if (Movement->bRotationRemainsVertical)
+			{
+				DesiredRotation.Pitch = 0.f;
+				DesiredRotation.Roll = 0.f;
+			}
+			Movement->UpdatedComponent->SetWorldRotation(DesiredRotation);
+		}
+
+		Movement->Activate(true);
+		Movement->UpdateComponentVelocity();
+		if (Movement->UpdatedPrimitive && Movement->UpdatedPrimitive->IsSimulatingPhysics())
+			Movement->UpdatedPrimitive->SetPhysicsLinearVelocity(Movement->Velocity);
+	}
+
+	const AActor* DefaultProjectile = Projectile->GetClass()->GetDefaultObject<AActor>();
+	const float Lifetime = DefaultProjectile->InitialLifeSpan > 0.f ? DefaultProjectile->InitialLifeSpan : DefaultProjectileLifetime;
+
+	ActiveIndices.Add(Projectile, ActiveProjectiles.Num());
+	FActivePooledProjectile& Active = ActiveProjectiles.AddDefaulted_GetRef();
+	Active.Projectile = Projectile;
+	Active.ReturnTime = PoolTime + Lifetime;
+
+	if (Projectile->Implements<UPooledProjectile>())
+	{
+		IPooledProjectile::Execute_OnProjectileActivated(Projectile);
+	}
+}
+
+void UProjectilePoolSubsystem::DeactivateProjectile(AActor* Projectile)
+{
+	if (UProjectileMovementComponent* Movement = Projectile->FindComponentByClass<UProjectileMovementComponent>())
+	{
+		Movement->StopMovementImmediately();
+		Movement->Deactivate();
+	}
+
+	Projectile->SetActorHiddenInGame(true);
+	Projectile->SetActorEnableCollision(false);
+	Projectile->SetActorTickEnabled(false);
+
+	if (Projectile->Implements<UPooledProjectile>())
+	{
+		IPooledProjectile::Execute_OnProjectileDeactivated(Projectile);
+	}
+}
+
+void UProjectilePoolSubsystem::RemoveActiveAt(int32 ActiveIndex)
+{
+	ActiveIndices.Remove(ActiveProjectiles[ActiveIndex].Projectile.Get());
+	ActiveProjectiles.RemoveAtSwap(ActiveIndex, 1, EAllowShrinking::No);
+	if (ActiveProjectiles.IsValidIndex(ActiveIndex))
+	{
+		ActiveIndices.Add(ActiveProjectiles[ActiveIndex].Projectile.Get(), ActiveIndex);
+	}
+}
+
+void UProjectilePoolSubsystem::OnProjectileHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	AActor* Projectile = HitComponent ? HitComponent->GetOwner() : nullptr;
+	const int32* ActiveIndex = ActiveIndices.Find(Projectile);
+	if (!ActiveIndex)
+		return;
+
+	if (Projectile->Implements<UPooledProjectile>() && !IPooledProjectile::Execute_ShouldReturnOnImpact(Projectile, Hit))
+		return;
+
+	// Returned on the next tick, deactivating inside the hit callback would cut the movement update short
+	ActiveProjectiles[*ActiveIndex].ReturnTime = PoolTime;
+}
+
+void UProjectilePoolSubsystem::OnProjectileDestroyed(AActor* Projectile)
+{
+	if (const int32* ActiveIndex = ActiveIndices.Find(Projectile))
+	{
+		RemoveActiveAt(*ActiveIndex);
+	}
+}
+
+TStatId UProjectilePoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectilePoolSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,252 @@
+// Copyright Rancorous Games, 2024
+
+#include "ProjectileSimulationSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "LogRancInventorySystem.h"
+
+UProjectileSimulationSubsystem::UProjectileSimulationSubsystem()
+{
+	ProjectileTraceDelegate.BindUObject(this, &UProjectileSimulationSubsystem::OnProjectileTraceCompleted);
+}
+
+uint32 UProjectileSimulationSubsystem::FireProjectile(const FSimulatedProjectileParams& Params, const FVector& Location, const FVector& Direction, AActor* Owner, AActor* Instigator, FOnSimulatedProjectileHit OnHit)
+{
+	if (!bEnableSimulation)
+	{
+		UE_LOG(LogRancInventorySystem, Warning, TEXT("Simulated projectile fired by %s while the projectile simulation is disabled, set bEnableSimulation to use it"), *GetNameSafe(Owner));
+		return 0;
+	}
+
+	const uint32 ProjectileId = NextProjectileId++;
+	if (NextProjectileId == 0)
+		NextProjectileId = 1;
+
+	IndicesById.Add(ProjectileId, Ids.Num());
+	Ids.Add(ProjectileId);
+	Positions.Add(Location);
+	PreviousPositions.Add(Location);
+	Velocities.Add(Direction.GetSafeNormal() * Params.Speed);
+	GravityZ.Add(GetWorld()->GetGravityZ() * Params.GravityScale);
+	RemainingLifetimes.Add(Params.Lifetime);
+	Radii.Add(Params.Radius);
+	TraceChannels.Add(Params.TraceChannel);
+	RenderGroupIndices.Add(Params.Mesh && GetWorld()->GetNetMode() != NM_DedicatedServer ? FindOrAddRenderGroup(Params.Mesh) : INDEX_NONE);
+	Owners.Add(Owner);
+	Instigators.Add(Instigator);
+	HitDelegates.Add(MoveTemp(OnHit));
+	return ProjectileId;
+}
+
+bool UProjectileSimulationSubsystem::GetProjectileLocation(uint32 ProjectileId, FVector& OutLocation) const
+{
+	const int32* Index = IndicesById.Find(ProjectileId);
+	if (!Index)
+		return false;
+
+	OutLocation = Positions[*Index];
+	return true;
+}
+
+void UProjectileSimulationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	StepProjectiles(DeltaTime);
+	TraceProjectiles();
+
+	// Expired projectiles still traced their last step, their hit delegate is kept until its result arrives
+	for (int32 i = Ids.Num() - 1; i >= 0; --i)
+	{
+		if (RemainingLifetimes[i] <= 0.f)
+		{
+			if (HitDelegates[i].IsBound())
+				ExpiredHitDelegates.Add(Ids[i], MoveTemp(HitDelegates[i]));
+			RemoveProjectileAt(i);
+		}
+	}
+
+	UpdateInstances();
+}
+
+void UProjectileSimulationSubsystem::StepProjectiles(float DeltaTime)
+{
+	// Constant gravity integrated exactly, so the path does not depend on the frame rate
+	const float HalfDeltaTimeSquared = 0.5f * DeltaTime * DeltaTime;
+	ParallelFor(Ids.Num(), [this, DeltaTime, HalfDeltaTimeSquared](int32 i)
+	{
+		PreviousPositions[i] = Positions[i];
+		Positions[i] += Velocities[i] * DeltaTime + FVector(0.f, 0.f, GravityZ[i] * HalfDeltaTimeSquared);
+		Velocities[i].Z += GravityZ[i] * DeltaTime;
+		RemainingLifetimes[i] -= DeltaTime;
+	}, Ids.Num() < MinProjectilesForParallelStep ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
+
+void UProjectileSimulationSubsystem::TraceProjectiles()
+{
+	UWorld* World = GetWorld();
+
+	// One set of params for the whole batch, the ignored actors only change where the shooter differs from the previous projectile.
+	// Async traces copy the params so they can be changed once a trace is queued
+	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(RISSimulatedProjectile), false);
+	const AActor* IgnoredOwner = nullptr;
+	const AActor* IgnoredInstigator = nullptr;
+	for (int32 i = 0; i < Ids.Num(); ++i)
+	{
+		const AActor* Owner = Owners[i].Get();
+		const AActor* Instigator = Instigators[i].Get();
+		if (i == 0 || Owner != IgnoredOwner || Instigator != IgnoredInstigator)
+		{
+			TraceParams.ClearIgnoredActors();
+			TraceParams.AddIgnoredActor(Owner);
+			TraceParams.AddIgnoredActor(Instigator);
+			IgnoredOwner = Owner;
+			IgnoredInstigator = Instigator;
+		}
+
+		if (Radii[i] > 0.f)
+		{
+			World->AsyncSweepByChannel(EAsyncTraceType::Single, PreviousPositions[i], Positions[i], FQuat::Identity, TraceChannels[i],
+				FCollisionShape::MakeSphere(Radii[i]), TraceParams, FCollisionResponseParams::DefaultResponseParam, &ProjectileTraceDelegate, Ids[i]);
+		}
+		else
+		{
+			World->AsyncLineTraceByChannel(EAsyncTraceType::Single, PreviousPositions[i], Positions[i], TraceChannels[i],
+				TraceParams, FCollisionResponseParams::DefaultResponseParam, &ProjectileTraceDelegate, Ids[i]);
+		}
+	}
+}
+
+void UProjectileSimulationSubsystem::UpdateInstances()
+{
+	if (RenderGroups.IsEmpty())
+		return;
+
+	NumRenderedInstances = 0;
+	TArray<TArray<FTransform>, TInlineAllocator<4>> GroupTransforms;
+	GroupTransforms.SetNum(RenderGroups.Num());
+	for (int32 i = 0; i < Ids.Num(); ++i)
+	{
+		if (RenderGroupIndices[i] != INDEX_NONE)
+		{
+			GroupTransforms[RenderGroupIndices[i]].Emplace(FRotationMatrix::MakeFromX(Velocities[i]).ToQuat(), Positions[i]);
+			++NumRenderedInstances;
+		}
+	}
+
+	for (int32 Group = 0; Group < RenderGroups.Num(); ++Group)
+	{
+		UInstancedStaticMeshComponent* Instances = RenderGroups[Group].Instances;
+		TArray<FTransform>& Transforms = GroupTransforms[Group];
+		const int32 NumExisting = Instances ? Instances->GetInstanceCount() : 0;
+		if (!Instances || (Transforms.IsEmpty() && NumExisting == 0))
+			continue;
+
+		// Existing instances are moved in one batch, only the difference in count is removed from or appended to the end
+		const int32 NumKept = FMath::Min(NumExisting, Transforms.Num());
+		if (NumExisting > NumKept)
+		{
+			TArray<int32> RemovedInstances;
+			RemovedInstances.Reserve(NumExisting - NumKept);
+			for (int32 Instance = NumExisting - 1; Instance >= NumKept; --Instance)
+			{
+				RemovedInstances.Add(Instance);
+			}
+			Instances->RemoveInstances(RemovedInstances);
+		}
+
+		TArray<FTransform> AddedTransforms;
+		if (Transforms.Num() > NumKept)
+		{
+			AddedTransforms.Append(Transforms.GetData() + NumKept, Transforms.Num() - NumKept);
+			Transforms.SetNum(NumKept, EAllowShrinking::No);
+		}
+
+		if (NumKept > 0)
+			Instances->BatchUpdateInstancesTransforms(0, Transforms, true, true);
+		if (!AddedTransforms.IsEmpty())
+			Instances->AddInstances(AddedTransforms, false, true);
+	}
+}
+
+void UProjectileSimulationSubsystem::RemoveProjectileAt(int32 Index)
+{
+	IndicesById.Remove(Ids[Index]);
+
+	Ids.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Positions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PreviousPositions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	GravityZ.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	RemainingLifetimes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Radii.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	TraceChannels.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	RenderGroupIndices.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Owners.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Instigators.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	HitDelegates.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	if (Ids.IsValidIndex(Index))
+	{
+		IndicesById.Add(Ids[Index], Index);
+	}
+}
+
+int32 UProjectileSimulationSubsystem::FindOrAddRenderGroup(UStaticMesh* Mesh)
+{
+	const int32 ExistingGroup = RenderGroups.IndexOfByPredicate([Mesh](const FSimulatedProjectileRenderGroup& Group) { return Group.Mesh == Mesh; });
+	if (ExistingGroup != INDEX_NONE)
+		return ExistingGroup;
+
+	if (!RenderActor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		RenderActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	FSimulatedProjectileRenderGroup& Group = RenderGroups.AddDefaulted_GetRef();
+	Group.Mesh = Mesh;
+	if (RenderActor)
+	{
+		Group.Instances = NewObject<UInstancedStaticMeshComponent>(RenderActor);
+		Group.Instances->SetStaticMesh(Mesh);
+		Group.Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Group.Instances->SetCastShadow(false);
+		RenderActor->AddInstanceComponent(Group.Instances);
+		Group.Instances->RegisterComponent();
+	}
+	return RenderGroups.Num() - 1;
+}
+
+void UProjectileSimulationSubsystem::OnProjectileTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const bool bBlockingHit = !TraceDatum.OutHits.IsEmpty() && TraceDatum.OutHits[0].bBlockingHit;
+
+	// The last step of an expired projectile is reported like any other, its delegate is dropped once the result arrived
+	FOnSimulatedProjectileHit OnHit;
+	if (ExpiredHitDelegates.RemoveAndCopyValue(static_cast<uint32>(TraceDatum.UserData), OnHit))
+	{
+		if (bBlockingHit)
+			OnHit.ExecuteIfBound(TraceDatum.OutHits[0]);
+		return;
+	}
+
+	const int32* Index = IndicesById.Find(TraceDatum.UserData);
+	if (!Index || !bBlockingHit)
+		return;
+
+	// Removed before the hit is delivered so the callback can fire new projectiles
+	const FHitResult Hit = TraceDatum.OutHits[0];
+	OnHit = MoveTemp(HitDelegates[*Index]);
+	RemoveProjectileAt(*Index);
+	OnHit.ExecuteIfBound(Hit);
+}
+
+TStatId UProjectileSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSimulationSubsystem, STATGROUP_Tickables);
+}
@@ -7,6 +7,8 @@
 #include "Engine/DamageEvents.h"
 #include "Engine/SkeletalMeshSocket.h"
 #include "Engine/StaticMeshSocket.h"
+#include "ProjectilePoolSubsystem.h"
+#include "ProjectileSimulationSubsystem.h"
 #include "GameFramework/Character.h"
 
 void ARangedWeaponActor::BeginPlay()
@@ -49,6 +51,14 @@ void ARangedWeaponActor::Initialize_Implementation(bool InitializeWeaponData, bo
             return;
         }
 
+        if (HasAuthority() && RangedWeaponData->bSpawnProjectiles && RangedWeaponData->ProjectilePoolPrewarmCount > 0)
+        {
+            if (UProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UProjectilePoolSubsystem>())
+            {
+                ProjectilePool->PrewarmPool(RangedWeaponData->ProjectileClass, RangedWeaponData->ProjectilePoolPrewarmCount);
+            }
+        }
+
         if (RangedWeaponData && !RangedWeaponData->bInfiniteReserve && !ReserveAmmoContainer && WeaponHolder)
         {
             ReserveAmmoContainer = WeaponHolder->FindComponentByClass<UItemContainerComponent>();
@@ -130,13 +140,23 @@ void ARangedWeaponActor::OnAttackPerformed_Implementation()
 
     if (GetLocalRole() == ROLE_Authority)
     {
-        if (RangedWeaponData->bSpawnProjectiles)
+        if (RangedWeaponData->bSimulateProjectiles)
         {
-            FActorSpawnParameters SpawnParams;
-            SpawnParams.Owner = this;
-            SpawnParams.Instigator = WeaponHolder;
-            SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+            FVector Direction = GetActorForwardVector();
+            if (RangedWeaponData->RandomSpreadDegrees > 0)
+            {
+                Direction = FMath::VRandCone(Direction, FMath::DegreesToRadians(RangedWeaponData->RandomSpreadDegrees));
+            }
 
+            if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
+            {
+                ProjectileSimulation->FireProjectile(RangedWeaponData->SimulatedProjectile, FireOrigin, Direction, this, WeaponHolder,
+                    FOnSimulatedProjectileHit::CreateWeakLambda(this, [this](const FHitResult& Hit) { ApplyInstantHit(Hit); }));
+                UE_LOG(LogRancInventorySystem, Verbose, TEXT("Simulated projectile fired by %s"), *GetName());
+            }
+        }
+        else if (RangedWeaponData->bSpawnProjectiles)
+        {
             FVector End = FireOrigin + GetActorForwardVector() * RangedWeaponData->Range;
             FVector Direction = End - FireOrigin;
             Direction.Normalize();
@@ -145,10 +165,8 @@ void ARangedWeaponActor::OnAttackPerformed_Implementation()
             FVector EndPoint = FireOrigin + Direction * RangedWeaponData->Range + Spread * RangedWeaponData->Range * RangedWeaponData->FalloffFactor;
             FRotator SpawnRotation = FRotationMatrix::MakeFromZ(EndPoint - FireOrigin).Rotator();
 
-            if (AActor* Projectile = GetWorld()->SpawnActor<AActor>(RangedWeaponData->ProjectileClass.Get(), FireOrigin, SpawnRotation, SpawnParams))
+            if (UProjectilePoolSubsystem::SpawnProjectile(GetWorld(), RangedWeaponData->ProjectileClass, FTransform(SpawnRotation, FireOrigin), this, WeaponHolder))
             {
-                Projectile->SetOwner(this);
-                Projectile->SetInstigator(WeaponHolder);
                 UE_LOG(LogRancInventorySystem, Verbose, TEXT("Projectile spawned by %s"), *GetName());
             }
 
@@ -13,6 +13,8 @@
 #include "Components/SkeletalMeshComponent.h"
 #include "Animation/AnimInstance.h"
 #include "WeaponActor.h"
+#include "ProjectilePoolSubsystem.h"
+#include "ProjectileSimulationSubsystem.h"
 #include "GearManagerComponent.h"
 
 // Sets default values for this component's properties
@@ -37,6 +39,16 @@ void URangedWeaponFiringComponent::BeginPlay()
 {
 	Super::BeginPlay();
 	Initialize();
+	FireEventSeedStream.GenerateNewSeed();
+
+	if (ProjectilePoolPrewarmCount > 0 && GetOwner()->HasAuthority() && !bUseLineTracesInsteadOfProjectiles)
+	{
+		UProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UProjectilePoolSubsystem>();
+		if (ProjectilePool && FiringData.ProjectileSoftClass.Get())
+		{
+			ProjectilePool->PrewarmPool(FiringData.ProjectileSoftClass.Get(), ProjectilePoolPrewarmCount);
+		}
+	}
 	// ...
 }
 
@@ -220,6 +232,11 @@ void URangedWeaponFiringComponent::FireLineTrace(const FVector StartLocation, co
 
 
 void URangedWeaponFiringComponent::FireLineTraceServer_Implementation(const FVector StartLocation, const FRotator InitialRotation) const
+{
+	FireLineTrace_ServerImpl(StartLocation, InitialRotation, FCollisionQueryParams::DefaultQueryParam);
+}
+
+void URangedWeaponFiringComponent::FireLineTrace_ServerImpl(const FVector& StartLocation, const FRotator& InitialRotation, const FCollisionQueryParams& QueryParams) const
 {
 	FHitResult OutHitResult = FHitResult();
 
@@ -229,7 +246,8 @@ void URangedWeaponFiringComponent::FireLineTraceServer_Implementation(const FVec
 		OutHitResult,
 		StartLocation,
 		EndLocation,
-		ECollisionChannel::ECC_Camera
+		ECollisionChannel::ECC_Camera,
+		QueryParams
 	);
 
 	if (bShowDebugLineTrace)
@@ -246,12 +264,17 @@ void URangedWeaponFiringComponent::FireLineTraceServer_Implementation(const FVec
 		);
 	}
 
-	if (AActor* OutHitActor = OutHitResult.GetActor())
+	ApplyLineTraceHit(OutHitResult);
+}
+
+void URangedWeaponFiringComponent::ApplyLineTraceHit(const FHitResult& HitResult) const
+{
+	if (AActor* OutHitActor = HitResult.GetActor())
 	{
 		FVector HitFromDirection = FVector(0.0f, 0.0f, 0.0f);
 
 		FVector OutHitActorForward = OutHitActor->GetActorForwardVector(); //This calculates the HitDirection
-		FRotator LookRotation = UKismetMathLibrary::FindLookAtRotation(OutHitActorForward, OutHitResult.ImpactPoint);
+		FRotator LookRotation = UKismetMathLibrary::FindLookAtRotation(OutHitActorForward, HitResult.ImpactPoint);
 
 		HitFromDirection = LookRotation.Vector();
 
@@ -260,7 +283,7 @@ void URangedWeaponFiringComponent::FireLineTraceServer_Implementation(const FVec
 			OutHitActor,
 			LineTraceDamage,
 			HitFromDirection,
-			OutHitResult,
+			HitResult,
 			OwnerController,
 			OwnerWeapon,
 			LineTraceDamageTypeClass
@@ -304,32 +327,10 @@ void URangedWeaponFiringComponent::FirePattern()
 	}
 
 
-	FRotator InitialRotation = FRotator::ZeroRotator;
-
-	FVector SpawnLocation = GetComponentLocation();
-
-	bool bFireMiddleShot = false;
-	int32 ProjectilesPerSide;
-
-	if (FiringData.ProjectilesPerShot % 2 != 0) //IF ODD
-	{
-		bFireMiddleShot = true; //Odd number get the middle shot, as FireSingleProjectile()
-	}
-
-	if (bFireMiddleShot)
-	{
-		//ODD case
-		ProjectilesPerSide = (FiringData.ProjectilesPerShot - 1) / 2;
-	}
-	else
-	{
-		//EVEN
-		ProjectilesPerSide = (FiringData.ProjectilesPerShot) / 2;
-	}
 	WorldTimeLastFired = GetWorld()->GetTimeSeconds();
 
-		FireLine(SpawnLocation, InitialRotation, ProjectilesPerSide, bFireMiddleShot);
-	
+	SubmitFireEvent(MakeFireEvent());
+
 	if (!bUnlimitedClip)
 	{
 		if (bOneAmmoPerShot)
@@ -349,6 +350,142 @@ void URangedWeaponFiringComponent::FirePattern()
 	OnWeaponFire.Broadcast();
 }
 
+FFirePatternEvent URangedWeaponFiringComponent::MakeFireEvent() const
+{
+	const FRotator Rotation = GetComponentRotation();
+
+	FFirePatternEvent FireEvent;
+	FireEvent.Origin = GetComponentLocation();
+	FireEvent.Pitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+	FireEvent.Yaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+	FireEvent.Pattern = FiringData.Pattern;
+	FireEvent.Seed = static_cast<uint16>(FireEventSeedStream.RandRange(0, MAX_uint16));
+	return FireEvent;
+}
+
+void URangedWeaponFiringComponent::GenerateFirePattern(const FFirePatternEvent& FireEvent, TArray<FTransform>& OutShots) const
+{
+	const int32 NumShots = FMath::Max(FiringData.ProjectilesPerShot, 0);
+	const FRotator BaseRotation = FireEvent.GetRotation();
+	const FVector RightVector = FRotationMatrix(BaseRotation).GetScaledAxis(EAxis::Y);
+	FRandomStream SpreadStream(FireEvent.Seed);
+
+	OutShots.Reset(NumShots);
+	auto AddShot = [&](int32 SideOffset)
+	{
+		FVector Location = FireEvent.Origin;
+		FRotator Rotation = BaseRotation;
+		if (FireEvent.Pattern == EFirePattern::Spread)
+		{
+			Rotation.Yaw += SideOffset * FiringData.DegreeSpacingForSpreadPattern + SpreadStream.FRandRange(FiringData.MinRandomDegreeSpread, FiringData.MaxRandomDegreeSpread);
+			Rotation.Pitch += SpreadStream.FRandRange(FiringData.MinRandomDegreeSpread, FiringData.MaxRandomDegreeSpread);
+		}
+		else
+		{
+			Location += RightVector * FiringData.BulletSpacingForNonSpreadPattern * SideOffset;
+		}
+		OutShots.Emplace(Rotation, Location);
+	};
+
+	// Pairs from the inside out, then the middle shot of odd counts
+	for (int32 i = 1; i <= NumShots / 2; i++)
+	{
+		AddShot(i);
+		AddShot(-i);
+	}
+	if (NumShots % 2 != 0)
+	{
+		AddShot(0);
+	}
+}
+
+void URangedWeaponFiringComponent::SubmitFireEvent(const FFirePatternEvent& FireEvent)
+{
+	if (OwnerChar && OwnerChar->HasAuthority())
+	{
+		ExecuteFireEvent_ServerImpl(FireEvent);
+		FireEventMulticast(FireEvent);
+	}
+	else if (OwnerChar && OwnerChar->GetLocalRole() == ROLE_AutonomousProxy) //is controlled client,
+	{
+		FFireRequest Request;
+		Request.Origin = FireEvent.Origin;
+		Request.Pitch = FireEvent.Pitch;
+		Request.Yaw = FireEvent.Yaw;
+		FireEventServer(Request);
+	}
+}
+
+void URangedWeaponFiringComponent::FireEventServer_Implementation(const FFireRequest& Request)
+{
+	FFirePatternEvent ValidatedEvent;
+	if (ValidateFireEvent_ServerImpl(Request, ValidatedEvent))
+	{
+		ExecuteFireEvent_ServerImpl(ValidatedEvent);
+		FireEventMulticast(ValidatedEvent);
+	}
+}
+
+void URangedWeaponFiringComponent::FireEventMulticast_Implementation(const FFirePatternEvent& FireEvent)
+{
+	// The server already ran the event
+	if (GetOwner() && !GetOwner()->HasAuthority())
+	{
+		OnFireEventConfirmed.Broadcast(FireEvent);
+	}
+}
+
+bool URangedWeaponFiringComponent::ValidateFireEvent_ServerImpl(const FFireRequest& Request, FFirePatternEvent& OutFireEvent)
+{
+	// Every event is a whole volley, so the cooldown is enforced with the server's clock
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	if (WorldTimeLastFired >= 0.0f && Cooldown > 0.0f && CurrentTime - WorldTimeLastFired < Cooldown - FireEventCooldownTolerance)
+	{
+		if (bShowDebugWarnings)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: Rejected a fire event that arrived during the cooldown"), *GetName());
+		}
+		return false;
+	}
+	WorldTimeLastFired = CurrentTime;
+
+	OutFireEvent.Origin = Request.Origin;
+	if (FVector::DistSquared(OutFireEvent.Origin, GetComponentLocation()) > FMath::Square(MaxFireOriginError))
+	{
+		OutFireEvent.Origin = GetComponentLocation();
+	}
+	OutFireEvent.Pitch = Request.Pitch;
+	OutFireEvent.Yaw = Request.Yaw;
+
+	// Clients can't send a pattern or seed, so they can't remove the spread or pick the seed of the tightest cone
+	OutFireEvent.Pattern = FiringData.Pattern;
+	OutFireEvent.Seed = static_cast<uint16>(FireEventSeedStream.RandRange(0, MAX_uint16));
+	return true;
+}
+
+void URangedWeaponFiringComponent::ExecuteFireEvent_ServerImpl(const FFirePatternEvent& FireEvent) const
+{
+	TArray<FTransform> Shots;
+	GenerateFirePattern(FireEvent, Shots);
+
+	if (bUseLineTracesInsteadOfProjectiles)
+	{
+		// One set of query params for every trace of the pattern
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(RISFirePattern), false, OwnerWeapon);
+		QueryParams.AddIgnoredActor(OwnerChar);
+		for (const FTransform& Shot : Shots)
+		{
+			FireLineTrace_ServerImpl(Shot.GetLocation(), Shot.Rotator(), QueryParams);
+		}
+	}
+	else
+	{
+		for (const FTransform& Shot : Shots)
+		{
+			FireSingleProjectile_ServerImpl(Shot.GetLocation(), Shot.Rotator());
+		}
+	}
+}
 
 void URangedWeaponFiringComponent::FireSingleProjectile(const FVector SpawnLocation, const FRotator SpawnRotation) const
 {
@@ -364,27 +501,27 @@ void URangedWeaponFiringComponent::FireSingleProjectile(const FVector SpawnLocat
 
 void URangedWeaponFiringComponent::FireSingleProjectileServer_Implementation(const FVector SpawnLocation, const FRotator SpawnRotation) const
 {
-	TSubclassOf<AActor> ProjectileClass = FiringData.ProjectileSoftClass.Get();
+	FireSingleProjectile_ServerImpl(SpawnLocation, SpawnRotation);
+}
 
-	if (ProjectileClass != NULL)
+void URangedWeaponFiringComponent::FireSingleProjectile_ServerImpl(const FVector& SpawnLocation, const FRotator& SpawnRotation) const
+{
+	if (bUseSimulatedProjectiles)
 	{
-		UWorld* const World = GetWorld();
-
-		if (World != NULL)
+		if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
 		{
-			//Set Spawn Collision Handling Override
-			FActorSpawnParameters ActorSpawnParams;
-
-			if (OwnerController)
-			{
-				ActorSpawnParams.Instigator = OwnerController->GetPawn();
-			}
+			ProjectileSimulation->FireProjectile(SimulatedProjectile, SpawnLocation, SpawnRotation.Vector(), OwnerWeapon, OwnerChar,
+				FOnSimulatedProjectileHit::CreateWeakLambda(this, [this](const FHitResult& Hit) { ApplyLineTraceHit(Hit); }));
+		}
+		return;
+	}
 
-			ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
+	TSubclassOf<AActor> ProjectileClass = FiringData.ProjectileSoftClass.Get();
 
-			/*AActor* Projectile = */
-			World->SpawnActor<AActor>(ProjectileClass, SpawnLocation, SpawnRotation, ActorSpawnParams);
-		}
+	if (ProjectileClass != NULL)
+	{
+		APawn* Instigator = OwnerController ? OwnerController->GetPawn() : nullptr;
+		UProjectilePoolSubsystem::SpawnProjectile(GetWorld(), ProjectileClass, FTransform(SpawnRotation, SpawnLocation), nullptr, Instigator);
 	}
 	else
 	{
@@ -0,0 +1,416 @@
+// Copyright Rancorous Games, 2024
+
+#include "RecordingSystem/WeaponAttackBatchRecordCommandlet.h"
+#include "RecordingSystem/StartStopRecordNotifies.h"
+#include "RecordingSystem/WeaponAttackRecorderComponent.h"
+#include "RecordingSystem/WeaponAttackRecorderSettings.h"
+#include "WeaponDefinition.h"
+#include "LogRancInventorySystem.h"
+#include "Animation/AnimMontage.h"
+#include "Animation/AnimSequence.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/SkeletalMeshSocket.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshSocket.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "UObject/SavePackage.h"
+
+UWeaponAttackBatchRecordCommandlet::UWeaponAttackBatchRecordCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Records the attack traces of all weapon attack montages offline");
+	HelpUsage = TEXT("-run=WeaponAttackBatchRecord [-Settings=/Game/Path/Settings] [-Overwrite] [-UpdateWeapons]");
+}
+
+#if WITH_EDITOR
+
+namespace RISBatchRecording
+{
+	// Root bone transform the mesh is posed with while the root is locked, the rest of the root track moves the actor instead
+	FTransform GetLockedRootTransform(const UAnimSequence& Sequence, const FReferenceSkeleton& RefSkeleton)
+	{
+		switch (Sequence.RootMotionRootLock)
+		{
+		case ERootMotionRootLock::AnimFirstFrame:
+		{
+			FTransform FirstFrameTransform;
+			Sequence.GetBoneTransform(FirstFrameTransform, FSkeletonPoseBoneIndex(0), FAnimExtractContext(0.0), false);
+			return FirstFrameTransform;
+		}
+		case ERootMotionRootLock::Zero:
+			return FTransform::Identity;
+		default:
+			return RefSkeleton.GetRefBonePose()[0];
+		}
+	}
+
+	// Component space transform of a skeleton bone at a montage position, evaluated from the first slot track.
+	// Root motion is stripped like the mesh pose at runtime, so the samples stay relative to the moving character
+	bool EvaluateBoneComponentSpace(const UAnimMontage& Montage, const FReferenceSkeleton& RefSkeleton, int32 BoneIndex, float MontageTime, FTransform& OutTransform)
+	{
+		if (Montage.SlotAnimTracks.IsEmpty()) return false;
+
+		const FAnimTrack& Track = Montage.SlotAnimTracks[0].AnimTrack;
+		const FAnimSegment* Segment = Track.GetSegmentAtTime(MontageTime);
+		if (!Segment && !Track.AnimSegments.IsEmpty())
+		{
+			// Past the end of the track, hold the last pose
+			Segment = &Track.AnimSegments.Last();
+			MontageTime = FMath::Min(MontageTime, Segment->GetEndPos());
+		}
+		const UAnimSequence* Sequence = Segment ? Cast<UAnimSequence>(Segment->GetAnimReference()) : nullptr;
+		if (!Sequence) return false;
+
+		const FAnimExtractContext ExtractContext(static_cast<double>(Segment->ConvertTrackPosToAnimPos(MontageTime)));
+
+		OutTransform = FTransform::Identity;
+		for (int32 Bone = BoneIndex; Bone != INDEX_NONE; Bone = RefSkeleton.GetParentIndex(Bone))
+		{
+			FTransform LocalTransform;
+			if (Bone == 0 && (Sequence->bEnableRootMotion || Sequence->bForceRootLock))
+				LocalTransform = GetLockedRootTransform(*Sequence, RefSkeleton);
+			else
+				Sequence->GetBoneTransform(LocalTransform, FSkeletonPoseBoneIndex(Bone), ExtractContext, false);
+			OutTransform = OutTransform * LocalTransform;
+		}
+		return true;
+	}
+
+	bool SavePackages(const TArray<UPackage*>& Packages)
+	{
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.Error = GError;
+		SaveArgs.bWarnOfLongFilename = true;
+		SaveArgs.SaveFlags = SAVE_NoError;
+
+		bool bAllSaved = true;
+		for (UPackage* Package : Packages)
+		{
+			const FString PackageFileName = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+			if (!UPackage::SavePackage(Package, nullptr, *PackageFileName, SaveArgs))
+			{
+				UE_LOG(LogRancInventorySystem, Error, TEXT("WeaponAttackBatchRecord: Failed to save %s"), *PackageFileName);
+				bAllSaved = false;
+			}
+		}
+		return bAllSaved;
+	}
+}
+
+void UWeaponAttackBatchRecordCommandlet::SampleAttack(FWeaponAttackSampleJob& Job)
+{
+	const UAnimMontage* Montage = Job.Montage;
+	const USkeleton* Skeleton = Montage ? Montage->GetSkeleton() : nullptr;
+	if (!Skeleton || !Job.CharacterMesh)
+	{
+		Job.Error = TEXT("Montage has no skeleton");
+		return;
+	}
+
+	// The attach socket may be a mesh or skeleton socket, otherwise it is treated as a bone
+	FName AttachBone = Job.AttachSocket;
+	FTransform SocketLocalTransform = FTransform::Identity;
+	if (const USkeletalMeshSocket* Socket = Job.CharacterMesh->FindSocket(Job.AttachSocket))
+	{
+		AttachBone = Socket->BoneName;
+		SocketLocalTransform = Socket->GetSocketLocalTransform();
+	}
+
+	const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+	const int32 BoneIndex = RefSkeleton.FindBoneIndex(AttachBone);
+	if (BoneIndex == INDEX_NONE)
+	{
+		Job.Error = FString::Printf(TEXT("Skeleton has no bone or socket named %s"), *Job.AttachSocket.ToString());
+		return;
+	}
+
+	// Record between the attack trace notifies like a PIE recording, or the whole montage without them
+	float StartTime = 0.f;
+	float EndTime = Montage->GetPlayLength();
+	for (const FAnimNotifyEvent& NotifyEvent : Montage->Notifies)
+	{
+		if (Cast<UStartAttackTraceNotify>(NotifyEvent.Notify))
+			StartTime = NotifyEvent.GetTriggerTime();
+		else if (Cast<UStopAttackTraceNotify>(NotifyEvent.Notify))
+			EndTime = NotifyEvent.GetTriggerTime();
+	}
+	if (EndTime <= StartTime)
+	{
+		Job.Error = TEXT("Stop attack trace notify is before the start notify");
+		return;
+	}
+
+	// Timestamps are in playback seconds so they line up with the montage at its play rate
+	const float PlayRate = FMath::Max(Job.PlayRate, UE_KINDA_SMALL_NUMBER);
+	const int32 NumSamples = FMath::Max(2, FMath::CeilToInt((EndTime - StartTime) / PlayRate * Job.SampleRate) + 1);
+	Job.FirstTraceDelay = StartTime / PlayRate;
+	Job.Sequence.Reset(NumSamples);
+
+	for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+	{
+		const float MontageTime = FMath::Lerp(StartTime, EndTime, SampleIndex / static_cast<float>(NumSamples - 1));
+
+		FTransform BoneTransform;
+		if (!RISBatchRecording::EvaluateBoneComponentSpace(*Montage, RefSkeleton, BoneIndex, MontageTime, BoneTransform))
+		{
+			Job.Error = TEXT("Montage has no animation sequence to evaluate");
+			Job.Sequence.Reset();
+			return;
+		}
+		const FTransform AttachTransform = SocketLocalTransform * BoneTransform * Job.MeshRelativeTransform;
+
+		FWeaponAttackTimestamp& Timestamp = Job.Sequence.AddDefaulted_GetRef();
+		Timestamp.Timestamp = (MontageTime - StartTime) / PlayRate;
+		Timestamp.OriginalIndex = SampleIndex;
+		Timestamp.SocketPositions.Reserve(Job.WeaponSocketLocations.Num());
+		for (const FVector& SocketLocation : Job.WeaponSocketLocations)
+		{
+			Timestamp.SocketPositions.Add(AttachTransform.TransformPosition(SocketLocation) - Job.PivotLocationOffset);
+		}
+	}
+
+	const TArray<int32> Keyframes = UWeaponAttackRecorderComponent::ReduceToKeyframes(Job.Sequence, Job.MaxDeviation);
+	TArray<FWeaponAttackTimestamp> Reduced;
+	Reduced.Reserve(Keyframes.Num());
+	for (const int32 Keyframe : Keyframes)
+	{
+		Reduced.Add(MoveTemp(Job.Sequence[Keyframe]));
+	}
+	Job.Sequence = MoveTemp(Reduced);
+}
+
+#endif
+
+int32 UWeaponAttackBatchRecordCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamValues;
+	ParseCommandLine(*Params, Tokens, Switches, ParamValues);
+	const bool bUpdateWeapons = Switches.Contains(TEXT("UpdateWeapons"));
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	UWeaponAttackRecorderSettings* Settings = nullptr;
+	if (const FString* SettingsPath = ParamValues.Find(TEXT("Settings")))
+	{
+		Settings = LoadObject<UWeaponAttackRecorderSettings>(nullptr, **SettingsPath);
+	}
+	else
+	{
+		TArray<FAssetData> SettingsAssets;
+		AssetRegistry.GetAssetsByClass(UWeaponAttackRecorderSettings::StaticClass()->GetClassPathName(), SettingsAssets);
+		if (SettingsAssets.Num() > 1)
+		{
+			UE_LOG(LogRancInventorySystem, Warning, TEXT("WeaponAttackBatchRecord: Found %d recorder settings, using %s. Pass -Settings= to pick one."), SettingsAssets.Num(), *SettingsAssets[0].GetObjectPathString());
+		}
+		Settings = SettingsAssets.IsEmpty() ? nullptr : Cast<UWeaponAttackRecorderSettings>(SettingsAssets[0].GetAsset());
+	}
+
+	USkeletalMesh* CharacterMesh = Settings ? Settings->BatchCharacterMesh.LoadSynchronous() : nullptr;
+	if (!CharacterMesh || Settings->AssetSavePath.Path.IsEmpty())
+	{
+		UE_LOG(LogRancInventorySystem, Error, TEXT("WeaponAttackBatchRecord: Recorder settings with a batch character mesh and an asset save path are required."));
+		return 1;
+	}
+	const bool bOverwrite = Settings->bOverwriteExisting || Switches.Contains(TEXT("Overwrite"));
+
+	// Gather one job per attack montage, on the game thread since it loads assets
+	struct FJobSource
+	{
+		UItemStaticData* Item = nullptr;
+		int32 MontageIndex = 0;
+	};
+	TArray<FWeaponAttackSampleJob> Jobs;
+	TArray<TArray<FJobSource>> JobSources;
+	TMap<const UAnimMontage*, int32> JobsByMontage;
+	// Montages whose recording already exists and is not overwritten, -UpdateWeapons still links the existing asset
+	TMap<const UAnimMontage*, TArray<FJobSource>> SkippedSources;
+
+	TArray<FAssetData> ItemAssets;
+	AssetRegistry.GetAssetsByClass(UItemStaticData::StaticClass()->GetClassPathName(), ItemAssets, true);
+	for (const FAssetData& ItemAsset : ItemAssets)
+	{
+		UItemStaticData* Item = Cast<UItemStaticData>(ItemAsset.GetAsset());
+		const UWeaponDefinition* WeaponDefinition = Item ? Item->GetItemDefinition<UWeaponDefinition>() : nullptr;
+		if (!WeaponDefinition || WeaponDefinition->AttackMontages.IsEmpty() || !Item->ItemWorldMesh) continue;
+
+		// Weapon socket locations relative to the attach socket, as AWeaponActor::GetAttachTransform_Impl attaches the weapon
+		FTransform WeaponAttachTransform(FRotator::ZeroRotator, FVector::ZeroVector, Item->ItemWorldScale);
+		if (const UStaticMeshSocket* AttachSocket = Item->ItemWorldMesh->FindSocket(Settings->BatchAttachSocket))
+		{
+			WeaponAttachTransform = FTransform(AttachSocket->RelativeRotation, AttachSocket->RelativeLocation, Item->ItemWorldScale);
+		}
+
+		TArray<FVector> WeaponSocketLocations;
+		for (const UStaticMeshSocket* Socket : Item->ItemWorldMesh->Sockets)
+		{
+			if (Socket && Socket->SocketName.ToString().StartsWith(Settings->SocketPrefix))
+			{
+				WeaponSocketLocations.Add(WeaponAttachTransform.TransformPosition(Socket->RelativeLocation));
+			}
+		}
+		if (WeaponSocketLocations.IsEmpty())
+		{
+			UE_LOG(LogRancInventorySystem, Warning, TEXT("WeaponAttackBatchRecord: %s has no sockets starting with %s, skipped."), *Item->GetName(), *Settings->SocketPrefix);
+			continue;
+		}
+
+		for (int32 MontageIndex = 0; MontageIndex < WeaponDefinition->AttackMontages.Num(); ++MontageIndex)
+		{
+			const FAttackMontageData& MontageData = WeaponDefinition->AttackMontages[MontageIndex];
+			if (!MontageData.IsValid()) continue;
+
+			// Recordings are named after the montage, weapons sharing a montage share its recording
+			if (const int32* ExistingJob = JobsByMontage.Find(MontageData.Montage))
+			{
+				if (Jobs[*ExistingJob].WeaponSocketLocations != WeaponSocketLocations)
+				{
+					UE_LOG(LogRancInventorySystem, Warning, TEXT("WeaponAttackBatchRecord: %s is used by weapons with different sockets, %s reuses the first recording."), *MontageData.Montage->GetName(), *Item->GetName());
+				}
+				JobSources[*ExistingJob].Add({Item, MontageIndex});
+				continue;
+			}
+			if (TArray<FJobSource>* Skipped = SkippedSources.Find(MontageData.Montage))
+			{
+				Skipped->Add({Item, MontageIndex});
+				continue;
+			}
+
+			const FString PackageName = FString::Printf(TEXT("/Game/%s/%s_AttackData"), *Settings->AssetSavePath.Path, *MontageData.Montage->GetName());
+			if (!bOverwrite && FPackageName::DoesPackageExist(PackageName))
+			{
+				UE_LOG(LogRancInventorySystem, Display, TEXT("WeaponAttackBatchRecord: %s already exists, skipped."), *PackageName);
+				SkippedSources.Add(MontageData.Montage, {{Item, MontageIndex}});
+				continue;
+			}
+
+			JobsByMontage.Add(MontageData.Montage, Jobs.Num());
+			JobSources.Add({{Item, MontageIndex}});
+
+			FWeaponAttackSampleJob& Job = Jobs.AddDefaulted_GetRef();
+			Job.Montage = MontageData.Montage;
+			Job.PlayRate = MontageData.PlayRate;
+			Job.CharacterMesh = CharacterMesh;
+			Job.AttachSocket = Settings->BatchAttachSocket;
+			Job.MeshRelativeTransform = Settings->BatchMeshRelativeTransform;
+			Job.PivotLocationOffset = Settings->BatchPivotLocationOffset;
+			Job.WeaponSocketLocations = WeaponSocketLocations;
+			Job.SampleRate = Settings->BatchSampleRate;
+			Job.MaxDeviation = Settings->MaxDeviation;
+		}
+	}
+
+	// Compression has to finish on the game thread before the sequences can be evaluated from workers
+	for (const FWeaponAttackSampleJob& Job : Jobs)
+	{
+		for (const FSlotAnimationTrack& SlotTrack : Job.Montage->SlotAnimTracks)
+		{
+			for (const FAnimSegment& Segment : SlotTrack.AnimTrack.AnimSegments)
+			{
+				if (UAnimSequence* Sequence = Cast<UAnimSequence>(Segment.GetAnimReference()))
+				{
+					Sequence->CacheDerivedDataForCurrentPlatform();
+				}
+			}
+		}
+	}
+
+	const double SampleStartSeconds = FPlatformTime::Seconds();
+	ParallelFor(Jobs.Num(), [&Jobs](int32 JobIndex)
+	{
+		SampleAttack(Jobs[JobIndex]);
+	});
+	const double SampleSeconds = FPlatformTime::Seconds() - SampleStartSeconds;
+
+	TArray<UPackage*> PackagesToSave;
+	auto LinkRecording = [&PackagesToSave](const TArray<FJobSource>& Sources, UWeaponAttackData* AttackData)
+	{
+		for (const FJobSource& Source : Sources)
+		{
+			UWeaponDefinition* WeaponDefinition = Source.Item->GetItemDefinition<UWeaponDefinition>();
+			TSoftObjectPtr<UWeaponAttackData>& RecordedTraceSequence = WeaponDefinition->AttackMontages[Source.MontageIndex].RecordedTraceSequence;
+			if (RecordedTraceSequence.ToSoftObjectPath() == FSoftObjectPath(AttackData)) continue;
+
+			RecordedTraceSequence = AttackData;
+			Source.Item->MarkPackageDirty();
+			PackagesToSave.AddUnique(Source.Item->GetPackage());
+		}
+	};
+
+	int32 NumFailed = 0;
+	for (int32 JobIndex = 0; JobIndex < Jobs.Num(); ++JobIndex)
+	{
+		FWeaponAttackSampleJob& Job = Jobs[JobIndex];
+		if (!Job.Error.IsEmpty())
+		{
+			UE_LOG(LogRancInventorySystem, Error, TEXT("WeaponAttackBatchRecord: %s failed: %s"), *Job.Montage->GetName(), *Job.Error);
+			++NumFailed;
+			continue;
+		}
+
+		const FString AssetName = Job.Montage->GetName() + TEXT("_AttackData");
+		UPackage* Package = CreatePackage(*FString::Printf(TEXT("/Game/%s/%s"), *Settings->AssetSavePath.Path, *AssetName));
+		Package->FullyLoad();
+
+		UWeaponAttackData* AttackData = FindObject<UWeaponAttackData>(Package, *AssetName);
+		const bool bCreated = AttackData == nullptr;
+		if (bCreated)
+		{
+			AttackData = NewObject<UWeaponAttackData>(Package, *AssetName, RF_Public | RF_Standalone);
+		}
+		AttackData->FirstTraceDelay = Job.FirstTraceDelay;
+		AttackData->AttackSequence = MoveTemp(Job.Sequence);
+		AttackData->PackAttackSequence();
+		Package->MarkPackageDirty();
+		if (bCreated)
+		{
+			FAssetRegistryModule::AssetCreated(AttackData);
+		}
+		PackagesToSave.Add(Package);
+
+		if (bUpdateWeapons)
+		{
+			LinkRecording(JobSources[JobIndex], AttackData);
+		}
+
+		UE_LOG(LogRancInventorySystem, Display, TEXT("WeaponAttackBatchRecord: %s, %d keyframes of %d sockets, %lld bytes packed."),
+			*AssetName, AttackData->GetNumKeyframes(), AttackData->GetNumSockets(), AttackData->GetPackedSize());
+	}
+
+	if (bUpdateWeapons)
+	{
+		for (const TPair<const UAnimMontage*, TArray<FJobSource>>& Skipped : SkippedSources)
+		{
+			const FString AssetName = Skipped.Key->GetName() + TEXT("_AttackData");
+			const FString ObjectPath = FString::Printf(TEXT("/Game/%s/%s.%s"), *Settings->AssetSavePath.Path, *AssetName, *AssetName);
+			if (UWeaponAttackData* AttackData = LoadObject<UWeaponAttackData>(nullptr, *ObjectPath))
+			{
+				LinkRecording(Skipped.Value, AttackData);
+			}
+			else
+			{
+				UE_LOG(LogRancInventorySystem, Warning, TEXT("WeaponAttackBatchRecord: %s exists but holds no attack data, its weapons are not linked."), *ObjectPath);
+			}
+		}
+	}
+
+	const bool bAllSaved = RISBatchRecording::SavePackages(PackagesToSave);
+
+	UE_LOG(LogRancInventorySystem, Display, TEXT("WeaponAttackBatchRecord: Recorded %d of %d attacks in %.2fs (%.2fs sampling), saved %d packages."),
+		Jobs.Num() - NumFailed, Jobs.Num(), FPlatformTime::Seconds() - StartSeconds, SampleSeconds, PackagesToSave.Num());
+	return NumFailed == 0 && bAllSaved ? 0 : 1;
+#else
+	return 1;
+#endif
+}
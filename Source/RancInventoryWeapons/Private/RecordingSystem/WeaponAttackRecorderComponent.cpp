@@ -375,142 +375,93 @@ TArray<FName> UWeaponAttackRecorderComponent::FindRelevantSockets(UMeshComponent
 
 
 
-TArray<FWeaponAttackTimestamp> UWeaponAttackRecorderComponent::ReduceToKeyframesForSocket(const TArray<FWeaponAttackTimestamp>& OriginalSequence, int32 SocketIndex) const
+TArray<int32> UWeaponAttackRecorderComponent::ReduceToKeyframes(const TArray<FWeaponAttackTimestamp>& Sequence, float MaxDeviation)
 {
-    TArray<FWeaponAttackTimestamp> Keyframes;
-
-    // Check if the original sequence is empty
-    if (OriginalSequence.Num() == 0)
+    TArray<int32> Keyframes;
+    if (Sequence.Num() == 0)
     {
-        UE_LOG(LogTemp, Warning, TEXT("ReduceToKeyframesForSocket: Original sequence is empty."));
         return Keyframes;
     }
 
-    // Check if the socket index is valid
-    if (!OriginalSequence[0].SocketPositions.IsValidIndex(SocketIndex))
+    int32 NumSockets = Sequence[0].SocketPositions.Num();
+    for (const FWeaponAttackTimestamp& Frame : Sequence)
     {
-        UE_LOG(LogTemp, Error, TEXT("ReduceToKeyframesForSocket: Invalid socket index %d."), SocketIndex);
-        return Keyframes;
+        NumSockets = FMath::Min(NumSockets, Frame.SocketPositions.Num());
     }
 
-    // If there's only one element in the original sequence, print an error and return empty
-    if (OriginalSequence.Num() == 1)
-    {
-        UE_LOG(LogTemp, Error, TEXT("ReduceToKeyframesForSocket: Original sequence has only one element, which is insufficient for reduction."));
-        return Keyframes;
-    }
+    TArray<bool> Keep;
+    Keep.SetNumZeroed(Sequence.Num());
+    Keep[0] = true;
+    Keep.Last() = true;
 
-    // If there are exactly two elements in the original sequence, return them early
-    if (OriginalSequence.Num() == 2)
+    // Spans still to be checked, split at the frame that deviates most until every frame is within MaxDeviation
+    TArray<TPair<int32, int32>, TInlineAllocator<32>> Spans;
+    Spans.Emplace(0, Sequence.Num() - 1);
+    const float MaxDeviationSquared = FMath::Square(MaxDeviation);
+    while (Spans.Num() > 0)
     {
-        return OriginalSequence;
-    }
-
-    // Always include the first keyframe
-    Keyframes.Add(OriginalSequence[0]);
-    int32 LastKeyframeIndex = 0;
+        const TPair<int32, int32> Span = Spans.Pop(EAllowShrinking::No);
+        const FWeaponAttackTimestamp& First = Sequence[Span.Key];
+        const FWeaponAttackTimestamp& Last = Sequence[Span.Value];
+        const float Duration = Last.Timestamp - First.Timestamp;
 
-    const float MinDistance = Settings->MinDistance; // Minimum distance in centimeters to consider a keyframe
-    const float AngleThreshold = FMath::DegreesToRadians(Settings->AngleThreshold); // Angle threshold in radians
-
-    for (int32 i = 1; i < OriginalSequence.Num() - 1; ++i)
-    {
-        const FWeaponAttackTimestamp& Prev = OriginalSequence[LastKeyframeIndex];
-        const FWeaponAttackTimestamp& Current = OriginalSequence[i];
-        const FWeaponAttackTimestamp& Next = OriginalSequence[i + 1];
-
-        // Ensure all timestamps have valid traces for the specified socket
-        if (!Prev.SocketPositions.IsValidIndex(SocketIndex) || 
-            !Current.SocketPositions.IsValidIndex(SocketIndex) || 
-            !Next.SocketPositions.IsValidIndex(SocketIndex))
+        int32 WorstFrame = INDEX_NONE;
+        float WorstDeviationSquared = MaxDeviationSquared;
+        for (int32 i = Span.Key + 1; i < Span.Value; ++i)
         {
-            UE_LOG(LogTemp, Warning, TEXT("ReduceToKeyframesForSocket: Invalid trace data at index %d."), i);
-            continue;
+            // Compare against where replay interpolates the sockets at this frame's time, not the closest point of the path
+            const float Alpha = Duration > 0.f ? (Sequence[i].Timestamp - First.Timestamp) / Duration : 0.5f;
+            for (int32 Socket = 0; Socket < NumSockets; ++Socket)
+            {
+                const FVector Replayed = FMath::Lerp(First.SocketPositions[Socket], Last.SocketPositions[Socket], Alpha);
+                const float DeviationSquared = FVector::DistSquared(Replayed, Sequence[i].SocketPositions[Socket]);
+                if (DeviationSquared > WorstDeviationSquared)
+                {
+                    WorstDeviationSquared = DeviationSquared;
+                    WorstFrame = i;
+                }
+            }
         }
 
-        // Calculate vectors between points for the specified socket
-        FVector Vector1 = Current.SocketPositions[SocketIndex] - Prev.SocketPositions[SocketIndex];
-        FVector Vector2 = Next.SocketPositions[SocketIndex] - Current.SocketPositions[SocketIndex];
-
-        // Calculate angle between vectors
-        float Angle = 0.0f;
-        if (!Vector1.IsNearlyZero() && !Vector2.IsNearlyZero())
+        if (WorstFrame != INDEX_NONE)
         {
-            Angle = FMath::Acos(FVector::DotProduct(Vector1.GetSafeNormal(), Vector2.GetSafeNormal()));
+            Keep[WorstFrame] = true;
+            Spans.Emplace(Span.Key, WorstFrame);
+            Spans.Emplace(WorstFrame, Span.Value);
         }
+    }
 
-        // Calculate distance from the last keyframe
-        float Distance = FVector::Dist(Prev.SocketPositions[SocketIndex], Current.SocketPositions[SocketIndex]);
-
-        // Check if both the angle change and distance are significant
-        if (Angle > AngleThreshold && Distance > MinDistance)
+    for (int32 i = 0; i < Keep.Num(); ++i)
+    {
+        if (Keep[i])
         {
-            Keyframes.Add(Current);
-            LastKeyframeIndex = i;
+            Keyframes.Add(i);
         }
     }
- 
-    // Always include the last keyframe
-    Keyframes.Add(OriginalSequence.Last());
-
     return Keyframes;
 }
 
 
 void UWeaponAttackRecorderComponent::PostProcessRecordedData()
 {
-    TArray<FWeaponAttackTimestamp> ReducedSequence;
-
-    if (CurrentSession.AttackData->AttackSequence.Num() < 2)
+    TArray<FWeaponAttackTimestamp>& Sequence = CurrentSession.AttackData->AttackSequence;
+    if (Sequence.Num() < 3)
     {
         // Not enough data to reduce
         return;
     }
 
-    // Invert the dimensions of the keyframes so its an array of sockets each with a number of timestamps
-    // And reduce the keyframes to only the necessary amount
-    TArray<TArray<FWeaponAttackTimestamp>> SocketKeyframes;
-    for (int32 SocketIndex = 0; SocketIndex < CurrentSession.RelevantSockets.Num(); ++SocketIndex)
-    {
-        TArray<FWeaponAttackTimestamp> ReducedKeys = ReduceToKeyframesForSocket(CurrentSession.AttackData->AttackSequence, SocketIndex);
-        SocketKeyframes.Add(ReducedKeys);
-    }
-
-    // Find the socket with the most keyframes
-    int32 MaxKeyframesIndex = 0;
-    int32 MaxKeyframesCount = SocketKeyframes[0].Num();
-    for (int32 i = 1; i < SocketKeyframes.Num(); ++i)
-    {
-        if (SocketKeyframes[i].Num() > MaxKeyframesCount)
-        {
-            MaxKeyframesCount = SocketKeyframes[i].Num();
-            MaxKeyframesIndex = i;
-        }
-    }
-
-    const TArray<FWeaponAttackTimestamp>& MasterKeyframes = SocketKeyframes[MaxKeyframesIndex];
-
-    // Collect positions from all sockets at the master keyframe timestamps and revert the dimensions back to original format
-    for (int32 i = 0; i < MasterKeyframes.Num(); ++i)
+    // One reduction over all sockets, so every kept keyframe holds every socket
+    const TArray<int32> Keyframes = ReduceToKeyframes(Sequence, Settings->MaxDeviation);
+    TArray<FWeaponAttackTimestamp> ReducedSequence;
+    ReducedSequence.Reserve(Keyframes.Num());
+    for (const int32 FrameIndex : Keyframes)
     {
-        const FWeaponAttackTimestamp& MasterKeyframe = MasterKeyframes[i];
-        FWeaponAttackTimestamp NewTimestamp;
-        NewTimestamp.Timestamp = MasterKeyframe.Timestamp;
-
-        for (int32 SocketIndex = 0; SocketIndex < CurrentSession.RelevantSockets.Num(); ++SocketIndex)
-        {
-            // Directly access the matching timestamp in the original sequence for each socket
-            const TArray<FVector>& OriginalKeysAtKeyframe = CurrentSession.AttackData->AttackSequence[MasterKeyframe.OriginalIndex].SocketPositions;
-            FVector Trace = OriginalKeysAtKeyframe[SocketIndex];
-            NewTimestamp.SocketPositions.Add(Trace);
-        }
-
-        ReducedSequence.Add(NewTimestamp);
+        ReducedSequence.Add(MoveTemp(Sequence[FrameIndex]));
     }
 
-    // Replace the original sequence with the reduced one
-    CurrentSession.AttackData->AttackSequence = ReducedSequence;
-    
+    UE_LOG(LogTemp, Log, TEXT("Reduced attack recording from %d to %d keyframes."), Sequence.Num(), ReducedSequence.Num());
+    Sequence = MoveTemp(ReducedSequence);
 }
 
 
@@ -568,6 +519,7 @@ bool UWeaponAttackRecorderComponent::SaveAttackSequence(const FString& AssetName
     // Copy properties from the input AttackData to the new asset
     NewAsset->FirstTraceDelay = AttackData->FirstTraceDelay;
     NewAsset->AttackSequence = AttackData->AttackSequence;
+    NewAsset->PackAttackSequence();
 
     // Set the attackdata of the session to the new version, this prevents the old one being used for replay which may be garbage collected
     CurrentSession.AttackData = NewAsset;
@@ -0,0 +1,156 @@
+// Copyright Rancorous Games, 2024
+
+#include "RecordingSystem/WeaponAttackRecorderDataTypes.h"
+#include "LogRancInventorySystem.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/UObjectIterator.h"
+
+namespace RISAttackDataPacking
+{
+	constexpr float QuantizationSteps = TNumericLimits<uint16>::Max();
+}
+
+#if WITH_EDITOR
+
+void UWeaponAttackData::PackAttackSequence()
+{
+	PackedTimes.Reset();
+	PackedPositions.Reset();
+	NumSockets = 0;
+
+	const int32 NumKeyframes = AttackSequence.Num();
+	if (NumKeyframes > 0)
+	{
+		NumSockets = AttackSequence[0].SocketPositions.Num();
+		for (const FWeaponAttackTimestamp& Keyframe : AttackSequence)
+		{
+			if (Keyframe.SocketPositions.Num() != NumSockets)
+			{
+				UE_LOG(LogRancInventorySystem, Warning, TEXT("%s: Keyframes have different socket counts, only the first %d sockets are kept."), *GetName(), NumSockets);
+				NumSockets = FMath::Min(NumSockets, Keyframe.SocketPositions.Num());
+			}
+		}
+	}
+
+	FBox3f Bounds(ForceInit);
+	for (const FWeaponAttackTimestamp& Keyframe : AttackSequence)
+	{
+		PackedTimes.Add(Keyframe.Timestamp);
+		for (int32 Socket = 0; Socket < NumSockets; ++Socket)
+		{
+			Bounds += FVector3f(Keyframe.SocketPositions[Socket]);
+		}
+	}
+	PackedBoundsMin = Bounds.IsValid ? Bounds.Min : FVector3f::ZeroVector;
+	PackedBoundsSize = Bounds.IsValid ? Bounds.GetSize() : FVector3f::ZeroVector;
+
+	const int32 NumPositions = NumKeyframes * NumSockets;
+	PackedPositions.SetNumUninitialized(NumPositions * 3);
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const float Scale = PackedBoundsSize[Axis] > 0.f ? RISAttackDataPacking::QuantizationSteps / PackedBoundsSize[Axis] : 0.f;
+		uint16* AxisValues = PackedPositions.GetData() + Axis * NumPositions;
+		for (int32 Keyframe = 0; Keyframe < NumKeyframes; ++Keyframe)
+		{
+			for (int32 Socket = 0; Socket < NumSockets; ++Socket)
+			{
+				const float Value = (AttackSequence[Keyframe].SocketPositions[Socket][Axis] - PackedBoundsMin[Axis]) * Scale;
+				AxisValues[Keyframe * NumSockets + Socket] = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Value), 0, TNumericLimits<uint16>::Max()));
+			}
+		}
+	}
+
+	DecodeReplayBuffer();
+}
+
+int64 UWeaponAttackData::GetUnpackedSize() const
+{
+	int64 Size = AttackSequence.GetAllocatedSize();
+	for (const FWeaponAttackTimestamp& Keyframe : AttackSequence)
+	{
+		Size += Keyframe.SocketPositions.GetAllocatedSize();
+	}
+	return Size;
+}
+
+void UWeaponAttackData::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	PackAttackSequence();
+	Super::PreSave(ObjectSaveContext);
+}
+
+void UWeaponAttackData::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	PackAttackSequence();
+}
+
+// Logs the packed and unpacked sizes of all loaded attacks, load the montage library first to compare all of them
+static FAutoConsoleCommand ReportAttackDataSizesCommand(
+	TEXT("RIS.ReportAttackDataSizes"),
+	TEXT("Logs the packed and unpacked size of every loaded UWeaponAttackData"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		int32 NumAttacks = 0;
+		int64 TotalUnpacked = 0;
+		int64 TotalPacked = 0;
+		for (TObjectIterator<UWeaponAttackData> It; It; ++It)
+		{
+			if (It->HasAnyFlags(RF_ClassDefaultObject))
+				continue;
+
+			++NumAttacks;
+			TotalUnpacked += It->GetUnpackedSize();
+			TotalPacked += It->GetPackedSize();
+			UE_LOG(LogRancInventorySystem, Display, TEXT("%s: %d keyframes, %d sockets, %lld bytes unpacked, %lld bytes packed"),
+			       *It->GetPathName(), It->GetNumKeyframes(), It->GetNumSockets(), It->GetUnpackedSize(), It->GetPackedSize());
+		}
+		UE_LOG(LogRancInventorySystem, Display, TEXT("%d attacks, %lld bytes unpacked, %lld bytes packed"), NumAttacks, TotalUnpacked, TotalPacked);
+	}));
+
+#endif // WITH_EDITOR
+
+void UWeaponAttackData::PostLoad()
+{
+	Super::PostLoad();
+
+#if WITH_EDITOR
+	// Assets saved before the packed format only have the source sequence
+	if (PackedTimes.Num() == 0 && AttackSequence.Num() > 0)
+	{
+		PackAttackSequence();
+		return;
+	}
+#endif
+
+	DecodeReplayBuffer();
+}
+
+int64 UWeaponAttackData::GetPackedSize() const
+{
+	return PackedTimes.Num() * sizeof(float) + PackedPositions.Num() * sizeof(uint16) + 2 * sizeof(FVector3f) + sizeof(int32);
+}
+
+void UWeaponAttackData::DecodeReplayBuffer()
+{
+	const int32 NumPositions = PackedTimes.Num() * NumSockets;
+	if (PackedPositions.Num() != NumPositions * 3)
+	{
+		UE_CLOG(PackedPositions.Num() > 0, LogRancInventorySystem, Error, TEXT("%s: Packed attack data is corrupt and cannot be replayed."), *GetName());
+		PackedTimes.Reset();
+		ReplayPositions.Reset();
+		return;
+	}
+
+	const FVector3f StepSize = PackedBoundsSize / RISAttackDataPacking::QuantizationSteps;
+	const uint16* X = PackedPositions.GetData();
+	const uint16* Y = X + NumPositions;
+	const uint16* Z = Y + NumPositions;
+
+	ReplayPositions.SetNumUninitialized(NumPositions);
+	for (int32 i = 0; i < NumPositions; ++i)
+	{
+		ReplayPositions[i] = PackedBoundsMin + FVector3f(X[i], Y[i], Z[i]) * StepSize;
+	}
+}
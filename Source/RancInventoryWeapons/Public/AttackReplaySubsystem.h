@@ -0,0 +1,59 @@
+// Copyright Rancorous Games, 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AttackReplaySubsystem.generated.h"
+
+class UGearManagerComponent;
+class UWeaponAttackData;
+
+USTRUCT()
+struct FActiveAttackReplay
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TWeakObjectPtr<UGearManagerComponent> GearManager;
+
+	UPROPERTY()
+	const UWeaponAttackData* AttackData = nullptr;
+
+	// Index of the next keyframe to process, the segment from this keyframe to the next is traced when it is reached
+	int32 NextKeyframe = 0;
+
+	// Seconds since the replay started, relative to the first keyframe of the sequence
+	float ElapsedTime = 0.f;
+};
+
+/* Advances all recorded attack replays of a world once per tick instead of each attack rescheduling a timer per keyframe.
+ * Every keyframe crossed since the last tick is processed, so replays stay accurate whether keyframes are denser or sparser than frames */
+UCLASS()
+class RANCINVENTORYWEAPONS_API UAttackReplaySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Starts replaying AttackData for GearManager and traces its first segment right away, restarts the replay if one is already running
+	void StartReplay(UGearManagerComponent* GearManager, const UWeaponAttackData* AttackData);
+
+	// Stops the replay of GearManager without notifying it
+	void StopReplay(const UGearManagerComponent* GearManager);
+
+	UFUNCTION(BlueprintPure, Category = "Ranc Inventory Weapons")
+	int32 GetNumActiveReplays() const;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return ActiveReplays.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	void AdvanceReplay(int32 ReplayIndex);
+
+	// Stopped replays stay in the array with an invalid GearManager until the end of the next tick
+	UPROPERTY()
+	TArray<FActiveAttackReplay> ActiveReplays;
+};
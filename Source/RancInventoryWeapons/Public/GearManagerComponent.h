@@ -7,6 +7,7 @@
 #include "GearDefinition.h"
 #include "RISWeaponsDataTypes.h"
 #include "Engine/HitResult.h"
+#include "WorldCollision.h"
 #include "GearManagerComponent.generated.h"
 
 class UWeaponDefinition;
@@ -22,6 +23,17 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FGearUpdated, FGameplayTag, Slot, F
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FWeaponEquipState, FName, WeaponType, bool , bEquipState);
 
+// One capsule sweep of a swept capsule attack replay segment
+struct FAttackReplayCapsuleSweep
+{
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	// Socket positions at the end of the sweep, where the capsule stops
+	FVector EndA = FVector::ZeroVector;
+	FVector EndB = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	float HalfHeight = 0.f;
+};
 
 UENUM(BlueprintType)
 enum class EGearSlotType : uint8 {MainHand, OffHand, Armor};
@@ -115,6 +127,8 @@ class RANCINVENTORYWEAPONS_API UGearManagerComponent : public UActorComponent
 {
 	GENERATED_BODY()
 
+	friend class UAttackReplaySubsystem;
+
 public:
 
 	// Sets default values for this component's properties
@@ -279,6 +293,11 @@ public:
 	UFUNCTION(BlueprintNativeEvent, Category = "Ranc Inventory Weapons", meta=(DisplayName="GetAttackTraceAimParams"))
 	FAttackAimParams GetAttackTraceAimParams();
 
+	/* How far back in time the server evaluates a lag compensated attack of this character.
+	 * Defaults to the round trip time plus LagCompensationInterpolationDelay */
+	UFUNCTION(BlueprintNativeEvent, Category = "Ranc Inventory Weapons", meta=(DisplayName="GetLagCompensationRewindSeconds"))
+	float GetLagCompensationRewindSeconds();
+
 	/*	Initialized variables. Called from Begin play	*/
 	UFUNCTION(BlueprintCallable, Category = "Ranc Inventory Weapons")
 	void Initialize();
@@ -413,6 +432,7 @@ public:
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	/*
 	Plays montage safely, and handles nullptr, negative playrate. 
@@ -450,9 +470,11 @@ protected:
 	
 	virtual void GetLifetimeReplicatedProps(TArray < class FLifetimeProperty > & OutLifetimeProps) const override;
 
-	void PlayRecordedAttackSequence(const UWeaponAttackData* AttackData);
 	void SendAttackTraceAimRPC_Client();
-	void ContinueAttackReplay();
+	void StartAttackReplay();
+	// Traces the segment from the keyframe to the next one, called by the UAttackReplaySubsystem
+	void TraceAttackReplaySegment(const UWeaponAttackData& AttackData, int32 KeyframeIndex);
+	void OnReplayTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
 	void StopAttackReplay();
 
 	FMontageData GetEquipMontage(const UGearDefinition* WeaponData) const;
@@ -475,6 +497,46 @@ public:
 	
 	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category = "Ranc Inventory Weapons|Gear|AttackTraceRecording")
 	FVector ReplayAttackPivotLocationOffset;
+
+	/* Swept capsules cover the gaps between sockets and need one trace less per keyframe than lines */
+	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category = "Ranc Inventory Weapons|Gear|AttackTraceRecording")
+	EAttackReplayTraceShape ReplayTraceShape = EAttackReplayTraceShape::Lines;
+
+	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category = "Ranc Inventory Weapons|Gear|AttackTraceRecording", meta = (EditCondition = "ReplayTraceShape == EAttackReplayTraceShape::SweptCapsules", ClampMin = "0"))
+	float ReplayTraceRadius = 10.f;
+
+	/* Sweeps cannot rotate, segments where the blade turns more than this many degrees are split into several sweeps */
+	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category = "Ranc Inventory Weapons|Gear|AttackTraceRecording", meta = (EditCondition = "ReplayTraceShape == EAttackReplayTraceShape::SweptCapsules", ClampMin = "1", ClampMax = "180"))
+	float MaxReplayCapsuleSweepAngle = 15.f;
+
+	/* If true OnHitDetected is broadcast once per actor per attack, otherwise for every segment that hits it */
+	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category = "Ranc Inventory Weapons|Gear|AttackTraceRecording")
+	bool bReportEachActorOncePerAttack = false;
+
+	/* The capsule sweeps covering two sockets moving from StartA, StartB to EndA, EndB. The blade between them is split into
+	 * as many steps as needed to keep the turn of each sweep within MaxAngleDegrees, each sweep is aligned to the average
+	 * of its start and end orientation and long enough for either */
+	static void BuildReplayCapsuleSweeps(const FVector& StartA, const FVector& StartB, const FVector& EndA, const FVector& EndB, float Radius,
+	                                     float MaxAngleDegrees, TArray<FAttackReplayCapsuleSweep, TInlineAllocator<8>>& OutSweeps);
+
+	// Starts a new replayed attack, hits of the previous attack no longer count towards bReportEachActorOncePerAttack
+	void PlayRecordedAttackSequence(const UWeaponAttackData* AttackData);
+
+	// Broadcasts OnHitDetected for a hit of the replayed attack, unless bReportEachActorOncePerAttack already reported the actor
+	void ReportReplayHit(AActor* HitActor, const FHitResult& HitResult);
+
+	/* If true the owner is registered as a lag compensation target, and the server evaluates attacks of remote players against
+	 * lag compensation targets rewound to the time the attacker saw them. Other actors are still hit by the regular traces */
+	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category = "Ranc Inventory Weapons|Gear|LagCompensation")
+	bool bUseLagCompensation = false;
+
+	// How far clients render other characters behind the latest replicated state
+	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category = "Ranc Inventory Weapons|Gear|LagCompensation", meta = (ClampMin = "0"))
+	float LagCompensationInterpolationDelay = 0.1f;
+
+	// Upper bound of the rewind so high ping clients cannot hit targets that have long moved away
+	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category = "Ranc Inventory Weapons|Gear|LagCompensation", meta = (ClampMin = "0"))
+	float MaxLagCompensationSeconds = 0.4f;
 	
 protected:
 	
@@ -483,13 +545,19 @@ protected:
 	void SetAimInformationRPC_Server(FAttackAimParams AimParams, bool FinalAimUpdate);
 	FAttackAimParams ReceivedReplayAttackAimParams;
 
-	int ReplayCurrentIndex;
 	UPROPERTY()
 	const UWeaponAttackData* ReplayedAttackData;
 	double AttackStartTime;
 	FTimerHandle SendAimDirectionRPC_TimerHandle;
-	FTimerHandle AttackTrace_TimerHandle;
 	FTransform ReplayOwnerAttackOrigin;
+	// Built once per attack and shared by all of its replay traces
+	FCollisionQueryParams ReplayTraceParams;
+	FTraceDelegate ReplayTraceDelegate;
+	// Incremented per attack and passed as trace user data so results of an earlier attack arriving late are dropped
+	uint32 ReplayAttackSerial = 0;
+	TArray<TWeakObjectPtr<AActor>, TInlineAllocator<8>> ReplayHitActors;
+	// Set while replaying an attack whose hits on lag compensation targets come from the rewound hitboxes
+	bool bReplayIsLagCompensated = false;
 
 	UPROPERTY()
 	TArray<UObject*> LoadedAttackAssets;
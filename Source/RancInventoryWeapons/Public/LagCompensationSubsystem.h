@@ -0,0 +1,88 @@
+// Copyright Rancorous Games, 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "LagCompensationSubsystem.generated.h"
+
+// A capsule hitbox that intersected a rewound trace
+struct FLagCompensatedHit
+{
+	AActor* Actor = nullptr;
+	FVector ImpactPoint = FVector::ZeroVector;
+};
+
+/* Server side history of target hitboxes so attacks can be evaluated against where the attacker saw its targets.
+ * Hitboxes are upright capsules, every tick samples their locations into a ring buffer laid out as one contiguous
+ * block of locations per sample. History covers HistorySeconds, the ring grows with the tick rate until it spans that
+ * long, up to MaxSamples ticks. Rewinding is clamped to the oldest sample */
+UCLASS()
+class RANCINVENTORYWEAPONS_API ULagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Upper bound of the ring, two seconds of history at 1 kHz
+	static constexpr int32 MaxSamples = 2048;
+
+	// Samples are kept for at least Seconds, the history stays at the longest span requested
+	void ExtendHistory(float Seconds) { HistorySeconds = FMath::Max(HistorySeconds, Seconds); }
+	float GetHistorySeconds() const { return HistorySeconds; }
+	int32 GetSampleCapacity() const { return SampleTimes.Num(); }
+
+	// Registering an actor again updates its hitbox
+	void RegisterTarget(AActor* Target, float CapsuleRadius, float CapsuleHalfHeight);
+	void UnregisterTarget(const AActor* Target);
+	bool IsTargetRegistered(const AActor* Target) const { return TargetSlots.Contains(Target); }
+	int32 GetNumTargets() const { return TargetSlots.Num(); }
+
+	// Records the current location of every target, called every tick on the server
+	void SampleTargets(double Time);
+
+	/* Tests the segment from Start to End, thickened by TraceRadius, against all hitboxes rewound to Time.
+	 * Hits are appended in slot order, IgnoredActor is skipped */
+	void FindRewoundHits(double Time, const FVector& Start, const FVector& End, float TraceRadius, const AActor* IgnoredActor, TArray<FLagCompensatedHit>& OutHits) const;
+
+	// Returns false if Target is not registered or has no samples yet
+	bool GetRewoundLocation(const AActor* Target, double Time, FVector& OutLocation) const;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	struct FTarget
+	{
+		TWeakObjectPtr<AActor> Actor;
+		float Radius = 0.f;
+		float HalfHeight = 0.f;
+		// Time of the first sample that includes this target, earlier rewinds use that sample
+		double FirstSampleTime = TNumericLimits<double>::Max();
+	};
+
+	// Ring index of the sample Age samples before the newest one
+	int32 GetRingIndex(int32 Age) const { return (NewestSample - Age + SampleTimes.Num()) % SampleTimes.Num(); }
+
+	// Finds the two samples around Time and the blend between them, clamped to the recorded history
+	void FindSamples(double Time, int32& OutOlderIndex, int32& OutNewerIndex, float& OutAlpha) const;
+	FVector GetSampleLocation(int32 Slot, int32 OlderIndex, int32 NewerIndex, float Alpha) const;
+
+	void SetSlotStride(int32 NewStride);
+	// Reallocates the ring with the samples ordered from oldest to newest
+	void SetSampleCapacity(int32 NewCapacity);
+
+	TArray<FTarget> Targets; // Indexed by slot, slots of unregistered targets are reused
+	TArray<int32> FreeSlots;
+	TMap<TObjectKey<AActor>, int32> TargetSlots;
+
+	float HistorySeconds = 1.f;
+	int32 SlotStride = 0; // Locations per sample, grows with the number of slots
+	TArray<double> SampleTimes; // Ring, its size is the sample capacity
+	TArray<FVector3f> SampleLocations; // Capacity * SlotStride, slot locations of each sample are contiguous
+	int32 NewestSample = INDEX_NONE;
+	int32 NumSamples = 0;
+};
@@ -0,0 +1,129 @@
+// Copyright Rancorous Games, 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/Interface.h"
+#include "ProjectilePoolSubsystem.generated.h"
+
+UINTERFACE(BlueprintType, MinimalAPI)
+class UPooledProjectile : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/* Optional hooks for projectiles spawned through UProjectilePoolSubsystem, to reset gameplay state that the pool does not know about.
+ * Pooled projectiles must not Destroy themselves to be reused, they should call UProjectilePoolSubsystem::ReturnProjectile instead */
+class RANCINVENTORYWEAPONS_API IPooledProjectile
+{
+	GENERATED_BODY()
+
+public:
+	// Called after the projectile has been moved to its spawn transform and enabled again
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Ranc Inventory Weapons | Projectile Pool")
+	void OnProjectileActivated();
+
+	// Called after the projectile has been hidden and its collision and movement disabled
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Ranc Inventory Weapons | Projectile Pool")
+	void OnProjectileDeactivated();
+
+	// Bouncing or piercing projectiles can return false to stay active after a blocking hit
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Ranc Inventory Weapons | Projectile Pool")
+	bool ShouldReturnOnImpact(const FHitResult& Hit);
+
+	virtual void OnProjectileActivated_Implementation() {}
+	virtual void OnProjectileDeactivated_Implementation() {}
+	virtual bool ShouldReturnOnImpact_Implementation(const FHitResult& Hit) { return true; }
+};
+
+USTRUCT()
+struct FPooledProjectileList
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> Projectiles;
+};
+
+USTRUCT()
+struct FActivePooledProjectile
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<AActor> Projectile = nullptr;
+
+	// Pool time at which the projectile is returned, impacts set it to the current time
+	double ReturnTime = 0.0;
+};
+
+/* Reuses projectile actors per class instead of spawning and destroying one per shot, shared by every weapon of the world.
+ * The class default InitialLifeSpan is taken over by the pool, expired and impacted projectiles are returned on the next tick
+ * so the hit handlers of the projectile still see it active. Projectiles destroyed by other code simply leave the pool */
+UCLASS(Config = Game)
+class RANCINVENTORYWEAPONS_API UProjectilePoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Spawns through the pool of World if it has one, otherwise spawns a regular actor
+	static AActor* SpawnProjectile(UWorld* World, TSubclassOf<AActor> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator);
+
+	// Takes an inactive projectile of the class from the pool, or spawns one if there is none
+	UFUNCTION(BlueprintCallable, Category = "Ranc Inventory Weapons | Projectile Pool")
+	AActor* AcquireProjectile(TSubclassOf<AActor> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator);
+
+	// Deactivates the projectile right away, projectiles that were not spawned by the pool are destroyed
+	UFUNCTION(BlueprintCallable, Category = "Ranc Inventory Weapons | Projectile Pool")
+	void ReturnProjectile(AActor* Projectile);
+
+	// Spawns inactive projectiles until the pool of the class holds Count of them
+	UFUNCTION(BlueprintCallable, Category = "Ranc Inventory Weapons | Projectile Pool")
+	void PrewarmPool(TSubclassOf<AActor> ProjectileClass, int32 Count);
+
+	UFUNCTION(BlueprintPure, Category = "Ranc Inventory Weapons | Projectile Pool")
+	int32 GetNumActiveProjectiles() const { return ActiveProjectiles.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "Ranc Inventory Weapons | Projectile Pool")
+	int32 GetNumPooledProjectiles(TSubclassOf<AActor> ProjectileClass) const;
+
+	// Number of projectile actors the pool has spawned since the world started
+	int32 GetNumSpawnedProjectiles() const { return NumSpawned; }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return ActiveProjectiles.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+
+	// Lifetime of projectiles whose class has no InitialLifeSpan
+	UPROPERTY(Config, EditAnywhere, Category = "Projectile Pool")
+	float DefaultProjectileLifetime = 10.f;
+
+	// Returned projectiles beyond this many inactive ones of a class are destroyed
+	UPROPERTY(Config, EditAnywhere, Category = "Projectile Pool")
+	int32 MaxPooledPerClass = 256;
+
+protected:
+	// Owner and Instigator are set while spawning so BeginPlay of the first use sees them like with a regular spawn
+	AActor* SpawnPooledActor(UClass* ProjectileClass, const FTransform& SpawnTransform, AActor* Owner = nullptr, APawn* Instigator = nullptr);
+	void ActivateProjectile(AActor* Projectile, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator);
+	void DeactivateProjectile(AActor* Projectile);
+	void RemoveActiveAt(int32 ActiveIndex);
+
+	UFUNCTION()
+	void OnProjectileHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	UFUNCTION()
+	void OnProjectileDestroyed(AActor* Projectile);
+
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FPooledProjectileList> InactiveProjectiles;
+
+	UPROPERTY()
+	TArray<FActivePooledProjectile> ActiveProjectiles;
+
+	TMap<TObjectKey<AActor>, int32> ActiveIndices; // Index into ActiveProjectiles
+
+	double PoolTime = 0.0;
+	int32 NumSpawned = 0;
+};
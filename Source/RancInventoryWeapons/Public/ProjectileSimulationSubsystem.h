@@ -0,0 +1,98 @@
+// Copyright Rancorous Games, 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RISWeaponsDataTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "ProjectileSimulationSubsystem.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+DECLARE_DELEGATE_OneParam(FOnSimulatedProjectileHit, const FHitResult&);
+
+USTRUCT()
+struct FSimulatedProjectileRenderGroup
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UStaticMesh> Mesh = nullptr;
+
+	UPROPERTY()
+	TObjectPtr<UInstancedStaticMeshComponent> Instances = nullptr;
+};
+
+/* Simulates ballistic projectiles without actors, for weapons that fire too many simple projectiles to spawn each of them.
+ * Projectiles are stored as parallel arrays and stepped in a parallel for, each step is swept with an async trace
+ * whose result arrives the next frame, so impacts are reported one frame after the projectile reached them.
+ * Projectiles are rendered as instances of their mesh on the machine that simulates them, they are not replicated.
+ * Weapons only fire them on the server so clients neither see them nor their impacts unless the game replicates those itself,
+ * which is why the simulation is opt-in through bEnableSimulation */
+UCLASS(Config = Game)
+class RANCINVENTORYWEAPONS_API UProjectileSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UProjectileSimulationSubsystem();
+
+	// Returns the id of the projectile, or 0 if the simulation is disabled. Owner and Instigator are ignored by its collision, OnHit is called on the first blocking hit
+	uint32 FireProjectile(const FSimulatedProjectileParams& Params, const FVector& Location, const FVector& Direction, AActor* Owner, AActor* Instigator, FOnSimulatedProjectileHit OnHit);
+
+	bool GetProjectileLocation(uint32 ProjectileId, FVector& OutLocation) const;
+
+	UFUNCTION(BlueprintPure, Category = "Ranc Inventory Weapons | Simulated Projectiles")
+	int32 GetNumProjectiles() const { return Ids.Num(); }
+
+	virtual void Tick(float DeltaTime) override;
+	// Keeps ticking until the instances of the last removed projectiles are cleared
+	virtual bool IsTickable() const override { return Ids.Num() > 0 || NumRenderedInstances > 0; }
+	virtual TStatId GetStatId() const override;
+
+	// Projectile counts below this are stepped on the game thread, where the task overhead would outweigh the work
+	int32 MinProjectilesForParallelStep = 256;
+
+	// FireProjectile does nothing unless set, either in the [/Script/RancInventoryWeapons.ProjectileSimulationSubsystem] section of the game config or at runtime
+	UPROPERTY(Config, BlueprintReadWrite, Category = "Ranc Inventory Weapons | Simulated Projectiles")
+	bool bEnableSimulation = false;
+
+protected:
+	void StepProjectiles(float DeltaTime);
+	void TraceProjectiles();
+	void UpdateInstances();
+	void RemoveProjectileAt(int32 Index);
+	int32 FindOrAddRenderGroup(UStaticMesh* Mesh);
+
+	void OnProjectileTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	// Parallel arrays, one entry per projectile in flight
+	TArray<uint32> Ids;
+	TArray<FVector> Positions;
+	TArray<FVector> PreviousPositions;
+	TArray<FVector> Velocities;
+	TArray<float> GravityZ;
+	TArray<float> RemainingLifetimes;
+	TArray<float> Radii;
+	TArray<TEnumAsByte<ECollisionChannel>> TraceChannels;
+	TArray<int32> RenderGroupIndices;
+	TArray<TWeakObjectPtr<AActor>> Owners;
+	TArray<TWeakObjectPtr<AActor>> Instigators;
+	TArray<FOnSimulatedProjectileHit> HitDelegates;
+
+	TMap<uint32, int32> IndicesById;
+	// Hit delegates of projectiles that expired while the trace of their last step is still pending
+	TMap<uint32, FOnSimulatedProjectileHit> ExpiredHitDelegates;
+	uint32 NextProjectileId = 1;
+
+	FTraceDelegate ProjectileTraceDelegate;
+
+	UPROPERTY()
+	TArray<FSimulatedProjectileRenderGroup> RenderGroups;
+
+	UPROPERTY()
+	TObjectPtr<AActor> RenderActor = nullptr;
+
+	int32 NumRenderedInstances = 0;
+};
@@ -2,8 +2,10 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimMontage.h"
+#include "Engine/NetSerialization.h"
 #include "RISWeaponsDataTypes.generated.h"
 
+class UStaticMesh;
 class UWeaponAttackData;
 
 UENUM(BlueprintType)
@@ -20,6 +22,16 @@ enum class EHandCompatibility : uint8
 };
 
 
+UENUM(BlueprintType)
+enum class EAttackReplayTraceShape : uint8
+{
+    /** One line per socket between keyframes */
+    Lines,
+    /** One capsule per pair of adjacent sockets swept between keyframes, a single socket sweeps a sphere */
+    SweptCapsules
+};
+
+
 USTRUCT(BlueprintType)
 struct FAttackMontageData
 {
@@ -59,6 +71,15 @@ struct FMontageData
 };
 
 
+UENUM(BlueprintType)
+enum class EFirePattern : uint8
+{
+    /** Parallel shots BulletSpacingForNonSpreadPattern apart */
+    Line,
+    /** Shots fanned out DegreeSpacingForSpreadPattern apart, each offset by a random angle within the random spread */
+    Spread
+};
+
 USTRUCT(BlueprintType)
 struct FProjectileFiringData : public FTableRowBase
 {
@@ -70,6 +91,9 @@ struct FProjectileFiringData : public FTableRowBase
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Pattern)
     int32 ProjectilesPerShot = 1;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Pattern)
+    EFirePattern Pattern = EFirePattern::Line;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Pattern)
     float DegreeSpacingForSpreadPattern = 10.0f;
 
@@ -88,4 +112,77 @@ struct FProjectileFiringData : public FTableRowBase
     {
 
     }
-};
\ No newline at end of file
+};
+
+// Aim of one trigger pull sent by a client, the server adds the pattern and seed to make the FFirePatternEvent
+USTRUCT()
+struct FFireRequest
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FVector_NetQuantize Origin = FVector::ZeroVector;
+
+    // Compressed with FRotator::CompressAxisToShort, shots have no roll
+    UPROPERTY()
+    uint16 Pitch = 0;
+
+    UPROPERTY()
+    uint16 Yaw = 0;
+};
+
+// One trigger pull of a URangedWeaponFiringComponent, the server regenerates every shot of the pattern from it
+USTRUCT()
+struct FFirePatternEvent
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FVector_NetQuantize Origin = FVector::ZeroVector;
+
+    // Compressed with FRotator::CompressAxisToShort, shots have no roll
+    UPROPERTY()
+    uint16 Pitch = 0;
+
+    UPROPERTY()
+    uint16 Yaw = 0;
+
+    UPROPERTY()
+    EFirePattern Pattern = EFirePattern::Line;
+
+    // Seeds the random spread so every machine generates the same shots. Always drawn on the server, clients receive it with the event multicast
+    UPROPERTY()
+    uint16 Seed = 0;
+
+    FRotator GetRotation() const
+    {
+        return FRotator(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), 0.f);
+    }
+};
+// A ballistic projectile simulated by UProjectileSimulationSubsystem instead of being spawned as an actor
+USTRUCT(BlueprintType)
+struct FSimulatedProjectileParams
+{
+    GENERATED_BODY()
+
+    // Rendered as an instance of this mesh oriented along the velocity, not rendered if null
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulated Projectile")
+    TObjectPtr<UStaticMesh> Mesh = nullptr;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulated Projectile", meta = (ClampMin = 0))
+    float Speed = 5000.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulated Projectile")
+    float GravityScale = 1.f;
+
+    // Collision is swept as a sphere of this radius, or traced as a line if 0
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulated Projectile", meta = (ClampMin = 0))
+    float Radius = 0.f;
+
+    // Seconds before the projectile is removed without hitting anything
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulated Projectile", meta = (ClampMin = 0))
+    float Lifetime = 5.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulated Projectile")
+    TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+};
@@ -36,10 +36,23 @@ public:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ranged Weapon", meta = (AssetBundles = "Data"))
     TSubclassOf<AActor> ProjectileClass;
 
+    /** Inactive projectiles of ProjectileClass kept ready in the projectile pool once the weapon is initialized on the server */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ranged Weapon",
+        meta = (UIMin = 0, ClampMin = 0, AssetBundles = "Data"))
+    int32 ProjectilePoolPrewarmCount = 0;
+
     /** Whether the weapon spawns projectiles or uses hitscan */
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ranged Weapon", meta = (AssetBundles = "Data"))
     bool bSpawnProjectiles;
 
+    /** Whether projectiles are simulated without actors by the projectile simulation subsystem, hits are applied like hitscan hits */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ranged Weapon", meta = (AssetBundles = "Data"))
+    bool bSimulateProjectiles = false;
+
+    /** The projectile fired when bSimulateProjectiles is set, ProjectileClass is not used then */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ranged Weapon", meta = (EditCondition = "bSimulateProjectiles", AssetBundles = "Data"))
+    FSimulatedProjectileParams SimulatedProjectile;
+
     /** The random spread of the weapon in degrees */
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ranged Weapon",
         meta = (UIMin = 0, ClampMin = 0, AssetBundles = "Data"))
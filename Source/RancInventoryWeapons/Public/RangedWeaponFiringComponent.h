@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Components/SceneComponent.h"
 #include "TimerManager.h"
+#include "RISWeaponsDataTypes.h"
 #include "RangedWeaponFiringComponent.generated.h"
 
 
@@ -13,6 +14,7 @@ class AController;
 class UMovementUtilityComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FFiringEvent);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnFireEventConfirmed, const FFirePatternEvent&);
 
 UENUM(BlueprintType)
 enum class ERotationType : uint8 {WorldSpaceOfComponent,ControllerRotation};
@@ -60,6 +62,9 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FFiringEvent OnWeaponReload;
 
+	// Fire events executed by the server, broadcast on clients with the server's seed so cosmetic shots match GenerateFirePattern
+	FOnFireEventConfirmed OnFireEventConfirmed;
+
 	UPROPERTY(BlueprintAssignable)
 	FFiringEvent OnAmmunitionRestore;
 
@@ -185,6 +190,13 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=FiringData)
 	FProjectileFiringData FiringData = FProjectileFiringData();
 
+	/*
+	Inactive projectiles kept ready in the projectile pool from BeginPlay on the server.
+	Only used if the projectile class is already loaded, e.g. ProjectilesPerShot times the shots fired within the projectile lifetime.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=FiringData)
+	int32 ProjectilePoolPrewarmCount = 0;
+
 
 	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category = FiringMontage)	
 	TSoftObjectPtr<class UAnimMontage> FiringSoftAnimMontage;
@@ -196,6 +208,16 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=LineTrace)
 	bool bUseLineTracesInsteadOfProjectiles = false;
 
+	/*
+	If true, projectiles are simulated without actors by the projectile simulation subsystem instead of spawning FiringData.ProjectileSoftClass.
+	Their hits apply LineTraceDamage like line traces.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=SimulatedProjectile)
+	bool bUseSimulatedProjectiles = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=SimulatedProjectile)
+	FSimulatedProjectileParams SimulatedProjectile;
+
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=LineTrace)
 	TSubclassOf < class UDamageType > LineTraceDamageTypeClass = NULL;
@@ -256,9 +278,49 @@ public:
 	UFUNCTION(Server,Reliable)
 	void FireLineTraceServer(const FVector StartLocation, const FRotator InitialRotation) const;
 
+	void FireLineTrace_ServerImpl(const FVector& StartLocation, const FRotator& InitialRotation, const FCollisionQueryParams& QueryParams) const;
+
+	void ApplyLineTraceHit(const FHitResult& HitResult) const;
+
 	UFUNCTION(BlueprintCallable, Category = Basic)
 	void FirePattern();
 
+	// Fire event of one trigger pull from the component transform. Pattern and seed only count on the server, clients just send the aim
+	FFirePatternEvent MakeFireEvent() const;
+
+	// Every shot of the fire event's pattern, the same on every machine for the same event and FiringData
+	void GenerateFirePattern(const FFirePatternEvent& FireEvent, TArray<FTransform>& OutShots) const;
+
+	// Runs the fire event on the server, clients send the aim of a trigger pull in one RPC
+	void SubmitFireEvent(const FFirePatternEvent& FireEvent);
+
+	UFUNCTION(Server,Reliable)
+	void FireEventServer(const FFireRequest& Request);
+
+	// Sends the executed event with the server's pattern and seed to the clients
+	UFUNCTION(NetMulticast,Unreliable)
+	void FireEventMulticast(const FFirePatternEvent& FireEvent);
+
+	/*
+	Turns a fire request received from a client into a fire event. Returns false if the weapon is still on cooldown.
+	The pattern is taken from FiringData and the seed is drawn on the server, only the origin and aim come from the client.
+	*/
+	bool ValidateFireEvent_ServerImpl(const FFireRequest& Request, FFirePatternEvent& OutFireEvent);
+
+	void ExecuteFireEvent_ServerImpl(const FFirePatternEvent& FireEvent) const;
+
+	/*
+	Fire event origins further than this from the component on the server are moved to the component.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Firing)
+	float MaxFireOriginError = 200.0f;
+
+	/*
+	Fire events from clients may arrive this many seconds before the cooldown has passed on the server, to allow for network jitter.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Firing)
+	float FireEventCooldownTolerance = 0.05f;
+
 
 
 	void FireSingleProjectile(const FVector SpawnLocation, const FRotator SpawnRotation) const;
@@ -266,6 +328,8 @@ public:
 	UFUNCTION(Server,Reliable)
 	void FireSingleProjectileServer(const FVector SpawnLocation, const FRotator SpawnRotation) const;
 
+	void FireSingleProjectile_ServerImpl(const FVector& SpawnLocation, const FRotator& SpawnRotation) const;
+
 	UFUNCTION(BlueprintCallable,Category = Firing)
 	void FireWeaponComponent();
 
@@ -335,6 +399,9 @@ public:
 
 private:
 	//UMovementUtilityComponent* MovementUtility = nullptr;
+
+	// Spread seeds of fire events are drawn from this on the server, clients only learn the drawn seeds
+	FRandomStream FireEventSeedStream;
 	
 	FRotator GetFiringInitialRotation(const ERotationType InputRotationType) const;
 	
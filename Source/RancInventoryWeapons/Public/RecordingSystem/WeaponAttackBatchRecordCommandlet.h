@@ -0,0 +1,57 @@
+// Copyright Rancorous Games, 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WeaponAttackRecorderDataTypes.h"
+#include "WeaponAttackBatchRecordCommandlet.generated.h"
+
+class UAnimMontage;
+class USkeletalMesh;
+
+#if WITH_EDITOR
+
+// Everything needed to sample one attack montage offline, filled on the game thread and sampled on a worker
+struct RANCINVENTORYWEAPONS_API FWeaponAttackSampleJob
+{
+	const UAnimMontage* Montage = nullptr;
+	float PlayRate = 1.f;
+	const USkeletalMesh* CharacterMesh = nullptr;
+	FName AttachSocket;
+	FTransform MeshRelativeTransform;
+	FVector PivotLocationOffset = FVector::ZeroVector;
+	// Recorded weapon socket locations relative to the attach socket
+	TArray<FVector> WeaponSocketLocations;
+	float SampleRate = 120.f;
+	float MaxDeviation = 1.f;
+
+	// Results
+	float FirstTraceDelay = 0.f;
+	TArray<FWeaponAttackTimestamp> Sequence;
+	FString Error;
+};
+
+#endif
+
+/* Records the attack traces of every weapon attack montage without playing them in PIE.
+ * Montages are evaluated at a fixed sample rate in parallel worker tasks and written as UWeaponAttackData assets in bulk.
+ * Usage: UnrealEditor-Cmd <Project> -run=WeaponAttackBatchRecord [-Settings=/Game/Path/Settings] [-Overwrite] [-UpdateWeapons]
+ * -UpdateWeapons also points the attack montages of the weapon definitions at the recorded assets, including existing ones that were not overwritten */
+UCLASS()
+class RANCINVENTORYWEAPONS_API UWeaponAttackBatchRecordCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UWeaponAttackBatchRecordCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+#if WITH_EDITOR
+	/* Samples the montage between its attack trace notifies, or over its whole length if it has none,
+	 * with the character at the origin facing X. Sequences with root motion or a forced root lock are sampled with their root bone locked.
+	 * Thread safe once the montage animations are compressed */
+	static void SampleAttack(FWeaponAttackSampleJob& Job);
+#endif
+};
@@ -89,6 +89,11 @@ public:
 
     void OnAnimNotifyBegin(FName AnimName);
     void OnAnimNotifyEnd(FName AnimName);
+
+    /* Ramer-Douglas-Peucker over the time parameterized socket paths, shared by all sockets.
+     * Returns the indices of the kept frames, replaying them with linear interpolation over time keeps every socket of
+     * every recorded frame within MaxDeviation. The first and last frames are always kept */
+    static TArray<int32> ReduceToKeyframes(const TArray<FWeaponAttackTimestamp>& Sequence, float MaxDeviation);
     
 protected:
     virtual void BeginPlay() override;
@@ -105,7 +110,6 @@ protected:
     void StartRecording();
     void StopRecording();
     bool SaveAttackSequence(const FString& AssetName, UWeaponAttackData* AttackData);
-    TArray<FWeaponAttackTimestamp> ReduceToKeyframesForSocket(const TArray<FWeaponAttackTimestamp>& OriginalSequence, int32 SocketIndex) const;
     void PostProcessRecordedData();
 
     TArray<FName> FindRelevantSockets(class UMeshComponent* WeaponMesh) const;
@@ -29,13 +29,16 @@ struct FWeaponAttackTimestamp
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	TArray<FVector> SocketPositions;
 
-	// During keyframe reduction we may need the original unreduced index
+	// Only used while reducing a recording to keyframes, not saved
 	int OriginalIndex = 0;
 };
 
 
+/* A recorded attack, socket positions are relative to the attack pivot.
+ * AttackSequence is the editable source, it is packed on save into one time array and one SoA buffer of socket positions
+ * quantized to 16 bits within the bounds of the attack. The packed data is decoded once on load into the replay buffer */
 UCLASS(BlueprintType)
-class UWeaponAttackData : public UDataAsset
+class RANCINVENTORYWEAPONS_API UWeaponAttackData : public UDataAsset
 {
 	GENERATED_BODY()
 
@@ -44,13 +47,52 @@ public:
 	// The delay from the triggering of the attack until we start doing the first hit trace
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float FirstTraceDelay = 0.0f;
-	
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+
+#if WITH_EDITORONLY_DATA
+	UPROPERTY(EditAnywhere)
 	TArray<FWeaponAttackTimestamp> AttackSequence;
-};
+#endif
+
+#if WITH_EDITOR
+	// Quantizes AttackSequence into the packed format and rebuilds the replay buffer, call after changing AttackSequence
+	void PackAttackSequence();
+
+	// In memory size of AttackSequence, for comparing against GetPackedSize
+	int64 GetUnpackedSize() const;
+
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 
+	virtual void PostLoad() override;
 
+	int32 GetNumKeyframes() const { return PackedTimes.Num(); }
+	int32 GetNumSockets() const { return NumSockets; }
+	float GetKeyframeTime(int32 Keyframe) const { return PackedTimes[Keyframe]; }
+	TConstArrayView<FVector3f> GetSocketPositions(int32 Keyframe) const { return TConstArrayView<FVector3f>(ReplayPositions.GetData() + Keyframe * NumSockets, NumSockets); }
 
+	// Size of the packed data as it is serialized
+	int64 GetPackedSize() const;
 
+protected:
+	void DecodeReplayBuffer();
 
+	UPROPERTY()
+	TArray<float> PackedTimes;
 
+	// All X components, then all Y, then all Z. Keyframe major within a component
+	UPROPERTY()
+	TArray<uint16> PackedPositions;
+
+	UPROPERTY()
+	FVector3f PackedBoundsMin = FVector3f::ZeroVector;
+
+	UPROPERTY()
+	FVector3f PackedBoundsSize = FVector3f::ZeroVector;
+
+	UPROPERTY()
+	int32 NumSockets = 0;
+
+	// Decoded socket positions, keyframe major so the sockets of a keyframe are contiguous
+	TArray<FVector3f> ReplayPositions;
+};
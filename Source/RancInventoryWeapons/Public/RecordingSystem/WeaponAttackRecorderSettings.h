@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "Engine/SkeletalMesh.h"
 #include "WeaponAttackRecorderSettings.generated.h"
 
 UCLASS(BlueprintType)
@@ -30,11 +31,9 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Recording")
     FName StopRecordingNotify;
     
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Recording", meta = (RelativeToGameContentDir))
-    float MinDistance = 2;
-    
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Recording", meta = (RelativeToGameContentDir))
-    double AngleThreshold = 5;
+    // Keyframe reduction keeps every socket of every recorded frame within this many centimeters of the replayed path
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Recording", meta = (ClampMin = "0"))
+    float MaxDeviation = 1;
     
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Recording")
     bool bRecordKeyframesOnly;
@@ -42,4 +41,24 @@ public:
     // Folder path to save new assets
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Recording", meta = (RelativeToGameContentDir))
     FDirectoryPath AssetSavePath;
+
+    // Character mesh the batch recording commandlet evaluates the attack montages on
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Batch Recording")
+    TSoftObjectPtr<USkeletalMesh> BatchCharacterMesh;
+
+    // Transform of the character mesh relative to the actor, as set on the character
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Batch Recording")
+    FTransform BatchMeshRelativeTransform = FTransform(FRotator(0.0, -90.0, 0.0), FVector(0.0, 0.0, -90.0));
+
+    // Character mesh socket the weapons are attached to
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Batch Recording")
+    FName BatchAttachSocket = FName("MainHandSocket");
+
+    // Same as ReplayAttackPivotLocationOffset of the gear manager that replays the attacks
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Batch Recording")
+    FVector BatchPivotLocationOffset = FVector::ZeroVector;
+
+    // Samples per second of montage playback, before keyframe reduction
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Batch Recording", meta = (ClampMin = "1"))
+    float BatchSampleRate = 120;
 };
\ No newline at end of file